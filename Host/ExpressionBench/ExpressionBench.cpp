@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+// benchmark of the gcode expressions: text parser vs. cached byte code (see CGCodeParser::ParseExpression)
+// usage: ExpressionBench gcodefile [passes]
+//
+// all [expressions] and parameter assignments (#1=...) of the file are evaluated in the order of the file
+// the result of both methods must be the same => exit code 1 if not
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "../../VS/Arduino.VC/MsvcStepper/MsvcStepper.h"
+#include <GCodeParser.h>
+#include <GCodeExpressionParser.h>
+
+CSerial Serial;
+HardwareSerial& StepperSerial = Serial;
+
+CMsvcStepper Stepper;
+
+////////////////////////////////////////////////////////
+
+struct SExpression
+{
+	param_t		paramNo;				// != 0: assignment to the parameter
+	std::string	text;
+};
+
+////////////////////////////////////////////////////////
+
+class CBenchParser : public CGCodeParser
+{
+private:
+
+	typedef CGCodeParser super;
+
+public:
+
+	CBenchParser() : super(&_streamreader, &Serial)	{ }
+
+	expr_t Evaluate(const SExpression& expression, bool cached)
+	{
+		char buffer[256];
+		strcpy(buffer, expression.text.c_str());
+		_streamreader.Init(buffer);
+
+		expr_t answer = 0;
+		bool ok;
+
+		if (cached)
+		{
+			ok = ParseExpression(answer);
+		}
+		else
+		{
+			CGCodeExpressionParser exprpars(this);
+			exprpars.Parse();
+			answer = exprpars.Answer;
+			ok = !exprpars.IsError();
+		}
+
+		if (!ok || IsError())
+		{
+			fprintf(stderr, "error: %s\n", expression.text.c_str());
+			exit(1);
+		}
+
+		if (expression.paramNo != 0)
+			SetParameter(expression.paramNo, answer);
+
+		return answer;
+	}
+
+private:
+
+	static void SetParameter(param_t paramNo, expr_t value)
+	{
+		uint8_t idx = ParamNoToParamIdx(paramNo);
+		if (idx == 255)
+			idx = ParamNoToParamIdx(0);		// free slot
+
+		_modalstate.ParamNoToIdx[idx] = (uint8_t) paramNo;
+		_modalstate.Parameter[idx] = value;
+	}
+
+	CStreamReader _streamreader;
+};
+
+////////////////////////////////////////////////////////
+
+static bool ReadExpressions(const char* filename, std::vector<SExpression>& expressions)
+{
+	FILE* file = fopen(filename, "rt");
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", filename);
+		return false;
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		line[strcspn(line, ";\r\n")] = 0;
+
+		if (line[0] == '#' && strchr(line, '='))
+		{
+			// #1=expression (rest of line)
+			char* value = strchr(line, '=');
+			expressions.push_back({ (param_t) atoi(&line[1]), value + 1 });
+			continue;
+		}
+
+		// [expression] - nested [] are part of the expression
+
+		for (char* start = strchr(line, '['); start != NULL; start = strchr(start, '['))
+		{
+			char* end = start;
+			for (int count = 0; *end; end++)
+			{
+				if (*end == '[') count++;
+				else if (*end == ']' && --count == 0) break;
+			}
+			expressions.push_back({ 0, std::string(start, end + 1) });
+			start = end;
+		}
+	}
+
+	fclose(file);
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+static double Run(CBenchParser& parser, const std::vector<SExpression>& expressions, int passes, bool cached, std::vector<expr_t>& results)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (auto& expression : expressions)
+		{
+			expr_t answer = parser.Evaluate(expression, cached);
+			if (pass == 0)
+				results.push_back(answer);
+		}
+	}
+
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2 && argc != 3)
+	{
+		fprintf(stderr, "usage: ExpressionBench gcodefile [passes]\n");
+		return 1;
+	}
+
+	std::vector<SExpression> expressions;
+	if (!ReadExpressions(argv[1], expressions))
+		return 1;
+
+	int passes = argc == 3 ? atoi(argv[2]) : 1000;
+
+	Stepper.Init();
+
+	CMotionControlBase motioncontrol;
+	motioncontrol.InitConversion(
+		[](axis_t, sdist_t val) { return (mm1000_t) val; },
+		[](axis_t, mm1000_t val) { return (sdist_t) val; }
+	);
+
+	CGCodeParser::Init();
+
+	CBenchParser parser;
+	std::vector<expr_t> textresults;
+	std::vector<expr_t> cachedresults;
+
+	double texttime = Run(parser, expressions, passes, false, textresults);
+	double cachedtime = Run(parser, expressions, passes, true, cachedresults);
+
+	unsigned long count = (unsigned long) expressions.size() * passes;
+
+	printf("expressions: %lu (%d passes of %lu)\n", count, passes, (unsigned long) expressions.size());
+	printf("text parser: %8.3f us/expression\n", texttime / count);
+	printf("byte code:   %8.3f us/expression (x%.2f)\n", cachedtime / count, texttime / cachedtime);
+
+	for (size_t idx = 0; idx < expressions.size(); idx++)
+	{
+		if (textresults[idx] != cachedresults[idx])
+		{
+			fprintf(stderr, "different result: %s => %f / %f\n", expressions[idx].text.c_str(), textresults[idx], cachedresults[idx]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+; hole circle: 12 holes on a circle, the loop is unrolled (the same lines for each hole)
+; #1 hole index, #2 number of holes, #3 radius, #4 depth, #5 angle
+g21
+g90
+#1=0
+#2=12
+#3=25
+#4=5
+g0 z[#4/2]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+#5=[360/#2*#1]
+g0 x[#3*cos[#5*PI/180]] y[#3*sin[#5*PI/180]]
+g1 z[-#4] f[200+#1*10]
+g0 z[#<_z>+#4*1.5]
+#1=[#1+1]
+g0 z[#4*2]
+g0 x0 y0
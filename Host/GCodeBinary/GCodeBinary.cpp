@@ -0,0 +1,412 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+// host side encoder for the binary G0/G1 frames (M130, see BinaryGCode.h)
+// usage: GCodeBinary encode gcodefile binfile	=> gcode with runs of G0/G1 as binary frames (e.g. input of MiniCNC)
+//        GCodeBinary bench [gcodefile]			=> bytes per move and moves/sec limited by the serial link, text vs. binary
+//
+// a G0/G1 is sent binary if the position of all specified axis is known (G90) or relative (G91) and the unit is mm
+// a line with other commands is sent as text, axis of unknown commands (e.g. G28) are "not known" until the next absolute move
+
+#include <math.h>
+#include <ctype.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <Arduino.h>
+#include <BinaryGCode.h>
+
+CSerial Serial;
+
+////////////////////////////////////////////////////////
+
+static const char AxisName[] = "XYZABC";			// CBinaryGCode::MaxAxis
+
+class CBinaryEncoder
+{
+public:
+
+	void Encode(const char* line)
+	{
+		CBinaryGCode::SMove move;
+
+		if (ToBinary(line, move))
+		{
+			if (!_binarymode)
+			{
+				AddText("M130\n");
+				_binarymode = true;
+			}
+
+			uint8_t frame[CBinaryGCode::MaxFrameSize];
+			uint8_t size = CBinaryGCode::Encode(move, frame);
+			_out.append((const char*) frame, size);
+			_frames.append((const char*) frame, size);
+			_framecount++;
+		}
+		else
+		{
+			EndBinary();
+			AddText(line);
+			AddText("\n");
+		}
+	}
+
+	void EndBinary()
+	{
+		if (_binarymode)
+		{
+			uint8_t frame[CBinaryGCode::MaxFrameSize];
+			CBinaryGCode::SMove move = { CBinaryGCode::EndBinary };
+			_out.append((const char*) frame, CBinaryGCode::Encode(move, frame));
+			_binarymode = false;
+		}
+	}
+
+	const std::string& GetOutput()		{ return _out; }
+	const std::string& GetFrames()		{ return _frames; }			// move frames only (without text and EndBinary)
+	unsigned long GetFrameCount()		{ return _framecount; }
+	unsigned long GetTextLines()		{ return _textlines; }
+
+private:
+
+	void AddText(const char* text)
+	{
+		_out += text;
+		if (strchr(text, '\n'))
+			_textlines++;
+	}
+
+	static long ToMm1000(const char*& text)
+	{
+		// same as CParser::GetInt32Scale with scale 3 => round with the 4th digit
+
+		bool negativ = *text == '-';
+		if (negativ || *text == '+') text++;
+
+		long value = 0;
+		for (; isdigit(*text); text++)
+			value = value * 10 + (*text - '0');
+
+		uint8_t scale = 0;
+		if (*text == '.')
+		{
+			for (text++; isdigit(*text); text++, scale++)
+			{
+				if (scale < 3)
+					value = value * 10 + (*text - '0');
+				else if (scale == 3 && *text >= '5')
+					value++;
+			}
+		}
+
+		for (; scale < 3; scale++)
+			value *= 10;
+
+		return negativ ? -value : value;
+	}
+
+	bool ToBinary(const char* line, CBinaryGCode::SMove& move)
+	{
+		// parse one line, update the state and return true if the line is a G0/G1 which can be sent binary
+
+		bool	other = false;
+		bool	isG92 = false;
+		long	value[CBinaryGCode::MaxAxis];
+		uint8_t axes = 0;
+
+		memset(&move, 0, sizeof(move));
+
+		for (const char* text = line; *text;)
+		{
+			char ch = char(toupper(*(text++)));
+
+			if (ch == ' ' || ch == '\t' || ch == '\r')
+				continue;
+			if (ch == ';')
+				break;
+			if (ch == '(')
+			{
+				text = strchr(text, ')');
+				if (text == NULL) break;
+				text++;
+				continue;
+			}
+
+			const char* axis = strchr(AxisName, ch);
+
+			if (axis != NULL && *axis)
+			{
+				uint8_t idx = uint8_t(axis - AxisName);
+				value[idx] = ToMm1000(text);
+				axes |= 1 << idx;
+			}
+			else if (ch == 'F')
+			{
+				move.feedrate = ToMm1000(text);
+				move.header |= CBinaryGCode::FeedRate;
+			}
+			else if (ch == 'G')
+			{
+				long gcode = ToMm1000(text);
+				switch (gcode)
+				{
+					case 0:		_modalmotion = 0; break;
+					case 1000:	_modalmotion = 1; break;
+					case 2000:
+					case 3000:	_modalmotion = 2; other = true; break;
+					case 20000:	_isMm = false; other = true; break;
+					case 21000:	_isMm = true; other = true; break;
+					case 90000:	_isAbsolut = true; other = true; break;
+					case 91000:	_isAbsolut = false; other = true; break;
+					case 92000:	isG92 = true; other = true; break;
+					default:	other = true; break;
+				}
+			}
+			else if (ch == 'N')
+			{
+				ToMm1000(text);
+			}
+			else
+			{
+				other = true;
+				while (*text && !isalpha(*text) && *text != ';' && *text != '(') text++;
+			}
+		}
+
+		bool isG0 = _modalmotion == 0;
+		bool binary = !other && _isMm && (isG0 || _modalmotion == 1) && axes != 0 && !(isG0 && (move.header & CBinaryGCode::FeedRate));
+
+		for (uint8_t idx = 0; idx < CBinaryGCode::MaxAxis; idx++)
+		{
+			if ((axes & (1 << idx)) == 0)
+				continue;
+
+			if (_isAbsolut && !isG92 && (_known & (1 << idx)) == 0)
+				binary = false;
+
+			move.distance[idx] = _isAbsolut || isG92 ? value[idx] - _position[idx] : value[idx];
+		}
+
+		// update the host position
+
+		if (!_isMm || (other && !isG92 && _modalmotion != 2))
+		{
+			_known &= ~axes;			// e.g. G28 X0
+		}
+		else
+		{
+			for (uint8_t idx = 0; idx < CBinaryGCode::MaxAxis; idx++)
+			{
+				if ((axes & (1 << idx)) == 0)
+					continue;
+
+				if (_isAbsolut || isG92)
+				{
+					_position[idx] = value[idx];
+					_known |= 1 << idx;
+				}
+				else
+				{
+					_position[idx] += value[idx];
+				}
+			}
+		}
+
+		if (!binary)
+			return false;
+
+		move.header |= axes;
+		if (!isG0)
+			move.header |= CBinaryGCode::CutMove;
+
+		return true;
+	}
+
+	std::string		_out;
+	std::string		_frames;
+	unsigned long	_framecount = 0;
+	unsigned long	_textlines = 0;
+	bool			_binarymode = false;
+
+	bool			_isMm = true;
+	bool			_isAbsolut = true;
+	int				_modalmotion = -1;					// 0: G0, 1: G1, 2: arc, -1 not set
+	uint8_t			_known = 0;							// bit for each axis: _position is known
+	long			_position[CBinaryGCode::MaxAxis] = { 0 };
+};
+
+////////////////////////////////////////////////////////
+
+static bool ReadLines(const char* filename, std::vector<std::string>& lines)
+{
+	FILE* file = fopen(filename, "rt");
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", filename);
+		return false;
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		line[strcspn(line, "\r\n")] = 0;
+		lines.push_back(line);
+	}
+
+	fclose(file);
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+static void CreateBenchLines(std::vector<std::string>& lines)
+{
+	// circle with r=50mm and 0.1mm segments (typical for CAM output of a contour)
+
+	lines.push_back("g21");
+	lines.push_back("g90");
+	lines.push_back("g0 x50 y0");
+
+	const int segments = 3142;
+	char line[64];
+
+	for (int i = 1; i <= segments; i++)
+	{
+		double angle = 2.0 * M_PI * i / segments;
+		sprintf(line, "g1 x%.3f y%.3f%s", 50.0 * cos(angle), 50.0 * sin(angle), i == 1 ? " f2000" : "");
+		lines.push_back(line);
+	}
+}
+
+////////////////////////////////////////////////////////
+
+static int Encode(const char* gcodefile, const char* binfile)
+{
+	std::vector<std::string> lines;
+	if (!ReadLines(gcodefile, lines))
+		return 1;
+
+	CBinaryEncoder encoder;
+	for (auto& line : lines)
+		encoder.Encode(line.c_str());
+	encoder.EndBinary();
+
+	FILE* file = fopen(binfile, "wb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot create %s\n", binfile);
+		return 1;
+	}
+
+	fwrite(encoder.GetOutput().data(), 1, encoder.GetOutput().size(), file);
+	fclose(file);
+
+	fprintf(stderr, "%lu frames, %lu text lines, %lu bytes\n", encoder.GetFrameCount(), encoder.GetTextLines(), (unsigned long) encoder.GetOutput().size());
+	return 0;
+}
+
+////////////////////////////////////////////////////////
+
+static int Bench(const char* gcodefile)
+{
+	std::vector<std::string> lines;
+
+	if (gcodefile != NULL)
+	{
+		if (!ReadLines(gcodefile, lines))
+			return 1;
+	}
+	else
+	{
+		CreateBenchLines(lines);
+	}
+
+	// text: each line is answered with "ok\r\n"
+
+	unsigned long textbytes = 0;
+	for (auto& line : lines)
+		textbytes += (unsigned long) line.size() + 1;
+
+	unsigned long textreply = 4 * (unsigned long) lines.size();
+
+	CBinaryEncoder encoder;
+	for (auto& line : lines)
+		encoder.Encode(line.c_str());
+	encoder.EndBinary();
+
+	unsigned long binbytes = (unsigned long) encoder.GetOutput().size();
+	unsigned long binreply = encoder.GetFrameCount() + 4 * encoder.GetTextLines();
+
+	// decode time of the frames (host cpu, the AVR is about 100 times slower)
+
+	auto start = std::chrono::steady_clock::now();
+
+	const uint8_t* frames = (const uint8_t*) encoder.GetFrames().data();
+	size_t framesbytes = encoder.GetFrames().size();
+	unsigned long decoded = 0;
+
+	for (size_t idx = 0; idx < framesbytes;)
+	{
+		CBinaryGCode::SMove move;
+		uint8_t size = CBinaryGCode::FrameSize(&frames[idx], uint8_t(framesbytes - idx > 255 ? 255 : framesbytes - idx));
+		if (size == 0 || !CBinaryGCode::Decode(&frames[idx], size, move))
+			break;
+		decoded++;
+		idx += size;
+	}
+
+	double decodetime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned long moves = (unsigned long) lines.size();
+
+	printf("lines: %lu, binary frames: %lu (decoded %lu, %.3f us/frame), text lines: %lu\n", moves, encoder.GetFrameCount(), decoded, decoded ? decodetime / decoded : 0.0, encoder.GetTextLines());
+	printf("text:   %6.2f bytes/line  (reply %5.2f)\n", double(textbytes) / moves, double(textreply) / moves);
+	printf("binary: %6.2f bytes/line  (reply %5.2f)\n", double(binbytes) / moves, double(binreply) / moves);
+
+	const unsigned long bauds[] = { 115200, 250000 };
+
+	for (unsigned long baud : bauds)
+	{
+		// 10 bits per byte (start + 8 + stop), full duplex => the direction with more bytes limits
+
+		double bytespersec = baud / 10.0;
+		double textrate = bytespersec * moves / max(textbytes, textreply);
+		double binrate = bytespersec * moves / max(binbytes, binreply);
+
+		printf("%6lu baud: text %7.0f lines/sec, binary %7.0f lines/sec (x%.2f)\n", baud, textrate, binrate, binrate / textrate);
+	}
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	if (argc == 4 && strcmp(argv[1], "encode") == 0)
+		return Encode(argv[2], argv[3]);
+
+	if ((argc == 2 || argc == 3) && strcmp(argv[1], "bench") == 0)
+		return Bench(argc == 3 ? argv[2] : NULL);
+
+	fprintf(stderr, "usage: GCodeBinary encode gcodefile binfile\n       GCodeBinary bench [gcodefile]\n");
+	return 1;
+}
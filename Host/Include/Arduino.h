@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////
+// Arduino API for the host (Linux/posix) build
+// same as VS/Arduino.VC/Include/arduino.h without windows.h, conio.h and the msvc "secure" crt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <assert.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+#include <functional>
+#include <chrono>
+
+#define STEPPER_SIMULATION		// libraries: simulation target (HAL_Msvc.h, CMsvcStepper)
+
+////////////////////////////////////////////////////////
+// posix names used by the libraries with a different meaning
+
+#define timer_t cnc_timer_t
+#define error_t cnc_error_t
+
+////////////////////////////////////////////////////////
+// msvc crt
+
+#define _MAX_PATH 260
+
+typedef long long __int64;
+
+inline void strcpy_s(char* dest, size_t, const char* src)					{ strcpy(dest, src); }
+template<size_t size> inline void strcpy_s(char(&dest)[size], const char* src)	{ size_t len = strlen(src); if (len > size - 1) len = size - 1; memcpy(dest, src, len); dest[len] = 0; }
+inline void strcat_s(char* dest, size_t, const char* src)					{ strcat(dest, src); }
+template<size_t size> inline void strcat_s(char(&dest)[size], const char* src)	{ strncat(dest, src, size - strlen(dest) - 1); }
+
+#define sprintf_s(buffer, ...)	sprintf(buffer, __VA_ARGS__)
+#define _stricmp(a,b)			strcasecmp(a,b)
+#define _countof(a)				(sizeof(a)/sizeof((a)[0]))
+
+inline int fopen_s(FILE** f, const char* filename, const char* mode)		{ *f = fopen(filename, mode); return *f ? 0 : errno; }
+
+inline char* _itoa(int value, char* buffer, int radix)						{ sprintf(buffer, radix == 16 ? "%x" : "%i", value); return buffer; }
+inline char* _ltoa(long value, char* buffer, int radix)						{ sprintf(buffer, radix == 16 ? "%lx" : "%li", value); return buffer; }
+
+inline unsigned long GetTempPathA(unsigned long, char* buffer)
+{
+	const char* tmp = getenv("TMPDIR");
+	strcpy(buffer, tmp ? tmp : "/tmp");
+	strcat(buffer, "/");
+	return (unsigned long) strlen(buffer);
+}
+
+inline void Trace(const char*, ...)											{}
+
+////////////////////////////////////////////////////////
+
+#define OUTPUT 1
+#define INPUT_PULLUP 1
+#define INPUT 2
+#define CS12 1
+#define CS11 1
+#define TOIE1 1
+#define LOW 0
+#define HIGH 1
+
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define OCF0B   2
+#define OCF0A   1
+#define TOV0    0
+
+#define TOIE1 1
+#define TOV1 0
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define INTERNAL 3
+#define DEFAULT 1
+#define EXTERNAL 0
+
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+
+#define NOT_AN_INTERRUPT -1
+
+#define ISR(a) void a(void)
+
+#define max(a,b) ((a)>=(b)?(a):(b))
+#define min(a,b) ((a)<=(b)?(a):(b))
+
+#define strcpy_P(a,b) strcpy(a,b)
+#define strcat_P(a,b) strcat(a,b)
+#define strcmp_P(a,b) strcmp(a,b)
+#define strcasecmp_P(a,b) strcasecmp(a,b)
+#define PSTR(a) a
+
+#define memcpy_P(a,b,c) memcpy(a,b,c)
+
+#define eeprom_read_block(a,b,c) memcpy(a,b,c)
+#define eeprom_write_block(a,b,c) memcpy(b,a,c)
+
+inline void eeprom_write_dword(uint32_t *  __p, uint32_t  	__value) { *__p = __value;  }
+inline uint32_t eeprom_read_dword(const uint32_t * __p) { return *__p;  }
+inline uint8_t eeprom_read_byte(const uint8_t * __p) { return *__p; }
+
+#define __FlashStringHelper char
+#define F(a) a
+#define PROGMEM
+typedef  const char* PGM_P;
+
+inline void attachInterrupt(uint8_t, void(*)(), int /* mode */) {};
+inline void detachInterrupt(uint8_t) {};
+
+inline uint8_t digitalPinToInterrupt(uint8_t p) { return ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT)); }
+
+inline void analogWrite(short, int)	{};
+inline int analogRead(short) { return 0; };
+inline void digitalWrite(short, short)	{};
+extern uint8_t digitalRead(short pin);
+inline void pinMode(short, short)		{};
+
+#define DIGITALREADNOVALUE 255
+extern std::function<uint8_t(short)> digitalReadEvent;
+extern uint8_t digitalReadFromFile(short pin);
+
+#define LED_BUILTIN (13)
+
+#define PIN_A0   (14)
+#define PIN_A1   (15)
+#define PIN_A2   (16)
+#define PIN_A3   (17)
+#define PIN_A4   (18)
+#define PIN_A5   (19)
+#define PIN_A6   (20)
+#define PIN_A7   (21)
+
+static uint8_t A0 = PIN_A0;
+
+static uint8_t SREG;
+
+inline unsigned long   pgm_read_dword(const void* p) { return *(unsigned long*)p; }
+inline unsigned short  pgm_read_word(const void* p) { return *(unsigned short*)p; }
+inline  uint8_t  pgm_read_byte(const void* p) { return *(uint8_t*)p; }
+inline  const void* pgm_read_ptr(const void* p)  { return *((void **) p); }
+
+inline unsigned long millis() { return (unsigned long) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+inline void delay(unsigned long ms) { usleep(ms * 1000); }
+
+////////////////////////////////////////////////////////
+
+#define STDIO 0
+#define HEX 16
+class Stream
+{
+public:
+	Stream()
+	{
+		_istty = isatty(STDIO) != 0;
+	}
+
+	void SetIdle(void(*pIdle)())	{ _pIdle = pIdle;  }
+
+	void print(char c)				{ printf("%c", c); };
+	void print(unsigned int ui)		{ printf("%u", ui); };
+	void print(int i)				{ printf("%i", i); };
+	void print(long l)				{ printf("%li", l); };
+	void print(unsigned long ul)	{ printf("%lu", ul); };
+	void print(unsigned long ul, uint8_t base)
+	{
+		if (base == 10) printf("%lu", ul);
+		if (base == 16) printf("%lx", ul);
+	}
+	void print(const char*s)		{ printf("%s", s); };
+	void print(float f)				{ printf("%f", f); };
+
+	void println()					{ printf("\n"); };
+	void println(unsigned int ui)	{ printf("%u\n", ui); };
+	void println(char c)			{ printf("%c\n", c); };
+	void println(int i)				{ printf("%i\n", i); };
+	void println(long l)			{ printf("%li\n", l); };
+	void println(unsigned long ul)	{ printf("%lu\n", ul); };
+	void println(unsigned long ul, uint8_t base) { print(ul, base); println(); };
+	void println(const char*s)		{ printf("%s\n", s); };
+	void println(float f)			{ printf("%f\n", f); };
+
+	void begin(int )				{ };
+	virtual int available()	 		{
+										if (_last || _next != EOF)
+											return 1;
+
+										if (!IsEOF() && (!_istty || CanRead()))
+										{
+											_next = getchar();
+											if (_next != EOF)
+												return 1;
+										}
+
+										if (_pIdle) _pIdle();
+										return 0;
+									}
+	virtual char read()				{
+										char ch = _last;
+										if (ch)
+										{
+											_last = 0;
+										}
+										else
+										{
+											if (_next == EOF)
+												available();
+
+											ch = (char) _next;
+											_next = EOF;
+											if (_istty && ch == '\r')
+												_last = '\n';
+										}
+
+										if (!_istty)
+											putchar(ch);
+										return ch;
+									}
+
+	bool IsEOF()					{ return feof(stdin) != 0; }
+
+private:
+
+	bool CanRead()
+	{
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(STDIO, &fds);
+		timeval timeout = { 0, 0 };
+		return select(STDIO + 1, &fds, NULL, NULL, &timeout) > 0;
+	}
+
+	void(*_pIdle)() = NULL;
+	char _last=0;
+	int  _next=EOF;
+	bool _istty;
+};
+
+class HardwareSerial : public Stream
+{
+};
+
+class CSerial : public HardwareSerial
+{
+};
+
+extern CSerial Serial;
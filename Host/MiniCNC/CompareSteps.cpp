@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+// compare two step csv files of MiniCNC (CMsvcStepper::WriteTestResults)
+// usage: CompareSteps reference.csv test.csv maxppm
+//
+// the steps (columns MoveAxis and total of each axis) must be the same
+// the timer of the events may differ, the sum of all timers (time of the program) by max maxppm
+// => exit code 1 if not
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////
+
+enum
+{
+	TimerColumn = 1,
+	FirstAxisColumn = 9,		// MoveAxis[5], total[5]
+	LastAxisColumn = 18
+};
+
+static bool SplitLine(char* line, char* columns[LastAxisColumn + 1])
+{
+	for (int i = 0; i <= LastAxisColumn; i++)
+	{
+		columns[i] = line;
+		line = strchr(line, ';');
+		if (line == NULL)
+			return false;
+		*(line++) = 0;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	if (argc != 4)
+	{
+		fprintf(stderr, "usage: CompareSteps reference.csv test.csv maxppm\n");
+		return 1;
+	}
+
+	FILE* reference = fopen(argv[1], "rt");
+	FILE* test = fopen(argv[2], "rt");
+	if (reference == NULL || test == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", reference == NULL ? argv[1] : argv[2]);
+		return 1;
+	}
+
+	double maxppm = atof(argv[3]);
+
+	char referenceline[512];
+	char testline[512];
+	char* referencecolumns[LastAxisColumn + 1];
+	char* testcolumns[LastAxisColumn + 1];
+
+	unsigned long events = 0;
+	unsigned long long referencetime = 0;
+	unsigned long long testtime = 0;
+	long maxdiff = 0;
+
+	while (true)
+	{
+		bool isreference = fgets(referenceline, sizeof(referenceline), reference) != NULL;
+		bool istest = fgets(testline, sizeof(testline), test) != NULL;
+
+		if (!isreference || !istest)
+		{
+			if (isreference != istest)
+			{
+				fprintf(stderr, "different number of events: %lu\n", events);
+				return 1;
+			}
+			break;
+		}
+
+		if (!SplitLine(referenceline, referencecolumns) || !SplitLine(testline, testcolumns))
+		{
+			fprintf(stderr, "invalid line: %lu\n", events);
+			return 1;
+		}
+
+		for (int i = FirstAxisColumn; i <= LastAxisColumn; i++)
+		{
+			if (strcmp(referencecolumns[i], testcolumns[i]) != 0)
+			{
+				fprintf(stderr, "different steps: event %lu, column %i: %s / %s\n", events, i, referencecolumns[i], testcolumns[i]);
+				return 1;
+			}
+		}
+
+		long referencetimer = atol(referencecolumns[TimerColumn]);
+		long testtimer = atol(testcolumns[TimerColumn]);
+
+		referencetime += referencetimer;
+		testtime += testtimer;
+		maxdiff = labs(referencetimer - testtimer) > maxdiff ? labs(referencetimer - testtimer) : maxdiff;
+		events++;
+	}
+
+	double ppm = referencetime ? ((double)testtime - (double)referencetime) * 1e6 / (double)referencetime : 0.0;
+
+	printf("events: %lu, time: %llu / %llu (%.1f ppm), max timer diff of an event: %li\n", events, referencetime, testtime, ppm, maxdiff);
+
+	if (ppm > maxppm || ppm < -maxppm)
+	{
+		fprintf(stderr, "different time: %.1f ppm\n", ppm);
+		return 1;
+	}
+
+	return 0;
+}
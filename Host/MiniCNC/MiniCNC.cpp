@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+// step-timing simulator: MiniCNC with CMsvcStepper (virtual timer)
+// usage: MiniCNC [gcodefile [csvfile]]
+// reads gcode from the file (or stdin) and writes every StepOut with its timer value to csvfile (SpeedChart format)
+
+#include <math.h>
+
+#include "../../VS/Arduino.VC/MsvcStepper/MsvcStepper.h"
+#include "../../Sketch/MiniCNC/MiniCNC/MyControl.h"
+
+CSerial Serial;
+
+static void setup(const char* csvfile);
+static void loop();
+static void Idle();
+
+CMsvcStepper MyStepper;
+class CStepper& Stepper = MyStepper;
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && freopen(argv[1], "rt", stdin) == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	digitalReadEvent = [](short pin)
+	{
+		switch (pin)
+		{
+#ifdef KILL_PIN
+			case KILL_PIN: return (uint8_t) HIGH;
+#endif
+		}
+		return (uint8_t) DIGITALREADNOVALUE;
+	};
+
+	setup(argc > 2 ? argv[2] : "MiniCNC.csv");
+
+	while (!CGCodeParserBase::_exit)
+	{
+		loop();
+	}
+
+	MyStepper.EndTest();
+
+	fprintf(stderr, "steps written, total time: %lli\n", MyStepper.GetTotalTime());
+	return 0;
+}
+
+void setup(const char* csvfile)
+{
+	MyStepper.DelayOptimization = false;
+	MyStepper.UseSpeedSign = true;
+	MyStepper.CacheSize = 50000;
+	MyStepper.InitTest(csvfile);
+	Serial.SetIdle(Idle);
+}
+
+void loop()
+{
+	Control.Run();
+}
+
+static void Idle()
+{
+	MyStepper.HandleIdle();
+
+	if (Serial.IsEOF())
+	{
+		// end of gcode file => finish queued movements and exit
+		CGCodeParserBase::_exit = true;
+	}
+}
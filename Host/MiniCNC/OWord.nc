@@ -0,0 +1,16 @@
+; drill pattern with O-word sub, while and repeat (same steps as OWordUnrolled.nc)
+g21
+g90
+o100 sub
+  g0 x[#1] y[#2]		(hole at #1 #2)
+  o101 repeat [2]
+    g1 z4.5 f300
+    g0 z5
+  o101 endrepeat
+o100 endsub
+#3=0
+o102 while [#3 < 3]
+  o100 call [#3*2+1] [1]
+  #3=[#3+1]
+o102 endwhile
+g0 x0 y0
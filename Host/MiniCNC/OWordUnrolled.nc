@@ -0,0 +1,19 @@
+; drill pattern of OWord.nc without O-words
+g21
+g90
+g0 x1 y1
+g1 z4.5 f300
+g0 z5
+g1 z4.5 f300
+g0 z5
+g0 x3 y1
+g1 z4.5 f300
+g0 z5
+g1 z4.5 f300
+g0 z5
+g0 x5 y1
+g1 z4.5 f300
+g0 z5
+g1 z4.5 f300
+g0 z5
+g0 x0 y0
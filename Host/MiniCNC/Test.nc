@@ -0,0 +1,8 @@
+g21
+g90
+g0 x10 y5
+g1 x20 y15 f500
+g1 x20 y0
+g2 x10 y0 i-5 j0
+g0 z5
+g0 x0 y0 z0
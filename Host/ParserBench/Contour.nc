@@ -0,0 +1,60 @@
+; contour as written by a CAM postprocessor: G1 segments with 3 decimals, line numbers and comments
+g21
+g90
+g64
+(pocket 1)
+g0 z2.000
+g0 x25.000 y0.000
+g1 z-1.500 f200
+N10 G1 X26.539 Y3.494 F600
+N20 G1 X26.563 Y7.118
+N30 G1 X24.730 Y10.244
+N40 G1 X21.651 Y12.500
+N50 G1 X18.431 Y14.143
+N60 G1 X15.910 Y15.910
+N70 G1 X14.143 Y18.431
+N80 G1 X12.500 Y21.651
+N90 G1 X10.244 Y24.730
+N100 G1 X7.118 Y26.563
+N110 G1 X3.494 Y26.539
+N120 G1 X0.000 Y25.000 Z-1.750
+N130 G1 X-3.032 Y23.033
+N140 G1 X-5.823 Y21.733
+N150 G1 X-8.891 Y21.464
+N160 G1 X-12.500 Y21.651
+N170 G1 X-16.295 Y21.236
+N180 G1 X-19.445 Y19.445
+N190 G1 X-21.236 Y16.295
+N200 G1 X-21.651 Y12.500
+N210 G1 X-21.464 Y8.891
+N220 G1 X-21.733 Y5.823
+N230 G1 X-23.033 Y3.032
+N240 G1 X-25.000 Y0.000 Z-2.000
+N250 G1 X-26.539 Y-3.494
+N260 G1 X-26.563 Y-7.118
+N270 G1 X-24.730 Y-10.244
+N280 G1 X-21.651 Y-12.500
+N290 G1 X-18.431 Y-14.143
+N300 G1 X-15.910 Y-15.910
+N310 G1 X-14.143 Y-18.431
+N320 G1 X-12.500 Y-21.651
+N330 G1 X-10.244 Y-24.730
+N340 G1 X-7.118 Y-26.563
+N350 G1 X-3.494 Y-26.539
+N360 G1 X-0.000 Y-25.000 Z-2.250
+N370 G1 X3.032 Y-23.033
+N380 G1 X5.823 Y-21.733
+N390 G1 X8.891 Y-21.464
+N400 G1 X12.500 Y-21.651
+N410 G1 X16.295 Y-21.236
+N420 G1 X19.445 Y-19.445
+N430 G1 X21.236 Y-16.295
+N440 G1 X21.651 Y-12.500
+N450 G1 X21.464 Y-8.891
+N460 G1 X21.733 Y-5.823
+N470 G1 X23.033 Y-3.032
+N480 G1 X25.000 Y-0.000 Z-2.500
+(retract)
+g0 z2.000
+g0 x0 y0
+g0 z0
@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+// benchmark of the gcode line parser: CGCodeParser (scans the line once with CStreamReader)
+// against a one-pass lexer into an array of words (letter, fixed-point value or expression reference)
+// usage: ParserBench gcodefile [passes]
+//
+// the movements are not executed (CBenchMotionControl only records the position)
+// the lexer is the first half of a word-array parser: if it is not faster than the whole text parser,
+// dispatching from the array can not cut the parse time
+// the X/Y/Z values of the lexer must be the same as the position of the text parser => exit code 1 if not
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "../../VS/Arduino.VC/MsvcStepper/MsvcStepper.h"
+#include <Control.h>
+#include <GCodeParser.h>
+
+CSerial Serial;
+HardwareSerial& StepperSerial = Serial;
+
+CMsvcStepper Stepper;
+
+////////////////////////////////////////////////////////
+
+class CBenchControl : public CControl
+{
+protected:
+
+	virtual bool IsKill() override								{ return false; }
+};
+
+CBenchControl Control;
+
+////////////////////////////////////////////////////////
+
+class CBenchMotionControl : public CMotionControlBase
+{
+public:
+
+	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t) override
+	{
+		memcpy(_position, to, sizeof(_position));
+	}
+
+	mm1000_t _position[NUM_AXIS] = { 0 };
+};
+
+////////////////////////////////////////////////////////
+
+class CBenchParser : public CGCodeParser
+{
+private:
+
+	typedef CGCodeParser super;
+
+public:
+
+	CBenchParser() : super(&_streamreader, &Serial)	{ }
+
+	axis_t GetAxis(char letter)						{ return CharToAxis(letter); }
+
+	void ParseLine(char* line)
+	{
+		_streamreader.Init(line);
+		ParseCommand();
+
+		if (IsError())
+		{
+			fprintf(stderr, "error: %s\n", line);
+			exit(1);
+		}
+	}
+
+private:
+
+	CStreamReader _streamreader;
+};
+
+////////////////////////////////////////////////////////
+// one-pass lexer: a line => array of words
+
+struct SWord
+{
+	char	letter;				// uppercase
+	uint8_t	start;				// offset of the value (number or expression) in the line
+	uint8_t	end;				// offset after the value
+	bool	isExpression;		// [...] or #..., value is not set
+	long	value;				// number scaled by 1000 (same as CParser::GetInt32Scale(..,3,..))
+};
+
+class CBenchLexer
+{
+public:
+
+	enum { MaxWords = 16 };
+
+	SWord	_words[MaxWords];
+	uint8_t	_count;
+
+	bool Lex(const char* line)
+	{
+		_count = 0;
+		const char* ch = line;
+
+		while (true)
+		{
+			while (CStreamReader::IsSpace(*ch)) ch++;
+
+			if (*ch == '(')
+			{
+				while (*ch && *ch != ')') ch++;
+				if (*ch) ch++;
+				continue;
+			}
+
+			if (CStreamReader::IsEOC(*ch))
+				return true;
+
+			if (!CStreamReader::IsAlpha(*ch) || _count >= MaxWords)
+				return false;
+
+			SWord& word = _words[_count++];
+			word.letter = CStreamReader::Toupper(*ch++);
+			while (CStreamReader::IsSpace(*ch)) ch++;
+			word.start = uint8_t(ch - line);
+			word.isExpression = *ch == '[' || *ch == '#';
+			word.value = 0;
+
+			if (word.isExpression)
+			{
+				for (uint8_t nested = 0; *ch && (nested != 0 || ch == line + word.start || (*ch != ' ' && *ch != '\t')); ch++)
+				{
+					if (*ch == '[') nested++;
+					else if (*ch == ']' && --nested == 0) { ch++; break; }
+				}
+			}
+			else
+			{
+				bool negativ = CStreamReader::IsMinus(*ch);
+				if (negativ) ch++;
+
+				while (CStreamReader::IsDigit(*ch))
+					word.value = word.value * 10 + (*ch++ - '0');
+
+				uint8_t scale = 0;
+				if (CStreamReader::IsDot(*ch))
+				{
+					for (ch++; CStreamReader::IsDigit(*ch); ch++, scale++)
+					{
+						if (scale < 3) word.value = word.value * 10 + (*ch - '0');
+						else if (scale == 3 && *ch >= '5') word.value++;
+					}
+				}
+
+				for (; scale < 3; scale++)
+					word.value *= 10;
+
+				if (negativ) word.value = -word.value;
+			}
+
+			word.end = uint8_t(ch - line);
+		}
+	}
+};
+
+////////////////////////////////////////////////////////
+
+static bool ReadLines(const char* filename, std::vector<std::string>& lines)
+{
+	FILE* file = fopen(filename, "rt");
+	if (file == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", filename);
+		return false;
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		line[strcspn(line, "\r\n")] = 0;
+		lines.push_back(line);
+	}
+
+	fclose(file);
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
+static double Elapsed(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2 && argc != 3)
+	{
+		fprintf(stderr, "usage: ParserBench gcodefile [passes]\n");
+		return 1;
+	}
+
+	std::vector<std::string> lines;
+	if (!ReadLines(argv[1], lines))
+		return 1;
+
+	int passes = argc == 3 ? atoi(argv[2]) : 1000;
+
+	Stepper.Init();
+
+	CBenchMotionControl motioncontrol;
+	motioncontrol.InitConversion(
+		[](axis_t, sdist_t val) { return (mm1000_t) val; },
+		[](axis_t, mm1000_t val) { return (sdist_t) val; }
+	);
+
+	CGCodeParser::Init();
+
+	CBenchParser parser;
+	CBenchLexer lexer;
+	char buffer[256];
+
+	// the lexer must see the same values as the text parser
+
+	for (auto& line : lines)
+	{
+		strcpy(buffer, line.c_str());
+		parser.ParseLine(buffer);
+
+		if (!lexer.Lex(line.c_str()))
+		{
+			fprintf(stderr, "lexer error: %s\n", line.c_str());
+			return 1;
+		}
+
+		for (uint8_t idx = 0; idx < lexer._count; idx++)
+		{
+			const SWord& word = lexer._words[idx];
+			axis_t axis = parser.GetAxis(word.letter);
+			if (axis < NUM_AXIS && !word.isExpression && word.value != motioncontrol._position[axis])
+			{
+				fprintf(stderr, "different value: %s => %c%ld / %ld\n", line.c_str(), word.letter, word.value, (long) motioncontrol._position[axis]);
+				return 1;
+			}
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (auto& line : lines)
+		{
+			strcpy(buffer, line.c_str());
+			parser.ParseLine(buffer);
+		}
+	}
+	double parsetime = Elapsed(start);
+
+	unsigned long words = 0;
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (auto& line : lines)
+		{
+			strcpy(buffer, line.c_str());
+			lexer.Lex(buffer);
+			words += lexer._count;
+		}
+	}
+	double lextime = Elapsed(start);
+
+	unsigned long count = (unsigned long) lines.size() * passes;
+
+	printf("lines: %lu (%d passes of %lu), %.1f words/line\n", count, passes, (unsigned long) lines.size(), double(words) / count);
+	printf("text parser: %8.3f us/line\n", parsetime / count);
+	printf("lexer only:  %8.3f us/line (%.0f%% of the text parser)\n", lextime / count, lextime * 100 / parsetime);
+	printf("word array:  %u bytes (%u words of %u bytes, AVR: %u bytes)\n",
+		(unsigned) sizeof(lexer._words), (unsigned) CBenchLexer::MaxWords, (unsigned) sizeof(SWord), (unsigned) CBenchLexer::MaxWords * 8);
+
+	return 0;
+}
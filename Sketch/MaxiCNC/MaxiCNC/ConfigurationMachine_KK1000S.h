@@ -57,6 +57,8 @@
 #define CNC_ACC  350
 #define CNC_DEC  400
 #define CNC_JERKSPEED 1000
+#define CNC_RAMPTYPE CStepper::RampTrapezoid	// RampTrapezoid or RampSCurve (jerk limited, peak acc is CNC_ACC, 1.5 * longer ramps)
+#define CNC_ARCCHORDTOLERANCE 5				// mm1000, max deviation of G2/G3 segments, 0: segments from radius
 
 ////////////////////////////////////////////////////////
 // NoReference, ReferenceToMin, ReferenceToMax
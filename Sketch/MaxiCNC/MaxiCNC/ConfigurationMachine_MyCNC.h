@@ -60,6 +60,8 @@
 #define CNC_ACC  496                            // 0.257 => time to full speed
 #define CNC_DEC  565                            // 0.1975 => time to break
 #define CNC_JERKSPEED 2240
+#define CNC_RAMPTYPE CStepper::RampTrapezoid	// RampTrapezoid or RampSCurve (jerk limited, peak acc is CNC_ACC, 1.5 * longer ramps)
+#define CNC_ARCCHORDTOLERANCE 5				// mm1000, max deviation of G2/G3 segments, 0: segments from radius
 
 ////////////////////////////////////////////////////////
 // NoReference, ReferenceToMin, ReferenceToMax
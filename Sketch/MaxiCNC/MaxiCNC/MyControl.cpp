@@ -33,7 +33,11 @@
 
 CMyControl Control;
 CGCodeTools GCodeTools;
+#ifdef MYUSE_FIXEDCONVERSION
+CMotionControlT<STEPSPERROTATION*MICROSTEPPING, (unsigned long)(SCREWLEAD*1000), CMotionControl> MotionControl;
+#else
 CMotionControl MotionControl;
+#endif
 CConfigEeprom Eprom;
 HardwareSerial& StepperSerial = Serial;
 
@@ -51,7 +55,7 @@ const CConfigEeprom::SCNCEeprom CMyControl::_eepromFlash PROGMEM =
 	NUM_AXIS, MYNUM_AXIS, offsetof(CConfigEeprom::SCNCEeprom,axis), sizeof(CConfigEeprom::SCNCEeprom::SAxisDefinitions),
 	GetInfo1a(),GetInfo1b(),
 	0,
-	STEPPERDIRECTION,0,0,SPINDEL_FADETIMEDELAY,
+	STEPPERDIRECTION,CNC_RAMPTYPE,CNC_ARCCHORDTOLERANCE,SPINDEL_FADETIMEDELAY,
 	SPINDLE_MAXSPEED,
 	CNC_JERKSPEED,
 	CNC_MAXSPEED,
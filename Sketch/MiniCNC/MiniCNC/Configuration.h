@@ -62,6 +62,9 @@
 #define B_STEPSPERMM ((STEPSPERROTATION*MICROSTEPPING)/SCREWLEAD)
 #define C_STEPSPERMM ((STEPSPERROTATION*MICROSTEPPING)/SCREWLEAD)
 
+// compile time conversion (CMotionControlT), same for all axis => StepsPerMm1000 of the eeprom is not used
+//#define MYUSE_FIXEDCONVERSION
+
 ////////////////////////////////////////////////////////
 
 #define DISABLELEDBLINK
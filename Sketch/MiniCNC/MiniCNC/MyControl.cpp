@@ -31,7 +31,11 @@
 ////////////////////////////////////////////////////////////
 
 CMyControl Control;
+#ifdef MYUSE_FIXEDCONVERSION
+CMotionControlT<STEPSPERROTATION*MICROSTEPPING, (unsigned long)(SCREWLEAD*1000), CMotionControlDefault> MotionControl;
+#else
 CMotionControlDefault MotionControl;
+#endif
 CConfigEeprom Eprom;
 HardwareSerial& StepperSerial = Serial;
 
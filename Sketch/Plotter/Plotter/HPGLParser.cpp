@@ -76,16 +76,19 @@ void CHPGLParser::Parse()
 	if (_reader->GetChar())
 	{
 		_reader->SkipSpaces();
-		if (IsToken(F("SP"), false, false)) { SelectPenCommand();	return; }
-		if (IsToken(F("VS"), false, false)) { PenVelocityCommand();	return; }
-		if (IsToken(F("VN"), false, false)) { PenVelocityNormalCommand();	return; }
-		if (IsToken(F("IN"), false, false)) { InitCommand();		return; }
-		if (IsToken(F("PD"), false, false)) { PenMoveCommand(PD);	return; }
-		if (IsToken(F("PU"), false, false)) { PenMoveCommand(PU);	return; }
-		if (IsToken(F("PA"), false, false)) { PenMoveCommand(PA);	return; }
-		if (IsToken(F("PR"), false, false)) { PenMoveCommand(PR);	return; }
-		if (IsToken(F("LT"), false, false)) { IgnoreCommand();		return; }
-		if (IsToken(F("WU"), false, false)) { IgnoreCommand();		return; }
+		switch (GetMnemonic(false))
+		{
+			case Mnemonic('S', 'P'): SelectPenCommand();			return;
+			case Mnemonic('V', 'S'): PenVelocityCommand();			return;
+			case Mnemonic('V', 'N'): PenVelocityNormalCommand();	return;
+			case Mnemonic('I', 'N'): InitCommand();					return;
+			case Mnemonic('P', 'D'): PenMoveCommand(PD);			return;
+			case Mnemonic('P', 'U'): PenMoveCommand(PU);			return;
+			case Mnemonic('P', 'A'): PenMoveCommand(PA);			return;
+			case Mnemonic('P', 'R'): PenMoveCommand(PR);			return;
+			case Mnemonic('L', 'T'):
+			case Mnemonic('W', 'U'): IgnoreCommand();				return;
+		}
 
 		Error(MESSAGE_GCODE_IllegalCommand);
 	}
@@ -123,10 +126,13 @@ void CHPGLParser::PenMoveCommand(uint8_t cmdidx)
 		case PR:	_state._HPGLIsAbsolut = false;	break;
 	}
 
-	if (IsToken(F("PD"), false, false)) { PenMoveCommand(PD);	return; }
-	if (IsToken(F("PU"), false, false)) { PenMoveCommand(PU);	return; }
-	if (IsToken(F("PA"), false, false)) { PenMoveCommand(PA);	return; }
-	if (IsToken(F("PR"), false, false)) { PenMoveCommand(PR);	return; }
+	switch (TryMnemonic(false))
+	{
+		case Mnemonic('P', 'D'): GetMnemonic(false); PenMoveCommand(PD);	return;
+		case Mnemonic('P', 'U'): GetMnemonic(false); PenMoveCommand(PU);	return;
+		case Mnemonic('P', 'A'): GetMnemonic(false); PenMoveCommand(PA);	return;
+		case Mnemonic('P', 'R'): GetMnemonic(false); PenMoveCommand(PR);	return;
+	}
 
 	while (IsInt(_reader->GetChar()))
 	{
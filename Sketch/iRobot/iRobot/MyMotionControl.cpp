@@ -25,6 +25,7 @@
 #include <math.h>
 
 #include "CNCLib.h"
+#include <FastTrig.h>
 #include <GCodeParserBase.h>
 #include "MyMotionControl.h"
 #include "StepperServo.h"
@@ -66,7 +67,8 @@
 
 #define ANGLE3OFFSET DEFAULTANGLE
 
-#define SPLITMOVEDIST	10000
+#define SPLITMOVEDIST		20000		// max length of a segment (mm1000), see GetSegmentTolerance
+#define SPLITMOVETOLERANCE	1			// max deviation of a segment in servo units (1/SERVO_POSITION_SCALE us)
 
 #define MY_PI	float(M_PI)
 
@@ -183,14 +185,14 @@ bool CMyMotionControl::ToAngle(const mm1000_t pos[NUM_AXIS], float angle[NUM_AXI
 	float y = (float) pos[1];
 	float z = (float) pos[2];
 
-	float s = sqrt(x*x + y*y);
+	float s = sqrtf(x*x + y*y);
 
 	float c2 = (s - E)*(s - E) + (z - H)*(z - H);
-	float c = sqrt(c2);										// triangle for first and second segment
+	float c = sqrtf(c2);										// triangle for first and second segment
 
-	float alpha1 = (s - E) == 0.0 ? 0.0f : atanf((z - H) / (s - E));	// "base" angle of c
-	float alpha = acosf((B*B + c2 - A*A) / (2.0f*B*c));
-	float gamma = acosf((A*A + B*B - c2) / (2.0f*A*B));
+	float alpha1 = (s - E) == 0.0 ? 0.0f : CFastTrig::Atan((z - H) / (s - E));	// "base" angle of c
+	float alpha = CFastTrig::Acos((B*B + c2 - A*A) / (2.0f*B*c));
+	float gamma = CFastTrig::Acos((A*A + B*B - c2) / (2.0f*A*B));
 
 	angle[0] = (alpha + alpha1);
 	angle[1] = gamma;
@@ -200,7 +202,7 @@ bool CMyMotionControl::ToAngle(const mm1000_t pos[NUM_AXIS], float angle[NUM_AXI
 	}
 	else
 	{
-		angle[2] = atan(y / x);
+		angle[2] = CFastTrig::Atan(y / x);
 	}
 	if (x<0.0) 
 	{
@@ -238,47 +240,17 @@ bool CMyMotionControl::FromAngle(const float angle[NUM_AXIS], mm1000_t dest[NUM_
 
 /////////////////////////////////////////////////////////
 
-void CMyMotionControl::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+mm1000_t CMyMotionControl::GetMaxSegmentLength()
 {
-	unsigned short movecount = 1;
-	mm1000_t nextto[NUM_AXIS];
-	mm1000_t totaldist[NUM_AXIS];
-
-	mm1000_t maxdist=0;
-	const mm1000_t splitdist=SPLITMOVEDIST;
-
-	axis_t i;
-
-	for (i = 0; i < NUM_AXIS; i++)
-	{
-		mm1000_t dist=to[i]-_current[i];
-		totaldist[i] = dist;
-
-		if (dist<0) dist = -dist;
-		if (dist >  maxdist)
-			maxdist = dist;
-	}
-
-	if (maxdist > splitdist)
-	{
-		movecount = (unsigned short)(maxdist / splitdist);
-		if ((maxdist % splitdist) != 0)
-			movecount++;
-	}
-
-	for (unsigned short j = movecount-1; j > 0; j--)
-	{
-		for (i = 0; i < NUM_AXIS; i++)
-		{
-			mm1000_t newxtpos = RoundMulDivI32(totaldist[i], j, movecount);
-			nextto[i] = to[i] - newxtpos;
-		}
+	// a line is not a line of the servos => MoveAbs splits it, shorter segments where the arm is not linear
+	return SPLITMOVEDIST;
+}
 
-		super::MoveAbs(nextto,feedrate);
-		if (IsError()) return;
-	}
+/////////////////////////////////////////////////////////
 
-	super::MoveAbs(to,feedrate);
+mm1000_t CMyMotionControl::GetSegmentTolerance()
+{
+	return SPLITMOVETOLERANCE;
 }
 
 /////////////////////////////////////////////////////////
@@ -356,7 +328,7 @@ void CMyMotionControl::PrintInfo()
 
 /////////////////////////////////////////////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 mm1000_t ToMM(float mm)
 {
@@ -39,25 +39,27 @@ public:
 
 	void MoveAngle(const mm1000_t dest[NUM_AXIS]);
 	void MoveAngleLog(const mm1000_t dest[NUM_AXIS]);
-	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate) override;
 
 protected:
 
 	virtual void TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
 	virtual bool TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
-
-private:
+	virtual bool CanMoveArc() override { return false; }
+	virtual mm1000_t GetMaxSegmentLength() override;
+	virtual mm1000_t GetSegmentTolerance() override;
 
 //	static bool ToAngle(mm1000_t x, mm1000_t y, mm1000_t z, float& angle1, float& angle2, float& angle3);
 //	static bool FromAngle(float angle1, float angle2, float angle3, mm1000_t& x, mm1000_t& y, mm1000_t& z);
 
-	static bool ToAngle(const mm1000_t pos[NUM_AXIS], float angle[NUM_AXIS]);
+	static bool ToAngle(const mm1000_t pos[NUM_AXIS], float angle[NUM_AXIS]);		// see iRobotTest
 	static bool FromAngle(const float angle[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
 
+private:
+
 	static void AdjustToAngle(float angle[NUM_AXIS]);
 	static void AdjustFromAngle(float angle[NUM_AXIS]);
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 public:
 
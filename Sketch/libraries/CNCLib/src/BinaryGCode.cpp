@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+*/
+////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <Arduino.h>
+
+#include "BinaryGCode.h"
+
+////////////////////////////////////////////////////////////
+
+uint8_t CBinaryGCode::FrameSize(const uint8_t* frame, uint8_t count)
+{
+	if (count == 0)
+		return 0;
+
+	uint8_t idx = 1;
+
+	for (uint8_t values = frame[0] & (AxisMask | FeedRate); values != 0; values >>= 1)
+	{
+		if (values & 1)
+		{
+			// skip varint, a varint longer than MaxVarIntSize is terminated => Decode fails
+			for (uint8_t len = 1; ; len++, idx++)
+			{
+				if (idx >= count)
+					return 0;
+				if ((frame[idx] & 0x80) == 0 || len >= MaxVarIntSize)
+					break;
+			}
+			idx++;
+		}
+	}
+
+	if (idx >= count)
+		return 0;
+
+	return idx + 1;		// with crc
+}
+
+////////////////////////////////////////////////////////////
+
+bool CBinaryGCode::Decode(const uint8_t* frame, uint8_t size, SMove& move)
+{
+	if (size < 2 || Crc8(frame, size - 1) != frame[size - 1])
+		return false;
+
+	move.header = frame[0];
+	move.feedrate = 0;
+
+	const uint8_t* buffer = &frame[1];
+	uint32_t value;
+
+	for (uint8_t axis = 0; axis < MaxAxis; axis++)
+	{
+		move.distance[axis] = 0;
+		if (move.header & (1 << axis))
+		{
+			if (axis >= NUM_AXIS)
+				return false;
+
+			buffer = DecodeVarInt(buffer, value);
+			move.distance[axis] = UnZigZag(value);
+		}
+	}
+
+	if (move.header & FeedRate)
+	{
+		buffer = DecodeVarInt(buffer, value);
+		move.feedrate = feedrate_t(value);
+	}
+
+	return buffer == &frame[size - 1];
+}
+
+////////////////////////////////////////////////////////////
+
+uint8_t CBinaryGCode::Encode(const SMove& move, uint8_t* frame)
+{
+	uint8_t* buffer = frame;
+
+	*(buffer++) = move.header;
+
+	for (uint8_t axis = 0; axis < MaxAxis; axis++)
+	{
+		if (move.header & (1 << axis))
+			buffer = EncodeVarInt(buffer, ZigZag(move.distance[axis]));
+	}
+
+	if (move.header & FeedRate)
+		buffer = EncodeVarInt(buffer, uint32_t(move.feedrate));
+
+	uint8_t size = uint8_t(buffer - frame);
+	*buffer = Crc8(frame, size);
+
+	return size + 1;
+}
+
+////////////////////////////////////////////////////////////
+
+uint8_t CBinaryGCode::Crc8(const uint8_t* buffer, uint8_t size)
+{
+	uint8_t crc = 0;
+
+	while (size--)
+	{
+		crc ^= *(buffer++);
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x80) ? uint8_t((crc << 1) ^ 0x07) : uint8_t(crc << 1);
+	}
+
+	return crc;
+}
+
+////////////////////////////////////////////////////////////
+
+uint8_t* CBinaryGCode::EncodeVarInt(uint8_t* buffer, uint32_t value)
+{
+	// 7 bit per byte, lowest first, bit 7: more bytes follow
+
+	while (value >= 0x80)
+	{
+		*(buffer++) = uint8_t(value) | 0x80;
+		value >>= 7;
+	}
+	*(buffer++) = uint8_t(value);
+
+	return buffer;
+}
+
+////////////////////////////////////////////////////////////
+
+const uint8_t* CBinaryGCode::DecodeVarInt(const uint8_t* buffer, uint32_t& value)
+{
+	value = 0;
+
+	for (uint8_t shift = 0; shift < 7 * MaxVarIntSize; shift += 7)
+	{
+		uint8_t ch = *(buffer++);
+		value |= uint32_t(ch & 0x7f) << shift;
+		if ((ch & 0x80) == 0)
+			break;
+	}
+
+	return buffer;
+}
+
+////////////////////////////////////////////////////////////
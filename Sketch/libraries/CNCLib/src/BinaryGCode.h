@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+*/
+////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////
+
+#include "ConfigurationCNCLib.h"
+
+////////////////////////////////////////////////////////
+//
+// binary move frame (G0/G1), enabled with M130, answered with one byte (Ack/Nak)
+//
+// header	bit 0..5: axis (X..C) specified, bit 6: feedrate specified, bit 7: G1 (cut move), 0: end binary mode
+// axis		zigzag varint, distance in mm1000 to the current position (relative => no G92/G54 preset)
+// feedrate	varint, mm1000/min (G1 only, modal as "F")
+// crc		CRC-8 (polynom 0x07) of all bytes before
+//
+// a "Nak" (crc error, killed, ...) starts a resync: the controller stays in binary mode, answers complete frames with "Nak"
+// and skips all other bytes up to an EndBinary frame (answered with "Ack", back to text mode)
+// => the host stops sending moves and sends EndBinary (two zero bytes, they complete a broken frame) until it receives the "Ack"
+
+class CBinaryGCode
+{
+public:
+
+	enum EHeader
+	{
+		EndBinary = 0,
+		AxisMask = 0x3f,
+		FeedRate = 0x40,
+		CutMove = 0x80
+	};
+
+	enum EReply
+	{
+		Ack = 0x06,
+		Nak = 0x15
+	};
+
+	enum
+	{
+		MaxAxis = 6,
+		MaxVarIntSize = 5,
+		MaxFrameSize = 1 + MaxAxis * MaxVarIntSize + MaxVarIntSize + 1
+	};
+
+	struct SMove
+	{
+		uint8_t		header;
+		mm1000_t	distance[MaxAxis];
+		feedrate_t	feedrate;
+	};
+
+	static uint8_t FrameSize(const uint8_t* frame, uint8_t count);		// 0 if frame is not complete
+	static bool Decode(const uint8_t* frame, uint8_t size, SMove& move);	// false on crc error or invalid axis
+	static uint8_t Encode(const SMove& move, uint8_t* frame);			// return size, frame must have MaxFrameSize
+
+	static uint8_t Crc8(const uint8_t* buffer, uint8_t size);
+
+private:
+
+	static uint8_t* EncodeVarInt(uint8_t* buffer, uint32_t value);
+	static const uint8_t* DecodeVarInt(const uint8_t* buffer, uint32_t& value);
+
+	static uint32_t ZigZag(int32_t value)								{ return (uint32_t(value) << 1) ^ uint32_t(value >> 31); }
+	static int32_t UnZigZag(uint32_t value)								{ return int32_t(value >> 1) ^ -int32_t(value & 1); }
+};
+
+////////////////////////////////////////////////////////
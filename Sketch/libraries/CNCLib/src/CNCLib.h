@@ -21,6 +21,7 @@
 
 #include "ConfigurationCNCLib.h"
 #include "MotionControl.h"
+#include "MotionControlT.h"
 #include "DecimalAsInt.h"
 #include "Control.h"
 #include "Parser.h"
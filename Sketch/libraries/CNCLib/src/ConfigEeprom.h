@@ -163,8 +163,8 @@ public:
 		uint32_t  info2;
 
 		uint8_t	  stepperdirections;		// bits for each axis, see CStepper::SetDirection
-		uint8_t	  dummy2;
-		uint8_t	  dummy3;
+		uint8_t	  ramptype;					// see CStepper::ERampType (0: trapezoid)
+		uint8_t	  arcchordtolerance;		// mm1000, max deviation of arc segments (0: segments from radius, see CMotionControlBase::Arc)
 		uint8_t	  spindlefadetime;
 
 		uint16_t  maxspindlespeed;
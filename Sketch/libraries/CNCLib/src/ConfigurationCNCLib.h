@@ -26,10 +26,12 @@
 #ifdef REDUCED_SIZE
 
 #undef _USE_LCD
+#undef _USE_BINARYGCODE
 
 #else
 
 #define _USE_LCD
+#define _USE_BINARYGCODE		// M130: G0/G1 as binary frames, see BinaryGCode.h
 
 #endif
 
@@ -52,7 +54,7 @@ typedef long inch100000_t;		// 1/100000 inch
 //
 // Control
 
-#define SERIALBUFFERSIZE	128			// even size 
+#define SERIALBUFFERSIZE	128			// even size, receive buffer for more lines => host may stream with character counting (see "?" Bf:)
 
 #define TIMEOUTCALLIDEL		333			// time in ms after move completet to call Idle
 #define TIMEOUTCALLPOLL		500			// time in ms to call Poll() next if not idle => ASSERT( TIMEOUTCALLPOLL > TIMEOUTCALLIDEL)
@@ -63,3 +65,30 @@ typedef long inch100000_t;		// 1/100000 inch
 #define TIMEOUTBLINK		1000		// blink of led 13
 
 ////////////////////////////////////////////////////////
+//
+// Arc (G2/G3)
+
+// if the arc chord tolerance is set: shortest time of one segment (in us) => QueueMove and OptimizeMovementQueue must be faster
+// OptimizeMovementQueue re-plans at most MOVEMENTPLANMAXCOUNT movements (see CStepper::SetPlanMaxCount)
+
+#if defined(__SAM3X8E__) || defined(__SAMD21G18A__)
+
+#define ARC_QUEUEMOVETIME		250			// us, QueueMove and Arc calculation (32 bit, no fpu)
+#define ARC_OPTIMIZEMOVETIME	25			// us, OptimizeMovementQueue for each movement in the queue (look-ahead)
+
+#else
+
+#define ARC_QUEUEMOVETIME		1000		// us, QueueMove and Arc calculation (AVR 16Mhz)
+#define ARC_OPTIMIZEMOVETIME	100			// us, OptimizeMovementQueue for each movement in the queue (look-ahead)
+
+#endif
+
+#define ARC_MINSEGMENTTIME	(ARC_QUEUEMOVETIME + ARC_OPTIMIZEMOVETIME * min(MOVEMENTBUFFERSIZE, MOVEMENTPLANMAXCOUNT))	// e.g. SAM: 0.65ms, Mega2560: 2.6ms, Uno: 1.8ms
+
+////////////////////////////////////////////////////////
+//
+// Bezier (G5/G5.1)
+
+#define BEZIER_CHORDTOLERANCE	10			// mm1000, max deviation of the line segments if the arc chord tolerance is 0
+
+////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 
 #include "GCodeParser.h"
 #include "ConfigEeprom.h"
+#include "BinaryGCode.h"
 
 ////////////////////////////////////////////////////////////
 
@@ -35,7 +36,7 @@ template<> CControl* CSingleton<CControl>::_instance = NULL;
 
 CControl::CControl()
 {
-	_bufferidx = 0;
+	ClearBuffer();
 }
 
 ////////////////////////////////////////////////////////////
@@ -73,12 +74,19 @@ void CControl::Initialized()
 void CControl::InitFromEeprom()
 {
 	CStepper::GetInstance()->SetDirection(CConfigEeprom::GetConfigU8(offsetof(CConfigEeprom::SCNCEeprom, stepperdirections)));
+	CStepper::GetInstance()->SetRampType((CStepper::ERampType) CConfigEeprom::GetConfigU8(offsetof(CConfigEeprom::SCNCEeprom, ramptype)));
+	CMotionControlBase::GetInstance()->SetArcChordTolerance(CConfigEeprom::GetConfigU8(offsetof(CConfigEeprom::SCNCEeprom, arcchordtolerance)));
 
+	bool conversionFromEeprom = !CMotionControlBase::GetInstance()->IsConversionFixed();
+
+	if (conversionFromEeprom)
+	{
 #ifdef REDUCED_SIZE
-	CMotionControlBase::GetInstance()->InitConversionStepsPer(CConfigEeprom::GetConfigFloat(offsetof(CConfigEeprom::SCNCEeprom, StepsPerMm1000)));
+		CMotionControlBase::GetInstance()->InitConversionStepsPer(CConfigEeprom::GetConfigFloat(offsetof(CConfigEeprom::SCNCEeprom, StepsPerMm1000)));
 #else
-	CMotionControlBase::GetInstance()->InitConversionBestStepsPer(CConfigEeprom::GetConfigFloat(offsetof(CConfigEeprom::SCNCEeprom, StepsPerMm1000)));
+		CMotionControlBase::GetInstance()->InitConversionBestStepsPer(CConfigEeprom::GetConfigFloat(offsetof(CConfigEeprom::SCNCEeprom, StepsPerMm1000)));
 #endif
+	}
 
 	uint16_t jerkspeed = CConfigEeprom::GetConfigU16(offsetof(CConfigEeprom::SCNCEeprom, jerkspeed));
 	if (jerkspeed == 0) jerkspeed = 1024;
@@ -89,6 +97,10 @@ void CControl::InitFromEeprom()
 		((steprate_t)CConfigEeprom::GetConfigU16(offsetof(CConfigEeprom::SCNCEeprom, dec))),
 		jerkspeed);
 
+#ifdef USE_MERGEMOVE
+	CStepper::GetInstance()->SetMergeTolerance(MERGEMOVE_TOLERANCE);
+#endif
+
 	for (uint8_t axis = 0; axis < NUM_AXIS; axis++)
 	{
 		eepromofs_t ofs = sizeof(CConfigEeprom::SCNCEeprom::SAxisDefinitions)*axis;
@@ -109,7 +121,7 @@ void CControl::InitFromEeprom()
 		if (steprate != 0) CStepper::GetInstance()->SetDec(axis, steprate);
 
 		float stepsperMM1000 = CConfigEeprom::GetConfigFloat(offsetof(CConfigEeprom::SCNCEeprom, axis[0].StepsPerMm1000) + ofs);
-		if (stepsperMM1000 != 0.0)
+		if (stepsperMM1000 != 0.0 && conversionFromEeprom)
 		{
 			CMotionControlBase::GetInstance()->SetConversionStepsPerEx();
 			CMotionControlBase::GetInstance()->SetConversionStepsPerEx(axis, stepsperMM1000);
@@ -189,7 +201,7 @@ void CControl::Resurrect()
 
 #endif
 
-	_bufferidx = 0;
+	ClearBuffer();
 	StepperSerial.println(MESSAGE_OK_RESURRECT);
 }
 
@@ -342,67 +354,239 @@ bool CControl::IsEndOfCommandChar(char ch)
 
 ////////////////////////////////////////////////////////////
 
-void CControl::ReadAndExecuteCommand(Stream* stream, Stream* output, bool filestream)
+void CControl::ClearBuffer()
 {
-	// call this methode if ch is available in stream
+	_bufferidx = _bufferexecuting;			// the executing line is still parsed (e.g. Resurrect) => keep it, removed after the command
+	_bufferlines = 0;
+	_bufferskip = false;
+#ifdef _USE_BINARYGCODE
+	_binarymode = false;
+	_binaryresync = false;
+#endif
+}
 
-	if (stream->available() > 0)
+////////////////////////////////////////////////////////////
+
+void CControl::Receive(Stream* stream, Stream* output, bool filestream)
+{
+	// append all available chars to _buffer (more lines), serial: called while a command is executing (see OnWaitEvent)
+	// file: read one line only => the file position is the start of the next line
+
+	if (_bufferlocked)
+		return;
+
+	bool received = false;
+
+	while (_bufferidx < sizeof(_buffer) && stream->available() > 0)
 	{
-		while (stream->available() > 0)
+		char ch = stream->read();
+		received = true;
+
+#ifdef _USE_BINARYGCODE
+		if (_binarymode && !filestream)
 		{
-			char ch = _buffer[_bufferidx] = stream->read();
+			_buffer[_bufferidx++] = ch;				// no lines, see ExecuteBinaryCommand
+			continue;
+		}
+#endif
 
-			if (IsEndOfCommandChar(ch))
-			{
-				_buffer[_bufferidx] = 0;			// remove from buffer 
-				Command(_buffer, output);
-				_bufferidx = 0;
+		if (_bufferskip && !filestream)
+		{
+			_bufferskip = !IsEndOfCommandChar(ch);		// skip the rest of a line that did not fit
+			continue;
+		}
 
-				_lasttime = millis();
+		_buffer[_bufferidx++] = ch;
 
-				return;
-			}
+		if (IsEndOfCommandChar(ch))
+		{
+			_bufferlines++;
+			if (filestream)
+				break;
+		}
+	}
 
-			_bufferidx++;
-			if (_bufferidx >= sizeof(_buffer))
-			{
-				if (output)
-				{
-					PrintError(output); output->println(MESSAGE_CONTROL_FLUSHBUFFER);
-				}
-				_bufferidx = 0;
-			}
-/*
-			if (ch == '\x18')
-			{
-				StepperSerial.println(MESSAGE_CTRLX);
-				_bufferidx = 0;
-			}
-*/
+#ifdef _USE_BINARYGCODE
+	if (_binarymode && !filestream)
+	{
+		// no lines, a frame is shorter than _buffer => no overflow
+	}
+	else
+#endif
+	if (filestream && _bufferlines == 0 && _bufferidx > 0 && _bufferidx < sizeof(_buffer) && stream->available() == 0)
+	{
+		// e.g. SD card => execute last line without "EndOfLine"
+		_buffer[_bufferidx++] = '\n';
+		_bufferlines++;
+	}
+	else if (_bufferidx >= sizeof(_buffer) && _bufferlines == 0 && !_bufferexecuting)
+	{
+		// line does not fit in the buffer
+		if (output)
+		{
+			PrintError(output); output->println(MESSAGE_CONTROL_FLUSHBUFFER);
 		}
+		_bufferidx = 0;
 
-		if (filestream)						// e.g. SD card => execute last line without "EndOfLine"
+		if (filestream)
 		{
-			if (_bufferidx > 0)
-			{
-				_buffer[_bufferidx + 1] = 0;
-				Command(_buffer,output);
-				_bufferidx = 0;
-			}
+			// skip the rest of the line now, _bufferskip is for serial only (the next Receive may be serial)
+			while (stream->available() > 0 && !IsEndOfCommandChar(stream->read())) {}
+		}
+		else
+		{
+			_bufferskip = true;
 		}
+	}
+
+	if (received)
 		_lasttime = millis();
+}
+
+////////////////////////////////////////////////////////////
+
+void CControl::ExecuteReceivedCommand(Stream* output)
+{
+	// execute the first line of _buffer, the chars after are received while the command is executing
+
+#ifdef _USE_BINARYGCODE
+	if (_binarymode && _serialcommand)
+	{
+		ExecuteBinaryCommand(output);
+		return;
 	}
+#endif
+
+	if (_bufferlines == 0 || _bufferexecuting)
+		return;
+
+	uint8_t length = 0;
+	while (!IsEndOfCommandChar(_buffer[length]))
+		length++;
+
+	_buffer[length++] = 0;				// remove from buffer
+	_bufferlines--;
+
+	_bufferexecuting = length;
+	Command(_buffer, output);
+	_bufferexecuting = 0;
+
+	if (_bufferidx >= length)			// ClearBuffer keeps the executing line
+	{
+		_bufferidx -= length;
+		memmove(_buffer, &_buffer[length], _bufferidx);
+	}
+
+#ifdef _USE_BINARYGCODE
+	if (_binarymode)
+		_bufferlines = 0;				// M130: the host waits for "ok" => the rest of _buffer is binary
+#endif
+
+	_lasttime = millis();
 }
 
 ////////////////////////////////////////////////////////////
 
-bool CControl::SerialReadAndExecuteCommand()
+#ifdef _USE_BINARYGCODE
+
+bool CControl::SetBinaryMode()
+{
+	// the frames are received from the stream of M130 => serial only and not while a file is executing (shared _buffer)
+
+	if (!_serialcommand || PrintFromSDRunnding())
+		return false;
+
+	_binarymode = true;
+	_binaryresync = false;
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+void CControl::ExecuteBinaryCommand(Stream* output)
 {
-	if (StepperSerial.available() > 0)
+	// execute the first frame of _buffer and answer with one byte (Ack/Nak) instead of "ok"
+	// after a Nak the frame boundaries are unknown => stay in binary mode (no binary byte may reach the text parser)
+	// and discard everything up to a valid EndBinary frame (resync, see BinaryGCode.h)
+
+	uint8_t size = CBinaryGCode::FrameSize((const uint8_t*) _buffer, _bufferidx);
+
+	if (size == 0 || _bufferexecuting)
+		return;
+
+	CBinaryGCode::SMove move;
+	bool valid = CBinaryGCode::Decode((const uint8_t*) _buffer, size, move);
+	bool endbinary = valid && move.header == CBinaryGCode::EndBinary;
+	bool ok = endbinary;
+
+	if (!valid)
+	{
+		size = 1;						// not a frame => skip the first byte only
+	}
+	else if (!endbinary && !_binaryresync && !IsKilled())
+	{
+		CGCodeParserBase gcode(NULL, output);
+
+		_bufferexecuting = size;
+		ok = gcode.BinaryMoveCommand(move);
+		_bufferexecuting = 0;
+	}
+
+	if (output && (valid || !_binaryresync))
+		output->print(char(ok ? CBinaryGCode::Ack : CBinaryGCode::Nak));		// one answer per frame, not per skipped byte
+
+	if (_bufferidx >= size)				// not cleared by the command
+	{
+		_bufferidx -= size;
+		memmove(_buffer, &_buffer[size], _bufferidx);
+	}
+
+	if (!ok)
 	{
-		ReadAndExecuteCommand(&StepperSerial, &StepperSerial, false);			
+		_binaryresync = true;
+	}
+	else if (endbinary)
+	{
+		// zero bytes after EndBinary are sent by the host to complete a broken frame (resync)
+
+		uint8_t zeros = 0;
+		while (zeros < _bufferidx && _buffer[zeros] == 0)
+			zeros++;
+
+		_bufferidx -= zeros;
+		memmove(_buffer, &_buffer[zeros], _bufferidx);
+
+		_binarymode = false;
+		_binaryresync = false;
+		for (uint8_t idx = 0; idx < _bufferidx; idx++)
+		{
+			if (IsEndOfCommandChar(_buffer[idx]))
+				_bufferlines++;
+		}
 	}
 
+	_lasttime = millis();
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+
+void CControl::ReadAndExecuteCommand(Stream* stream, Stream* output, bool filestream)
+{
+	Receive(stream, output, filestream);
+
+	_serialcommand = !filestream;
+	ExecuteReceivedCommand(output);
+	_serialcommand = false;
+}
+
+////////////////////////////////////////////////////////////
+
+bool CControl::SerialReadAndExecuteCommand()
+{
+	ReadAndExecuteCommand(&StepperSerial, &StepperSerial, false);
+
 	return _bufferidx > 0;		// command pending, buffer not empty
 }
 
@@ -417,13 +601,13 @@ void CControl::FileReadAndExecuteCommand(Stream* stream, Stream* output)
 
 void CControl::Run()
 {
-	_bufferidx = 0;
+	ClearBuffer();
 	_lasttime = _timeBlink = _timePoll = 0;
 
 	Init();
 	Initialized();
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	while (!CGCodeParserBase::_exit)
 #else
 	while (true)
@@ -484,7 +668,7 @@ void CControl::ReadAndExecuteCommand()
 
 bool CControl::PostCommand(const __FlashStringHelper* cmd, Stream* output)
 {
-// use _buffer to execute command
+// use the free part of _buffer to execute command, no Receive while the command is executing
 
 	const char* cmd1 = (const char*)cmd;
 	uint8_t idx = _bufferidx;
@@ -496,7 +680,14 @@ bool CControl::PostCommand(const __FlashStringHelper* cmd, Stream* output)
 
 		if (_buffer[idx] == 0)
 		{
-			return Command(&_buffer[_bufferidx], output);
+			bool locked = _bufferlocked;
+			bool serialcommand = _serialcommand;
+			_bufferlocked = true;
+			_serialcommand = false;
+			bool ret = Command(&_buffer[_bufferidx], output);
+			_bufferlocked = locked;
+			_serialcommand = serialcommand;
+			return ret;
 		}
 	}
 	
@@ -508,7 +699,11 @@ bool CControl::PostCommand(const __FlashStringHelper* cmd, Stream* output)
 
 bool CControl::PostCommand(char* cmd, Stream* output)
 {
-	return Command(cmd, output);
+	bool serialcommand = _serialcommand;
+	_serialcommand = false;
+	bool ret = Command(cmd, output);
+	_serialcommand = serialcommand;
+	return ret;
 }
 
 ////////////////////////////////////////////////////////////
@@ -583,6 +778,8 @@ bool CControl::OnEvent(EnumAsByte(EStepperControlEvent) eventtype, uintptr_t add
 
 			if (CStepper::WaitTimeCritical > (CStepper::EWaitType) (unsigned int)addinfo)
 			{
+				if (_bufferexecuting)
+					Receive(&StepperSerial, &StepperSerial, false);	// keep the serial (host) streaming while the planner is full
 				CheckIdlePoll(false);
 			}
 			break;
@@ -141,16 +141,25 @@ public:
 	bool PostCommand(const __FlashStringHelper* cmd, Stream* output=NULL);
 	bool PostCommand(char* cmd, Stream* output=NULL);
 
+#ifdef _USE_BINARYGCODE
+	bool SetBinaryMode();										// see M130, the following commands are binary frames (after the current line), false if not a serial command
+	bool IsBinaryMode()					{ return _binarymode; }
+#endif
+
 	//////////////////////////////////////////
 
 	const char* GetBuffer()				{ return _buffer; }
 	uint8_t GetBufferCount()			{ return _bufferidx; }
+	uint8_t GetBufferFree()				{ return SERIALBUFFERSIZE - (_bufferidx > _bufferexecuting ? _bufferidx - _bufferexecuting : 0); }	// the executing line is removed after the command (character counting of the host)
 	virtual bool IsEndOfCommandChar(char ch);					// override default End of command char, default \n
 
 protected:
 
 	bool SerialReadAndExecuteCommand();							// read from serial an execut command, return true if command pending (buffer not empty)
 	void FileReadAndExecuteCommand(Stream* stream, Stream* output);// read command until "IsEndOfCommandChar" and execute command (NOT Serial)
+	void ReadAndExecuteCommand(Stream* stream, Stream* output, bool filestream);	// read command until "IsEndOfCommandChar" and execute command (Serial or SD.File)
+	void Receive(Stream* stream, Stream* output, bool filestream);	// append available chars to _buffer
+	void ClearBuffer();											// keeps the executing line
 
 	virtual void Init();
 	virtual void Initialized();									// called if Init() is done
@@ -175,12 +184,24 @@ protected:
 
 private:
 
-	void ReadAndExecuteCommand(Stream* stream, Stream* output, bool filestream);	// read command until "IsEndOfCommandChar" and execute command (Serial or SD.File)
+	void ExecuteReceivedCommand(Stream* output);				// execute the first complete line of _buffer
+#ifdef _USE_BINARYGCODE
+	void ExecuteBinaryCommand(Stream* output);					// execute the first complete frame of _buffer, answer Ack/Nak
+#endif
 
 	void CheckIdlePoll(bool isidle);							// check idle time and call Idle every 100ms
 
 
 	uint8_t			_bufferidx;									// read Buffer index , see SERIALBUFFERSIZE
+	uint8_t			_bufferlines;								// complete lines (with "IsEndOfCommandChar") in _buffer
+	bool			_bufferskip;								// serial: skip until end of line (line does not fit in _buffer)
+	uint8_t			_bufferexecuting=0;							// length of the executing first line (or frame) of _buffer, 0 => none
+	bool			_bufferlocked=false;						// PostCommand uses the end of _buffer => no Receive
+	bool			_serialcommand=false;						// the executing line (or frame) is received from serial (not file, not PostCommand)
+#ifdef _USE_BINARYGCODE
+	bool			_binarymode=false;							// _buffer contains binary frames (CBinaryGCode) instead of lines
+	bool			_binaryresync=false;						// after a Nak: discard frames and bytes up to EndBinary, see ExecuteBinaryCommand
+#endif
 
 	unsigned long	_lasttime;									// time last char received
 	unsigned long	_timeBlink;									// time to change blink state
@@ -189,9 +210,9 @@ private:
 	CStepper::SEvent _oldStepperEvent;
 
 	bool			_dummy;										// see gcode m01 & m02
-	bool			_printFromSDFile;
+	bool			_printFromSDFile=false;
 
-	char			_buffer[SERIALBUFFERSIZE];					// serial input buffer
+	char			_buffer[SERIALBUFFERSIZE];					// serial input buffer, more lines: received while the first line is executing
 
 	static void HandleInterrupt()								{ GetInstance()->TimerInterrupt(); }
 
@@ -116,6 +116,8 @@ void CExpressionParser::ScannNextToken()
 	{
 		char*start = (char*)_reader->GetBuffer();
 
+		_state._variableNo = 0;
+
 		ReadIdent();
 
 		char*end = (char*)_reader->GetBuffer();
@@ -192,6 +194,7 @@ expr_t CExpressionParser::ParseLevel1()
 		{
 			// assignment
 			expr_t ans;
+			NoCode();
 			GetNextToken();
 			ans = ParseLevel2();
 
@@ -335,7 +338,7 @@ expr_t CExpressionParser::ParseLevel8()
 	if (GetTokenType() == MinusSy)
 	{
 		GetNextToken();
-		return -ParseLevel9();
+		return EvalFunction(NegateSy, ParseLevel9());
 	}
 
 	return ParseLevel9();
@@ -386,10 +389,22 @@ expr_t CExpressionParser::ParseNumber()
 
 	switch (GetTokenType())
 	{
+		case VariableSy:
+			if (!_state._variableOK)
+				NoCode();
+			else if (_state._variableNo != 0)
+				EmitCode(VariableSy, &_state._variableNo, sizeof(_state._variableNo), 1);
+			else
+				EmitCode(FloatSy, &_state._number, sizeof(_state._number), 1);		// constant e.g. PI
+
+			ans = _state._number;
+			GetNextToken();
+			break;
+
 		case FloatSy:
 		case IntegerSy:
-		case VariableSy:
 			// this is a number
+			EmitCode(FloatSy, &_state._number, sizeof(_state._number), 1);
 			ans = _state._number;
 			GetNextToken();
 			break;
@@ -407,6 +422,8 @@ expr_t CExpressionParser::ParseNumber()
 
 expr_t CExpressionParser::EvalOperator(EnumAsByte(ETokenType) operatorSy, const expr_t &lhs, const expr_t &rhs)
 {
+	EmitCode(operatorSy, operatorSy == FactorialSy ? 0 : -1);
+
 	switch (operatorSy)
 	{
 		// level 2
@@ -449,8 +466,12 @@ expr_t CExpressionParser::EvalOperator(EnumAsByte(ETokenType) operatorSy, const
 
 expr_t CExpressionParser::EvalFunction(EnumAsByte(ETokenType) operatorSy, const expr_t &value)
 {
+	EmitCode(operatorSy, 0);
+
 	switch (operatorSy)
 	{
+		case NegateSy:  return -value;
+
 			// arithmetic
 		case AbsSy:  return abs(value);
 		case ExpSy:  return exp(value);
@@ -482,6 +503,80 @@ expr_t CExpressionParser::EvalFunction(EnumAsByte(ETokenType) operatorSy, const
 
 ////////////////////////////////////////////////////////////
 
+void CExpressionParser::EmitCode(EnumAsByte(ETokenType) tokenSy, const void* operand, uint8_t size, int8_t stack)
+{
+	// stack: change of the stack depth, +1 for a value, -1 for a binary operator
+
+	if (_code == NULL)
+		return;
+
+	if (_codeidx + 1 + size > _codesize || (stack > 0 && _codestack >= EXPRPARSER_MAXSTACK))
+	{
+		NoCode();
+		return;
+	}
+
+	_code[_codeidx++] = tokenSy;
+	memcpy(&_code[_codeidx], operand, size);
+	_codeidx += size;
+	_codestack += stack;
+}
+
+////////////////////////////////////////////////////////////
+
+expr_t CExpressionParser::Execute(const uint8_t* code, uint8_t size)
+{
+	// byte code is created by Parse => valid, stack depth < EXPRPARSER_MAXSTACK
+
+	expr_t stack[EXPRPARSER_MAXSTACK];
+	uint8_t sp = 0;
+	const uint8_t* end = code + size;
+
+	while (code < end && !IsError())
+	{
+		EnumAsByte(ETokenType) tokenSy = (ETokenType) *(code++);
+
+		switch (tokenSy)
+		{
+			case FloatSy:
+				memcpy(&stack[sp++], code, sizeof(expr_t));
+				code += sizeof(expr_t);
+				break;
+
+			case VariableSy:
+			{
+				uint16_t variableNo;
+				memcpy(&variableNo, code, sizeof(variableNo));
+				code += sizeof(variableNo);
+				if (!EvalVariableNo(variableNo, stack[sp++]))
+					ErrorAdd(MESSAGE_EXPR_UNKNOWN_VARIABLE);
+				break;
+			}
+
+			case FactorialSy:
+				stack[sp - 1] = EvalOperator(tokenSy, stack[sp - 1], 0.0);
+				break;
+
+			default:
+				if ((tokenSy >= FirstFunctionSy && tokenSy <= LastFunctionSy) || tokenSy == NegateSy)
+				{
+					stack[sp - 1] = EvalFunction(tokenSy, stack[sp - 1]);
+				}
+				else
+				{
+					sp--;
+					stack[sp - 1] = EvalOperator(tokenSy, stack[sp - 1], stack[sp]);
+				}
+				break;
+		}
+	}
+
+	Answer = IsError() ? 0 : stack[0];
+	return Answer;
+}
+
+////////////////////////////////////////////////////////////
+
 bool CExpressionParser::EvalVariable(const char* var_name, expr_t& answer)
 {
 	_state._varName = var_name;
@@ -23,6 +23,7 @@
 #include "Parser.h"
 
 #define EXPRPARSER_MAXTOKENLENGTH 16
+#define EXPRPARSER_MAXSTACK		8			// stack size to execute the byte code
 
 ////////////////////////////////////////////////////////
 //
@@ -43,6 +44,15 @@ public:
 
 	expr_t			Answer;
 
+	////////////////////////////////////////////////////////
+	// byte code: Parse stores the expression in postfix notation (Answer is calculated as well)
+	// Execute calculates the byte code without scanning the text, variables are read during execution
+
+	void SetCodeBuffer(uint8_t* code, uint8_t size)						{ _code = code; _codesize = size; _codeidx = 0; _codestack = 0; }
+	uint8_t GetCodeSize()												{ return _code != NULL ? _codeidx : 0; }	// 0: expression can not be compiled (e.g. assignment, too long)
+
+	expr_t Execute(const uint8_t* code, uint8_t size);
+
 protected:
 
 	char _LeftParenthesis;
@@ -54,6 +64,7 @@ protected:
 	virtual bool IsIdentStart(char ch)									{ return CStreamReader::IsAlpha(ch); }	// start of function or variable
 	
 	virtual bool EvalVariable(const char* var_name, expr_t& answer);
+	virtual bool EvalVariableNo(uint16_t /* variableNo */, expr_t& /* answer */)	{ return false; }	// see _variableNo, called by Execute
 	virtual void AssignVariable(const char* /*var_name*/, expr_t /*value*/)		{ };
 
 	enum ETokenType
@@ -91,7 +102,9 @@ protected:
 		ExpSy, SignSy, SqrtSy, LogSy, Log10Sy, SinSy, CosSy, TanSy, AsinSy, AcosSy, AtanSy,
 		FixSy, FupSy, RoundSy,
 
-		FactorialFncSy, LastFunctionSy = FactorialFncSy
+		FactorialFncSy, LastFunctionSy = FactorialFncSy,
+
+		NegateSy								// unary minus (byte code only)
 	};
 
 	struct SParserState
@@ -99,6 +112,7 @@ protected:
 		expr_t _number;							// number if parsed integer or float or variable(content)
 		
 		const char* _varName;
+		uint16_t	_variableNo;				// != 0: value of the variable may change => byte code reads variable (see EvalVariableNo) instead of _number
 
 		bool	_variableOK;					// _number = variable with content
 		EnumAsByte(ETokenType) _detailtoken;
@@ -126,6 +140,17 @@ protected:
 	expr_t Sign(expr_t value);
 
 	bool SaveAssign(char* buffer, char* current, char ch, uint8_t max);
+
+private:
+
+	uint8_t*	_code = NULL;
+	uint8_t		_codesize;
+	uint8_t		_codeidx;
+	uint8_t		_codestack;					// stack depth needed by Execute
+
+	void EmitCode(EnumAsByte(ETokenType) tokenSy, const void* operand, uint8_t size, int8_t stack);
+	void EmitCode(EnumAsByte(ETokenType) tokenSy, int8_t stack)		{ EmitCode(tokenSy, NULL, 0, stack); }
+	void NoCode()													{ _code = NULL; }
 };
 
 ////////////////////////////////////////////////////////
\ No newline at end of file
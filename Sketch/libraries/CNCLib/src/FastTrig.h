@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////
+
+#include <math.h>
+
+////////////////////////////////////////////////////////
+
+// fast (float) trigonometric functions for the inverse kinematics
+// atan with the polynomial of Abramowitz/Stegun 4.4.49 => max error 1e-5 rad, no division for |x| <= 1
+// no table => no PROGMEM access and the same code on AVR and ARM
+// an invalid argument (e.g. Acos(1.1)) results in NaN as the math.h function
+
+class CFastTrig
+{
+public:
+
+	static float Atan(float x)
+	{
+		if (x > 1.0f)
+			return float(M_PI_2) - AtanPoly(1.0f / x);
+		if (x < -1.0f)
+			return -float(M_PI_2) - AtanPoly(1.0f / x);
+		return AtanPoly(x);
+	}
+
+	static float Atan2(float y, float x)
+	{
+		float ax = fabs(x);
+		float ay = fabs(y);
+
+		if (ax == 0.0f && ay == 0.0f)
+			return 0.0f;
+
+		float angle;
+
+		if (ay <= ax)
+			angle = AtanPoly(ay / ax);
+		else
+			angle = float(M_PI_2) - AtanPoly(ax / ay);
+
+		if (x < 0.0f)
+			angle = float(M_PI) - angle;
+
+		return y < 0.0f ? -angle : angle;
+	}
+
+	static float Acos(float x)
+	{
+		return Atan2(sqrtf((1.0f - x) * (1.0f + x)), x);
+	}
+
+private:
+
+	static float AtanPoly(float x)							// |x| <= 1
+	{
+		float x2 = x * x;
+		return x * (0.9998660f + x2 * (-0.3302995f + x2 * (0.1801410f + x2 * (-0.0851330f + x2 * 0.0208351f))));
+	}
+};
+
+////////////////////////////////////////////////////////
@@ -39,7 +39,7 @@ void CGCodeExpressionParser::ReadIdent()
 	{
 		// start of GCODE variable => format #1 or #<_x>
 		_reader->GetNextChar();
-		_state._number = _gcodeparser->ParseParamNo();
+		_state._number = _state._variableNo = _gcodeparser->ParseParamNo();
 
 		if (_gcodeparser->IsError())
 		{
@@ -89,3 +89,11 @@ bool CGCodeExpressionParser::EvalVariable(const char* var_name, expr_t& answer)
 	}
 	return super::EvalVariable(var_name, answer);
 }
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeExpressionParser::EvalVariableNo(uint16_t variableNo, expr_t& answer)
+{
+	answer = CMm1000::ConvertTo(_gcodeparser->GetParamValue((param_t)variableNo, false));
+	return true;
+}
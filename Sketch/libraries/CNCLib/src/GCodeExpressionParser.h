@@ -43,6 +43,7 @@ protected:
 	virtual void ReadIdent() override;
 	virtual bool IsIdentStart(char ch) override		{ return ch == '#' || super::IsIdentStart(ch); }	// start of function or variable
 	virtual bool EvalVariable(const char* var_name, expr_t& answer) override;
+	virtual bool EvalVariableNo(uint16_t variableNo, expr_t& answer) override;
 };
 
 ////////////////////////////////////////////////////////
\ No newline at end of file
@@ -40,6 +40,8 @@
 
 struct CGCodeParser::SModalState CGCodeParser::_modalstate;
 struct CGCodeParser::SModelessState CGCodeParser::_modlessstate;
+struct CGCodeParser::SExpressionCache CGCodeParser::_expressioncache[EXPRESSIONCACHE_SIZE];
+struct CGCodeParser::SOWordState CGCodeParser::_owordstate;
 
 ////////////////////////////////////////////////////////////
 
@@ -52,6 +54,14 @@ bool CGCodeParser::InitParse()
 	if (!super::InitParse())
 		return false;
 
+	if (_owordstate.RecordNesting != 0)
+	{
+		// line of an O-word block => executed with the end of the block
+		OWordRecordLine(_reader->GetBuffer());
+		_reader->MoveToEnd();
+		return false;
+	}
+
 	_modlessstate.Init();
 	return true;				// continue
 }
@@ -60,6 +70,10 @@ bool CGCodeParser::InitParse()
 
 void CGCodeParser::CleanupParse()
 {
+	if (IsG53Present())
+	{
+		PresetChanged();		// G53 is modeless
+	}
 	_modlessstate.Init();		// state for no command
 	super::CleanupParse();
 }
@@ -76,65 +90,166 @@ bool CGCodeParser::GetParamOrExpression(mm1000_t* value, bool convertToInch)
 	}
 	if (_reader->GetChar() == '[')
 	{
-		const char* start = _reader->GetBuffer();
-		char ch = _reader->GetNextChar();
-		uint8_t count = 1;
+		expr_t answer;
+		if (GetExpression(answer))
+		{
+			*value = CMm1000::ConvertFrom(answer);
+		}
+		return true;
+	}
+		
+	return super::GetParamOrExpression(value, convertToInch);
+}
 
-		while (!_reader->IsEOC(ch))
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::GetExpression(expr_t& answer)
+{
+	// [expression]
+
+	if (_reader->GetChar() != '[')
+	{
+		Error(MESSAGE_EXPR_FORMAT);
+		return false;
+	}
+
+	const char* start = _reader->GetBuffer();
+	char ch = _reader->GetNextChar();
+	uint8_t count = 1;
+
+	while (!_reader->IsEOC(ch))
+	{
+		if (ch=='[')
 		{
-			if (ch=='[')
-			{
-				count++;
-			}
-			else if (ch == ']')
+			count++;
+		}
+		else if (ch == ']')
+		{
+			count--;
+			if (count==0)
 			{
-				count--;
-				if (count==0)
-				{
-					_reader->GetNextChar();
-					CStreamReader::CSetTemporary terminate(_reader->GetBuffer());
-					_reader->ResetBuffer(start);
+				_reader->GetNextChar();
+				CStreamReader::CSetTemporary terminate(_reader->GetBuffer());
+				_reader->ResetBuffer(start);
 
-					CGCodeExpressionParser exprpars(this);
-					exprpars.Parse();
-					if (exprpars.IsError())
-					{
-						Error(exprpars.GetError());
-					}
-					else
-					{
-						*value = CMm1000::ConvertFrom(exprpars.Answer);
-					}
-					return true;
-				}
+				return ParseExpression(answer);
 			}
-			ch = _reader->GetNextChar();
 		}
-		Error(MESSAGE_EXPR_MISSINGRPARENTHESIS);
-		return true;
+		ch = _reader->GetNextChar();
 	}
-		
-	return super::GetParamOrExpression(value, convertToInch);
+	Error(MESSAGE_EXPR_MISSINGRPARENTHESIS);
+	return false;
 }
 
 ////////////////////////////////////////////////////////////
 
-void CGCodeParser::CommentMessage(char* start)
+bool CGCodeParser::ParseExpression(expr_t& answer)
 {
-	bool isMsg = TryToken(start, F("(MSG,"), false, true);
-	if (isMsg)
+	// parse from the current position to the end of the buffer ('\0')
+	// the byte code is cached with the text as key, parametric programs (loops) evaluate the same expressions again
+
+	const char* text = _reader->GetBuffer();
+	size_t length = strlen(text);
+	bool cacheable = length < EXPRESSIONCACHE_TEXTLENGTH && strpbrk(text, ";(") == NULL;		// no comment
+
+	CGCodeExpressionParser exprpars(this);
+	SExpressionCache* cache = cacheable ? FindExpressionCache(text) : NULL;
+
+	if (cache != NULL)
 	{
-		start += 5;
-		while (start+1 < _reader->GetBuffer())
-			StepperSerial.print(*(start++));
-		StepperSerial.println();
+		exprpars.Execute(cache->_code, cache->_codesize);
+		_reader->ResetBuffer(text + length);
 	}
 	else
 	{
-		//see: http://linuxcnc.org/docs/html/gcode/overview.html#gcode:print
-		isMsg = TryToken(start, F("(PRINT,"), false, true);
-		if (isMsg)
+		uint8_t code[EXPRESSIONCACHE_CODESIZE];
+		if (cacheable)
+			exprpars.SetCodeBuffer(code, sizeof(code));
+
+		exprpars.Parse();
+
+		if (!exprpars.IsError() && exprpars.GetCodeSize() > 0)
+			AddExpressionCache(text, code, exprpars.GetCodeSize());
+	}
+
+	if (exprpars.IsError())
+	{
+		Error(exprpars.GetError());
+		return false;
+	}
+
+	answer = exprpars.Answer;
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+CGCodeParser::SExpressionCache* CGCodeParser::FindExpressionCache(const char* text)
+{
+	SExpressionCache* found = NULL;
+
+	for (uint8_t idx = 0; idx < EXPRESSIONCACHE_SIZE; idx++)
+	{
+		SExpressionCache& entry = _expressioncache[idx];
+		if (entry._codesize != 0 && strcmp(entry._text, text) == 0)
+		{
+			found = &entry;
+		}
+		else if (entry._age < 255)
 		{
+			entry._age++;
+		}
+	}
+
+	if (found != NULL)
+		found->_age = 0;
+
+	return found;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::AddExpressionCache(const char* text, const uint8_t* code, uint8_t codesize)
+{
+	// replace an unused or the least recently used entry
+
+	SExpressionCache* entry = &_expressioncache[0];
+
+	for (uint8_t idx = 1; idx < EXPRESSIONCACHE_SIZE && entry->_codesize != 0; idx++)
+	{
+		if (_expressioncache[idx]._codesize == 0 || _expressioncache[idx]._age > entry->_age)
+			entry = &_expressioncache[idx];
+	}
+
+	strcpy(entry->_text, text);
+	memcpy(entry->_code, code, codesize);
+	entry->_codesize = codesize;
+	entry->_age = 0;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::CommentMessage(char* start)
+{
+	switch (TryMnemonic(start + 1, true))
+	{
+		case Mnemonic('M', 'S'):
+		{
+			if (!TryToken(start, F("(MSG,"), false, true))
+				return;
+
+			start += 5;
+			while (start+1 < _reader->GetBuffer())
+				StepperSerial.print(*(start++));
+			StepperSerial.println();
+			break;
+		}
+		case Mnemonic('P', 'R'):
+		{
+			//see: http://linuxcnc.org/docs/html/gcode/overview.html#gcode:print
+			if (!TryToken(start, F("(PRINT,"), false, true))
+				return;
+
 			start += 7;
 			const char*current = _reader->GetBuffer();
 			while (start + 1 < current)
@@ -153,6 +268,7 @@ void CGCodeParser::CommentMessage(char* start)
 			}
 			_reader->ResetBuffer(current);
 			StepperSerial.println();
+			break;
 		}
 	}
 }
@@ -342,49 +458,16 @@ mm1000_t CGCodeParser::GetParamValue(param_t paramNo, bool convertUnits)
 
 void CGCodeParser::SetParamValue(param_t paramNo)
 {
-	CGCodeExpressionParser exprpars(this);
-	exprpars.Parse();
-	if (exprpars.IsError())
-		Error(exprpars.GetError());
-	else
+	expr_t answer;
+	if (ParseExpression(answer))
 	{
-		mm1000_t mm1000 = CMm1000::ConvertFrom(exprpars.Answer);
-		uint32_t intvalue = exprpars.Answer;
+		mm1000_t mm1000 = CMm1000::ConvertFrom(answer);
+		uint32_t intvalue = answer;
 		const SParamInfo*param = FindParamInfoByParamNo(paramNo);
 
 		if (IsModifyParam(paramNo))				
 		{ 
-			uint8_t paramIdx = ParamNoToParamIdx(paramNo);
-
-			if (paramIdx == 255)
-			{
-				if (exprpars.Answer != 0.0)
-				{
-					uint8_t idx;
-					for (idx = 0; idx<NUM_PARAMETER;idx++)
-					{
-						if (_modalstate.ParamNoToIdx[idx] == 0)
-						{
-							_modalstate.ParamNoToIdx[idx] = (uint8_t)paramNo;
-							_modalstate.Parameter[idx] = exprpars.Answer;
-							break;
-						}
-					}
-					if (idx >= NUM_PARAMETER)
-					{
-						Error(MESSAGE_GCODE_NoParamSlotAvailable);
-					}
-				}			
-			} 
-			else if (exprpars.Answer == 0.0)
-			{
-				// free slot
-				_modalstate.ParamNoToIdx[paramIdx] = 0;
-			}
-			else
-			{
-				_modalstate.Parameter[paramIdx] = exprpars.Answer;
-			}
+			SetModifyParamValue(paramNo, answer);
 		}
 		else if (param != NULL)
 		{
@@ -394,7 +477,7 @@ void CGCodeParser::SetParamValue(param_t paramNo)
 				case PARAMSTART_BACKLASH:			{ CStepper::GetInstance()->SetBacklash(axis, (mdist_t)GetParamAsMachine(mm1000, axis));	break;  }
 				case PARAMSTART_BACKLASH_FEEDRATE:	{ CStepper::GetInstance()->SetBacklash((steprate_t)GetParamAsFeedrate(mm1000, axis)); break; }
 				case PARAMSTART_CONTROLLERFAN:		{ CControl::GetInstance()->IOControl(CControl::ControllerFan, (unsigned short)intvalue);	break;  }
-				case PARAMSTART_RAPIDMOVEFEED:		{ SetG0FeedRate(-CFeedrate1000::ConvertFrom(exprpars.Answer)); break;	}
+				case PARAMSTART_RAPIDMOVEFEED:		{ SetG0FeedRate(-CFeedrate1000::ConvertFrom(answer)); break;	}
 				case PARAMSTART_MAX:				{ CStepper::GetInstance()->SetLimitMax(axis, GetParamAsMachine(mm1000, axis));	break;	}
 				case PARAMSTART_MIN:				{ CStepper::GetInstance()->SetLimitMin(axis, GetParamAsMachine(mm1000, axis));	break;	}
 				case PARAMSTART_ACC:				{ CStepper::GetInstance()->SetAcc(axis, (steprate_t)intvalue); break;	}
@@ -412,6 +495,7 @@ void CGCodeParser::SetParamValue(param_t paramNo)
 					if (idx < G54ARRAYSIZE)
 					{
 						_modalstate.G54Pospreset[idx][axis] = mm1000;
+						PresetChanged();
 					}
 					break;
 				}
@@ -428,6 +512,44 @@ void CGCodeParser::SetParamValue(param_t paramNo)
 		ExpectEndOfCommand();
 	}
 }
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::SetModifyParamValue(param_t paramNo, expr_t value)
+{
+	uint8_t paramIdx = ParamNoToParamIdx(paramNo);
+
+	if (paramIdx == 255)
+	{
+		if (value != 0.0)
+		{
+			uint8_t idx;
+			for (idx = 0; idx<NUM_PARAMETER;idx++)
+			{
+				if (_modalstate.ParamNoToIdx[idx] == 0)
+				{
+					_modalstate.ParamNoToIdx[idx] = (uint8_t)paramNo;
+					_modalstate.Parameter[idx] = value;
+					break;
+				}
+			}
+			if (idx >= NUM_PARAMETER)
+			{
+				Error(MESSAGE_GCODE_NoParamSlotAvailable);
+			}
+		}			
+	} 
+	else if (value == 0.0)
+	{
+		// free slot
+		_modalstate.ParamNoToIdx[paramIdx] = 0;
+	}
+	else
+	{
+		_modalstate.Parameter[paramIdx] = value;
+	}
+}
+
 ////////////////////////////////////////////////////////////
 
 const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfo(uintptr_t param, bool(*check)(const SParamInfo*, uintptr_t param))
@@ -444,13 +566,42 @@ const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfo(uintptr_t param, boo
 
 ////////////////////////////////////////////////////////////
 
+uint8_t CGCodeParser::ParamTextHash(const char* text, bool isProgmem)
+{
+	// case insensitive, see strcasecmp_P
+
+	uint8_t hash = 0;
+	for (char ch; (ch = isProgmem ? (char) pgm_read_byte(text) : *text) != 0; text++)
+	{
+		hash = uint8_t(hash * 31 + CStreamReader::Toupper(ch));
+	}
+	return hash;
+}
+
+////////////////////////////////////////////////////////////
+
 const CGCodeParser::SParamInfo* CGCodeParser::FindParamInfoByText(const char* text)
 {
-	return FindParamInfo((uintptr_t) text, [](const SParamInfo* p, uintptr_t x) -> bool
+	// compare the hash first, strcasecmp_P only if the hash matches
+
+	if (!_paramdefhashvalid)
 	{
-		const char* text = p->GetText();
-		return text != NULL && strcasecmp_P((const char*)x, text) == 0;
-	});
+		for (uint8_t idx = 0; _paramdef[idx].GetParamNo() != 0; idx++)
+		{
+			_paramdefhash[idx] = ParamTextHash(_paramdef[idx].GetText(), true);
+		}
+		_paramdefhashvalid = true;
+	}
+
+	uint8_t hash = ParamTextHash(text, false);
+
+	for (uint8_t idx = 0; _paramdef[idx].GetParamNo() != 0; idx++)
+	{
+		if (_paramdefhash[idx] == hash && strcasecmp_P(text, _paramdef[idx].GetText()) == 0)
+			return &_paramdef[idx];
+	}
+
+	return NULL;
 }
 
 ////////////////////////////////////////////////////////////
@@ -547,6 +698,9 @@ const CGCodeParser::SParamInfo CGCodeParser::_paramdef[] PROGMEM =
 	{ 0,NULL,false }
 };
 
+uint8_t CGCodeParser::_paramdefhash[sizeof(CGCodeParser::_paramdef) / sizeof(CGCodeParser::_paramdef[0])];
+bool CGCodeParser::_paramdefhashvalid;
+
 ////////////////////////////////////////////////////////////
 
 void CGCodeParser::PrintParam(const CGCodeParser::SParamInfo* item, axis_t axis)
@@ -665,6 +819,11 @@ bool CGCodeParser::Command(char ch)
 			ParameterCommand();
 			return true;
 		}
+		case 'O':
+		{
+			OWordCommand();
+			return true;
+		}
 
 		// case '-':
 		case '!':
@@ -682,6 +841,7 @@ bool CGCodeParser::GCommand(uint8_t gcode)
 
 	switch (gcode)
 	{
+		case 5:		G05Command(); return true;
 		case 10:	G10Command(); return true;
 		case 38:	G38Command(); return true;
 		case 40:	G40Command(); return true;
@@ -726,6 +886,9 @@ bool CGCodeParser::MCommand(mcode_t mcode)
 		case 110: M110Command(); return true;
 		case 111: M111Command(); return true;
 		case 114: M114Command(); return true;
+#ifdef _USE_BINARYGCODE
+		case 130: M130Command(); return true;
+#endif
 		case 220: M220Command(); return true;
 #ifndef REDUCED_SIZE
 		case 300: M300Command(); return true;
@@ -800,6 +963,433 @@ void CGCodeParser::ToolSelectCommand()
 	_modalstate.ToolSelected = tool;
 }
 
+////////////////////////////////////////////////////////////
+// O-word:	O100 sub ... O100 endsub, O100 call [1] [2] (arguments => #1, #2)
+//			O101 while [#1 < 10] ... O101 endwhile
+//			O102 repeat [5] ... O102 endrepeat
+// the lines of the block are recorded (serial or SD) and executed from _owordstate.Buffer => loops do not read and parse the input again
+
+void CGCodeParser::OWordCommand()
+{
+	const char* start = _reader->GetBuffer();
+	uint16_t no;
+	EOWord oword = ParseOWord(no);
+	if (IsError())
+		return;
+
+	switch (oword)
+	{
+		case SubOWord:
+		case WhileOWord:
+		case RepeatOWord:
+		{
+			if (_owordstate.CallDepth == 0)
+			{
+				// record all lines until the end of the block
+				_owordstate.RecordStart = _owordstate.RecordEnd = _owordstate.SubEnd;
+				OWordRecordLine(start);
+				_reader->MoveToEnd();
+				return;
+			}
+			if (oword == SubOWord)
+			{
+				Error(MESSAGE_GCODE_UnsupportedOWord);		// sub inside a block
+				return;
+			}
+			OWordLoop(oword, no);
+			break;
+		}
+		case EndWhileOWord:
+		case EndRepeatOWord:
+		{
+			if (_owordstate.CallDepth == 0 || _owordstate.LoopCount <= _owordstate.LoopBase || _owordstate.Loop[_owordstate.LoopCount - 1].No != no)
+			{
+				Error(MESSAGE_GCODE_OWordNoMatchingBlock);
+				return;
+			}
+			_owordstate.PC = _owordstate.Loop[_owordstate.LoopCount - 1].PC;		// while/repeat again
+			break;
+		}
+		case EndSubOWord:
+		case ReturnOWord:
+		{
+			if (_owordstate.CallDepth == 0)
+			{
+				Error(MESSAGE_GCODE_OWordNoMatchingBlock);
+				return;
+			}
+			_owordstate.PC = _owordstate.End;
+			break;
+		}
+		case CallOWord:		OWordCall(no); break;
+		default:			Error(MESSAGE_GCODE_UnsupportedOWord); return;
+	}
+
+	if (!IsError())
+		ExpectEndOfCommand();
+}
+
+////////////////////////////////////////////////////////////
+
+CGCodeParser::EOWord CGCodeParser::ParseOWord(uint16_t& no)
+{
+	if (_reader->SkipSpacesToUpper() != 'O' || !IsUInt(_reader->GetNextChar()))
+		return NoOWord;
+
+	no = GetUInt16();
+	_reader->SkipSpaces();
+
+	// dispatch with the first two letters, compare (Progmem) only the keywords starting with them
+
+	switch (TryMnemonic(true))
+	{
+		case Mnemonic('S', 'U'):
+			if (IsToken(F("SUB"), false, true))			return SubOWord;
+			break;
+		case Mnemonic('C', 'A'):
+			if (IsToken(F("CALL"), false, true))		return CallOWord;
+			break;
+		case Mnemonic('R', 'E'):
+			if (IsToken(F("RETURN"), false, true))		return ReturnOWord;
+			if (IsToken(F("REPEAT"), false, true))		return RepeatOWord;
+			break;
+		case Mnemonic('W', 'H'):
+			if (IsToken(F("WHILE"), false, true))		return WhileOWord;
+			break;
+		case Mnemonic('E', 'N'):
+			if (IsToken(F("ENDSUB"), false, true))		return EndSubOWord;
+			if (IsToken(F("ENDWHILE"), false, true))	return EndWhileOWord;
+			if (IsToken(F("ENDREPEAT"), false, true))	return EndRepeatOWord;
+			break;
+	}
+
+	return NoOWord;
+}
+
+////////////////////////////////////////////////////////////
+
+CGCodeParser::EOWord CGCodeParser::ParseOWordLine(const char* line, uint16_t& no)
+{
+	const char* buffer = _reader->GetBuffer();
+	_reader->ResetBuffer(line);
+
+	if (_reader->SkipSpacesToUpper() == 'N')		// line number of a line not recorded (discard)
+	{
+		while (CStreamReader::IsDigit(_reader->GetNextChar())) {}
+	}
+
+	EOWord oword = ParseOWord(no);
+
+	_reader->ResetBuffer(buffer);
+	return oword;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordRecordLine(const char* line)
+{
+	uint16_t pc = _owordstate.RecordEnd;
+	uint16_t no;
+	EOWord oword;
+
+	if (_owordstate.RecordDiscard || !OWordAddLine(line))
+	{
+		// block does not fit in the buffer => discard all lines up to the end of the block (no line of it is executed)
+
+		oword = ParseOWordLine(line, no);
+		_owordstate.RecordEnd = _owordstate.SubEnd;
+
+		if (!_owordstate.RecordDiscard)
+		{
+			_owordstate.RecordDiscard = true;
+			Error(MESSAGE_GCODE_OWordBufferFull);
+		}
+	}
+	else
+	{
+		if (pc == _owordstate.RecordEnd)
+			return;			// empty line or comment
+
+		oword = ParseOWordLine(pc, no);
+	}
+
+	switch (oword)
+	{
+		case SubOWord:
+		case WhileOWord:
+		case RepeatOWord:		_owordstate.RecordNesting++; break;
+		case EndSubOWord:
+		case EndWhileOWord:
+		case EndRepeatOWord:	_owordstate.RecordNesting--; break;
+		default:				break;
+	}
+
+	if (_owordstate.RecordNesting != 0)
+		return;
+
+	if (_owordstate.RecordDiscard)
+	{
+		_owordstate.RecordDiscard = false;
+		return;
+	}
+
+	// end of block
+
+	if (ParseOWordLine(_owordstate.RecordStart, no) == SubOWord)
+	{
+		OWordAddSub(no, pc);
+	}
+	else
+	{
+		OWordExecute(_owordstate.RecordStart, _owordstate.RecordEnd);
+		_owordstate.RecordEnd = _owordstate.SubEnd;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+bool CGCodeParser::OWordAddLine(const char* line)
+{
+	// add line without line number, spaces and comments => return false if the buffer is full
+
+	uint16_t idx = _owordstate.RecordEnd;
+
+	while (CStreamReader::IsSpace(*line))
+		line++;
+
+	if (CStreamReader::Toupper(*line) == 'N')
+	{
+		for (line++; CStreamReader::IsDigit(*line); line++) {}
+	}
+
+	for (char ch; (ch = *line) != 0 && ch != ';'; line++)
+	{
+		if (ch == '(')
+		{
+			line = strchr(line, ')');
+			if (line == NULL)
+				break;
+		}
+		else if (!CStreamReader::IsSpace(ch))
+		{
+			if (idx >= OWORD_BUFFERSIZE - 1)
+				return false;
+			_owordstate.Buffer[idx++] = ch;
+		}
+	}
+
+	if (idx != _owordstate.RecordEnd)
+	{
+		_owordstate.Buffer[idx++] = 0;
+		_owordstate.RecordEnd = idx;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordAddSub(uint16_t no, uint16_t endsub)
+{
+	// the new sub is recorded at SubEnd => remove a sub with the same number (sent again)
+
+	for (uint8_t idx = 0; idx < _owordstate.SubCount; idx++)
+	{
+		if (_owordstate.Sub[idx].No == no)
+		{
+			uint16_t start = _owordstate.Sub[idx].Start;
+			uint16_t size = OWordNextLine(_owordstate.Sub[idx].End) - start;
+
+			memmove(&_owordstate.Buffer[start], &_owordstate.Buffer[start + size], _owordstate.RecordEnd - start - size);
+			_owordstate.Sub[idx] = _owordstate.Sub[--_owordstate.SubCount];
+
+			for (uint8_t i = 0; i < _owordstate.SubCount; i++)
+			{
+				if (_owordstate.Sub[i].Start > start)
+				{
+					_owordstate.Sub[i].Start -= size;
+					_owordstate.Sub[i].End -= size;
+				}
+			}
+
+			_owordstate.SubEnd -= size;
+			_owordstate.RecordStart -= size;
+			_owordstate.RecordEnd -= size;
+			endsub -= size;
+			break;
+		}
+	}
+
+	if (_owordstate.SubCount >= OWORD_MAXSUB)
+	{
+		_owordstate.RecordEnd = _owordstate.SubEnd;
+		Error(MESSAGE_GCODE_OWordBufferFull);
+		return;
+	}
+
+	SOWordState::SSub& sub = _owordstate.Sub[_owordstate.SubCount++];
+	sub.No = no;
+	sub.Start = _owordstate.RecordStart;
+	sub.End = endsub;
+
+	_owordstate.SubEnd = _owordstate.RecordEnd;
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordExecute(uint16_t start, uint16_t end)
+{
+	if (_owordstate.CallDepth >= OWORD_MAXCALLDEPTH)
+	{
+		Error(MESSAGE_GCODE_OWordNestingTooDeep);
+		return;
+	}
+
+	const char* buffer = _reader->GetBuffer();
+	uint16_t linePC = _owordstate.LinePC;
+	uint16_t pc = _owordstate.PC;
+	uint16_t pcend = _owordstate.End;
+	uint8_t loopBase = _owordstate.LoopBase;
+
+	_owordstate.CallDepth++;
+	_owordstate.LoopBase = _owordstate.LoopCount;
+	_owordstate.End = end;
+
+	for (_owordstate.PC = start; _owordstate.PC < _owordstate.End && !IsError();)
+	{
+		if (CStepper::GetInstance()->IsEmergencyStop())
+		{
+			Error(MESSAGE_GCODE_OWordKilled);
+			break;
+		}
+
+		_owordstate.LinePC = _owordstate.PC;
+		_owordstate.PC = OWordNextLine(_owordstate.PC);		// changed by an O-word (e.g. endwhile)
+
+		_reader->ResetBuffer(&_owordstate.Buffer[_owordstate.LinePC]);
+		ParseCommand();
+		_OkMessage = NULL;									// no reply for lines of a block
+	}
+
+	_owordstate.CallDepth--;
+	_owordstate.LoopCount = _owordstate.LoopBase;
+	_owordstate.LoopBase = loopBase;
+	_owordstate.End = pcend;
+	_owordstate.PC = pc;
+	_owordstate.LinePC = linePC;
+
+	_reader->ResetBuffer(buffer);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordCall(uint16_t no)
+{
+	uint8_t idx;
+	for (idx = 0; idx < _owordstate.SubCount && _owordstate.Sub[idx].No != no; idx++) {}
+
+	if (idx >= _owordstate.SubCount)
+	{
+		Error(MESSAGE_GCODE_OWordSubNotFound);
+		return;
+	}
+
+	// arguments are assigned to the (global) parameters #1, #2, ...
+
+	for (param_t paramNo = 1; _reader->SkipSpaces() == '['; paramNo++)
+	{
+		expr_t value;
+		if (!GetExpression(value))
+			return;
+
+		SetModifyParamValue(paramNo, value);
+		if (IsError())
+			return;
+	}
+
+	OWordExecute(OWordNextLine(_owordstate.Sub[idx].Start), _owordstate.Sub[idx].End);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordLoop(EOWord oword, uint16_t no)
+{
+	// the line is executed again with endwhile/endrepeat => the loop is the last in Loop[]
+
+	SOWordState::SLoop* loop = &_owordstate.Loop[_owordstate.LoopCount];
+	bool again = _owordstate.LoopCount > _owordstate.LoopBase && loop[-1].PC == _owordstate.LinePC;
+
+	if (again)
+	{
+		loop--;
+	}
+	else
+	{
+		if (_owordstate.LoopCount >= OWORD_MAXLOOP)
+		{
+			Error(MESSAGE_GCODE_OWordNestingTooDeep);
+			return;
+		}
+		_owordstate.LoopCount++;
+		loop->PC = _owordstate.LinePC;
+		loop->No = no;
+		loop->Count = 0;
+	}
+
+	bool execute;
+
+	if (oword == WhileOWord)
+	{
+		expr_t value;
+		if (!GetExpression(value))
+			return;
+		execute = value != 0.0;
+	}
+	else
+	{
+		if (again)
+		{
+			_reader->MoveToEnd();				// count is calculated once
+		}
+		else
+		{
+			expr_t value;
+			if (!GetExpression(value))
+				return;
+			loop->Count = value > 0.0 ? (value < 65535.0 ? (uint16_t) value : 65535) : 0;
+		}
+
+		execute = loop->Count != 0;
+		if (execute)
+			loop->Count--;
+	}
+
+	if (!execute)
+	{
+		_owordstate.LoopCount--;
+		OWordSkipBlock(oword == WhileOWord ? EndWhileOWord : EndRepeatOWord, no);
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::OWordSkipBlock(EOWord endoword, uint16_t no)
+{
+	// continue after the end of the block
+
+	for (uint16_t pc = _owordstate.PC; pc < _owordstate.End; pc = OWordNextLine(pc))
+	{
+		uint16_t lineno = 0;
+		if (ParseOWordLine(pc, lineno) == endoword && lineno == no)
+		{
+			_owordstate.PC = OWordNextLine(pc);
+			return;
+		}
+	}
+
+	Error(MESSAGE_GCODE_OWordNoMatchingBlock);
+}
+
 ////////////////////////////////////////////////////////////
 
 void CGCodeParser::GetR81(SAxisMove& move)
@@ -877,6 +1467,126 @@ void CGCodeParser::GetQ81(SAxisMove& move)
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParser::GetG5PQ(char ch, SAxisMove& move, mm1000_t offset[2])
+{
+	// P Q: offset of the second control point to the end point (plane axis 0 / 1)
+
+	if (ch == 'P')
+	{
+		if (move.bitfield.bit.P)	{ Error(MESSAGE_GCODE_PalreadySpecified); return; }
+		move.bitfield.bit.P = true;
+		_reader->GetNextChar();
+		offset[0] = ParseCoordinateAxis(super::_modalstate.Plane_axis_0);
+	}
+	else
+	{
+		if (move.bitfield.bit.Q)	{ Error(MESSAGE_GCODE_QalreadySpecified); return; }
+		move.bitfield.bit.Q = true;
+		_reader->GetNextChar();
+		offset[1] = ParseCoordinateAxis(super::_modalstate.Plane_axis_1);
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::G05Command()
+{
+	uint8_t subcode = GetSubCode();
+
+	switch (subcode)
+	{
+		case 1:		G051Command(); break;
+		case 255:	G050Command(); break;
+		default:	ErrorNotImplemented(); break;
+	}
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::G050Command()
+{
+	// G5 X Y I J P Q: cubic spline
+	// I J: offset of the first control point to the start point, P Q: offset of the second control point to the end point
+	// I J may be omitted after a G5 => mirror of the last second control point
+
+	bool afterG5 = super::_modalstate.LastCommand == (LastCommandCB) &CGCodeParser::G050Command;
+
+	SAxisMove move(true);
+	mm1000_t offsetIJ[2] = { 0, 0 };
+	mm1000_t offsetPQ[2] = { 0, 0 };
+
+	for (char ch = _reader->SkipSpacesToUpper(); ch; ch = _reader->SkipSpacesToUpper())
+	{
+		axis_t axis;
+		if ((axis = CharToAxis(ch)) < NUM_AXIS)				GetAxis(axis, move, super::_modalstate.IsAbsolut ? AbsolutWithZeroShiftPosition : RelativPosition);
+		else if ((axis = CharToAxisOffset(ch)) < NUM_AXIS)	GetIJK(axis, move, offsetIJ);
+		else if (ch == 'P' || ch == 'Q')					GetG5PQ(ch, move, offsetPQ);
+		else if (ch == 'F')									GetFeedrate(move);
+		else break;
+
+		if (CheckError()) { return; }
+	}
+
+	uint8_t planeIJ = (1 << super::_modalstate.Plane_axis_0) + (1 << super::_modalstate.Plane_axis_1);
+
+	if (!move.bitfield.bit.P || !move.bitfield.bit.Q)			{ Error(MESSAGE_GCODE_PandQExpected); return; }
+	if (move.GetIJK() != planeIJ && (move.GetIJK() || !afterG5))	{ Error(MESSAGE_GCODE_IandJExpected); return; }
+
+	super::_modalstate.LastCommand = (LastCommandCB) &CGCodeParser::G050Command;	// not for a G5 with an error => G5PQ is from the last executed G5
+
+	if (!move.GetIJK())
+	{
+		offsetIJ[0] = -_modalstate.G5PQ[0];
+		offsetIJ[1] = -_modalstate.G5PQ[1];
+	}
+
+	_modalstate.G5PQ[0] = offsetPQ[0];
+	_modalstate.G5PQ[1] = offsetPQ[1];
+
+	mm1000_t control1[2] = { CMotionControlBase::GetInstance()->GetPosition(super::_modalstate.Plane_axis_0) + offsetIJ[0], CMotionControlBase::GetInstance()->GetPosition(super::_modalstate.Plane_axis_1) + offsetIJ[1] };
+	mm1000_t control2[2] = { move.newpos[super::_modalstate.Plane_axis_0] + offsetPQ[0], move.newpos[super::_modalstate.Plane_axis_1] + offsetPQ[1] };
+
+	MoveStart(true);
+	CMotionControlBase::GetInstance()->CubicBezier(move.newpos, control1, control2, super::_modalstate.Plane_axis_0, super::_modalstate.Plane_axis_1, super::_modalstate.G1FeedRate);
+	ConstantVelocity();
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParser::G051Command()
+{
+	// G5.1 X Y I J: quadratic spline
+	// I J: offset of the control point to the start point
+
+	super::_modalstate.LastCommand = (LastCommandCB) &CGCodeParser::G051Command;
+
+	SAxisMove move(true);
+	mm1000_t offsetIJ[2] = { 0, 0 };
+
+	for (char ch = _reader->SkipSpacesToUpper(); ch; ch = _reader->SkipSpacesToUpper())
+	{
+		axis_t axis;
+		if ((axis = CharToAxis(ch)) < NUM_AXIS)				GetAxis(axis, move, super::_modalstate.IsAbsolut ? AbsolutWithZeroShiftPosition : RelativPosition);
+		else if ((axis = CharToAxisOffset(ch)) < NUM_AXIS)	GetIJK(axis, move, offsetIJ);
+		else if (ch == 'F')									GetFeedrate(move);
+		else break;
+
+		if (CheckError()) { return; }
+	}
+
+	uint8_t planeIJ = (1 << super::_modalstate.Plane_axis_0) + (1 << super::_modalstate.Plane_axis_1);
+
+	if (move.GetIJK() != planeIJ)						{ Error(MESSAGE_GCODE_IandJExpected); return; }
+
+	mm1000_t control[2] = { CMotionControlBase::GetInstance()->GetPosition(super::_modalstate.Plane_axis_0) + offsetIJ[0], CMotionControlBase::GetInstance()->GetPosition(super::_modalstate.Plane_axis_1) + offsetIJ[1] };
+
+	MoveStart(true);
+	CMotionControlBase::GetInstance()->QuadraticBezier(move.newpos, control, super::_modalstate.Plane_axis_0, super::_modalstate.Plane_axis_1, super::_modalstate.G1FeedRate);
+	ConstantVelocity();
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParser::G10Command()
 {
 	uint8_t specified = 0;
@@ -913,6 +1623,7 @@ void CGCodeParser::G10Command()
 					_modalstate.G54Pospreset[p-1][axis] = move.newpos[axis];
 				}
 			}
+			PresetChanged();
 			break;
 		}
 	}
@@ -1042,6 +1753,7 @@ void CGCodeParser::G43Command()
 	{
 		_modalstate.ToolHeigtCompensation = 0;
 	}
+	PresetChanged();
 }
 
 ////////////////////////////////////////////////////////////
@@ -1282,6 +1994,7 @@ void CGCodeParser::G69Command()
 void CGCodeParser::G53Command()
 {
 	_modlessstate.ZeroPresetIdx = 0;
+	PresetChanged();
 }
 
 ////////////////////////////////////////////////////////////
@@ -1299,6 +2012,7 @@ void CGCodeParser::G5xCommand(uint8_t idx)
 	}
 
 	_modlessstate.ZeroPresetIdx = _modalstate.ZeroPresetIdx = idx;
+	PresetChanged();
 	CLcd::InvalidateLcd(); 
 }
 
@@ -1584,6 +2298,22 @@ void CGCodeParser::M114Command()
 	if (!ExpectEndOfCommand()) { return; }
 }
 
+////////////////////////////////////////////////////////////
+
+#ifdef _USE_BINARYGCODE
+
+void CGCodeParser::M130Command()
+{
+	// switch to binary frames (see CBinaryGCode) after this line, the host must wait for "ok"
+
+	if (!ExpectEndOfCommand()) { return; }
+
+	if (!CControl::GetInstance()->SetBinaryMode())
+		Error(MESSAGE_GCODE_BinaryModeSerialOnly);
+}
+
+#endif
+
 
 ////////////////////////////////////////////////////////////
 
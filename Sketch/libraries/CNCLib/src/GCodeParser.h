@@ -31,18 +31,30 @@ typedef unsigned short param_t;
 #define NUM_MAXPARAMNAMELENGTH 16
 #define NUM_PARAMETERRANGE	255
 
-#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(_MSC_VER)
+#if defined(__SAM3X8E__) || defined(__SAMD21G18A__) || defined(STEPPER_SIMULATION)
 
 #define NUM_PARAMETER	16		// slotcount, map from uint8_t to < NUM_PARAMETER
 #define G54ARRAYSIZE	6
+#define EXPRESSIONCACHE_SIZE	8
+#define OWORD_BUFFERSIZE	1024	// O-word sub and loop lines (without spaces and comments)
+#define OWORD_MAXSUB		8
 
 #else
 
 #define NUM_PARAMETER	8
 #define G54ARRAYSIZE	2
+#define EXPRESSIONCACHE_SIZE	4
+#define OWORD_BUFFERSIZE	256
+#define OWORD_MAXSUB		4
 
 #endif
 
+#define EXPRESSIONCACHE_TEXTLENGTH	32		// max length of the expression text (incl. '\0') to be cached
+#define EXPRESSIONCACHE_CODESIZE	32		// max size of the byte code
+
+#define OWORD_MAXLOOP		4		// nesting of while/repeat
+#define OWORD_MAXCALLDEPTH	4		// nesting of call (and executing a loop)
+
 
 // see: http://linuxcnc.org/docs/html/gcode/overview.html#_numbered_parameters_a_id_sub_numbered_parameters_a
 
@@ -94,15 +106,15 @@ public:
 
 	static mm1000_t GetG54PosPreset(axis_t axis);
 	static mm1000_t GetToolHeightPosPreset(axis_t axis)		{ return axis == super::_modalstate.Plane_axis_2 ? _modalstate.ToolHeigtCompensation : 0; }
-	static void SetG54PosPreset(axis_t axis, mm1000_t pos)	{ _modalstate.G54Pospreset[0][axis] = pos; }
+	static void SetG54PosPreset(axis_t axis, mm1000_t pos)	{ _modalstate.G54Pospreset[0][axis] = pos; PresetChanged(); }
 	static uint8_t GetZeroPresetIdx()					{ return _modalstate.ZeroPresetIdx; }
-	static void SetZeroPresetIdx(uint8_t idx)			{ _modalstate.ZeroPresetIdx = idx; }
+	static void SetZeroPresetIdx(uint8_t idx)			{ _modalstate.ZeroPresetIdx = idx; PresetChanged(); }
 
 	static bool IsG53Present()								{ return _modlessstate.ZeroPresetIdx == 0; }
 
 	static mm1000_t GetAllPreset(axis_t axis)				{ return GetG92PosPreset(axis) + GetG54PosPreset(axis) + GetToolHeightPosPreset(axis); }
 
-	static void Init()										{ super::Init(); _modalstate.Init(); _modlessstate.Init(); }
+	static void Init()										{ super::Init(); _modalstate.Init(); _modlessstate.Init(); _owordstate.Init(); }
 	static void InitAndSetFeedRate(feedrate_t feedrateG0, feedrate_t feedrateG1, feedrate_t feedrateG1max) { Init();  super::InitAndSetFeedRate(feedrateG0, feedrateG1, feedrateG1max); }
 
 protected:
@@ -119,6 +131,7 @@ protected:
 
 	void ToolSelectCommand();
 	void ParameterCommand();
+	void OWordCommand();
 
 	virtual void CommentMessage(char*) override;
 	virtual mm1000_t CalcAllPreset(axis_t axis) override;
@@ -153,6 +166,8 @@ protected:
 		mm1000_t		G8xR;
 		mm1000_t		G8xP;
 
+		mm1000_t		G5PQ[2];					// second control point of the last G5 (relative to its end point) => mirrored for the next G5 without I J
+
 		mm1000_t		G54Pospreset[G54ARRAYSIZE][NUM_AXIS];	// 54-59
 		mm1000_t		G38ProbePos[NUM_AXIS];
 		mm1000_t		ToolHeigtCompensation;
@@ -192,17 +207,81 @@ protected:
 
 	static SModelessState _modlessstate;
 
+	////////////////////////////////////////////////////////
+	// O-word (sub, while, repeat)
+	// all lines of a block are recorded (without spaces and comments) and executed from the buffer with the last line (e.g. endwhile)
+	// a sub is kept in the buffer (Buffer[0..SubEnd]) and executed with "call"
+
+	enum EOWord
+	{
+		NoOWord = 0,
+		SubOWord,
+		EndSubOWord,
+		CallOWord,
+		ReturnOWord,
+		WhileOWord,
+		EndWhileOWord,
+		RepeatOWord,
+		EndRepeatOWord
+	};
+
+	struct SOWordState
+	{
+		char			Buffer[OWORD_BUFFERSIZE];	// '\0' terminated lines
+
+		uint16_t		SubEnd;						// end of the subs in Buffer
+		uint16_t		RecordStart;				// first line of the recorded block
+		uint16_t		RecordEnd;
+		uint8_t			RecordNesting;				// != 0: record lines
+		bool			RecordDiscard;				// block does not fit in Buffer => discard the lines up to the end of the block
+
+		uint16_t		LinePC;						// executing line (index in Buffer)
+		uint16_t		PC;							// next line to execute
+		uint16_t		End;
+		uint8_t			CallDepth;					// != 0: execute from Buffer
+		uint8_t			LoopBase;					// first loop of the current call
+		uint8_t			LoopCount;
+
+		struct SLoop
+		{
+			uint16_t	PC;							// line of while/repeat
+			uint16_t	No;
+			uint16_t	Count;						// repeat
+		} Loop[OWORD_MAXLOOP];
+
+		struct SSub
+		{
+			uint16_t	No;
+			uint16_t	Start;						// line of "sub"
+			uint16_t	End;						// line of "endsub"
+		} Sub[OWORD_MAXSUB];
+
+		uint8_t			SubCount;
+
+		void Init()
+		{
+			SubEnd = RecordStart = RecordEnd = 0;
+			RecordNesting = CallDepth = LoopBase = LoopCount = SubCount = 0;
+			RecordDiscard = false;
+		}
+	};
+
+	static SOWordState _owordstate;
+
 	////////////////////////////////////////////////////////
 	// Parser structure
 
 	bool CutterRadiosIsOn()								    { if (_modalstate.CutterRadiusCompensation) { Info(MESSAGE_GCODE_G41G43AreNotAllowedWithThisCommand); return true; } else return false; }
 
 	virtual bool GetParamOrExpression(mm1000_t*, bool convertToInch) override;
+	bool ParseExpression(expr_t& answer);		// expression to the end of the buffer, byte code is cached
+	bool GetExpression(expr_t& answer);			// [expression]
 	mm1000_t ParseParameter(bool convertToInch);
 	param_t ParseParamNo();
 
 	mm1000_t GetParamValue(param_t paramNo, bool convertToInch);
 	void SetParamValue(param_t parmNo);
+	void SetModifyParamValue(param_t paramNo, expr_t value);	// #1..#255
 
 	static uint8_t ParamNoToParamIdx(param_t parmNo);
 
@@ -223,14 +302,18 @@ private:
 	void GetQ81(SAxisMove& move);
 	void GetL81(SAxisMove& move, uint8_t& l);
 	void GetAngleR(SAxisMove& move, mm1000_t& angle);		// get angle (with R Parameter)
+	void GetG5PQ(char ch, SAxisMove& move, mm1000_t offset[2]);
 
+	void G05Command();
+	void G050Command();		// Cubic spline
+	void G051Command();		// Quadratic spline
 	void G10Command();
 	void G38Command();
 	void G40Command()							{ _modalstate.CutterRadiusCompensation = SModalState::CutterRadiusOff; }
 	void G41Command();		// Cutter Radius Compensation left
 	void G42Command();		// Cutter Radius Compensation right
 	void G43Command();		// Tool Height Compensation 
-	void G49Command()							{ _modalstate.ToolHeigtCompensation = 0; }
+	void G49Command()							{ _modalstate.ToolHeigtCompensation = 0; PresetChanged(); }
 	void G53Command();
 	void G68Command();
 	void G68CommandDefault();
@@ -258,6 +341,9 @@ private:
 	void M110Command();
 	void M111Command();		// Set debug level
 	void M114Command();		// Report Position
+#ifdef _USE_BINARYGCODE
+	void M130Command();		// binary G0/G1 frames
+#endif
 
 	void M220Command();		// Set Speed override
 	void M300Command();		// Play Song
@@ -307,10 +393,41 @@ protected:
 	void PrintParam(const SParamInfo* item, axis_t axis);
 
 	static const struct SParamInfo _paramdef[] PROGMEM;
+	static uint8_t _paramdefhash[];				// hash of _paramdef[]._text, see FindParamInfoByText
+	static bool _paramdefhashvalid;
+
+	static uint8_t ParamTextHash(const char* text, bool isProgmem);
 
 	static const SParamInfo* FindParamInfo(uintptr_t param, bool(*check)(const SParamInfo*, uintptr_t param));
 	static const SParamInfo* FindParamInfoByText(const char* text);
 	static const SParamInfo* FindParamInfoByParamNo(param_t paramNo);
+
+private:
+
+	struct SExpressionCache
+	{
+		char	_text[EXPRESSIONCACHE_TEXTLENGTH];
+		uint8_t	_code[EXPRESSIONCACHE_CODESIZE];
+		uint8_t	_codesize;							// 0: unused
+		uint8_t	_age;								// LRU: 0 is the last used
+	};
+
+	static SExpressionCache _expressioncache[EXPRESSIONCACHE_SIZE];
+
+	static SExpressionCache* FindExpressionCache(const char* text);
+	static void AddExpressionCache(const char* text, const uint8_t* code, uint8_t codesize);
+
+	EOWord ParseOWord(uint16_t& no);
+	EOWord ParseOWordLine(const char* line, uint16_t& no);
+	EOWord ParseOWordLine(uint16_t pc, uint16_t& no)					{ return ParseOWordLine(&_owordstate.Buffer[pc], no); }
+	void OWordRecordLine(const char* line);
+	bool OWordAddLine(const char* line);
+	void OWordAddSub(uint16_t no, uint16_t endsub);
+	void OWordExecute(uint16_t start, uint16_t end);
+	void OWordCall(uint16_t no);
+	void OWordLoop(EOWord oword, uint16_t no);
+	void OWordSkipBlock(EOWord endoword, uint16_t no);
+	static uint16_t OWordNextLine(uint16_t pc)							{ return pc + (uint16_t) strlen(&_owordstate.Buffer[pc]) + 1; }
 };
 
 ////////////////////////////////////////////////////////
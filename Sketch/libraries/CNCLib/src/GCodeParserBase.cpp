@@ -30,7 +30,7 @@
 
 ////////////////////////////////////////////////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 bool CGCodeParserBase::_exit = false;
 
@@ -64,6 +64,9 @@ bool CGCodeParserBase::_exit = false;
 struct CGCodeParserBase::SModalState CGCodeParserBase::_modalstate;
 struct CGCodeParserBase::SModelessState CGCodeParserBase::_modlessstate;
 
+mm1000_t CGCodeParserBase::_preset[NUM_AXIS];
+bool CGCodeParserBase::_presetValid = false;
+
 ////////////////////////////////////////////////////////////
 
 bool CGCodeParserBase::Command(char /* ch */)
@@ -293,6 +296,17 @@ mm1000_t CGCodeParserBase::CalcAllPreset(axis_t axis)
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParserBase::CalcAllPresetCache()
+{
+	for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+	{
+		_preset[axis] = CalcAllPreset(axis);
+	}
+	_presetValid = true;
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParserBase::Parse()
 {
 #ifndef REDUCED_SIZE
@@ -357,8 +371,8 @@ void CGCodeParserBase::Parse()
 			}
 
 			default:
-#ifdef _MSC_VER
-				if (IsToken(F("X"), true, false)) { _exit = true; return; }
+#ifdef STEPPER_SIMULATION
+				if (ch == 'X' && IsToken(F("X"), true, false)) { _exit = true; return; }
 #endif
 				if (!Command(ch))
 				{
@@ -435,7 +449,7 @@ mm1000_t CGCodeParserBase::ParseCoordinate(axis_t axis, mm1000_t relpos, EnumAsB
 	switch (posType)
 	{
 		default:
-		case AbsolutWithZeroShiftPosition:	return mm + CalcAllPreset(axis);
+		case AbsolutWithZeroShiftPosition:	return mm + GetAllPresetCached(axis);
 		case AbsolutPosition:				return mm; 
 		case RelativPosition:				return relpos + mm;
 	}
@@ -597,6 +611,13 @@ void CGCodeParserBase::GetFeedrate(SAxisMove& move)
 
 	if (CheckError()) { return; }
 
+	SetG1FeedRateLimited(feedrate);
+}
+
+////////////////////////////////////////////////////////////
+
+void CGCodeParserBase::SetG1FeedRateLimited(feedrate_t feedrate)
+{
 	feedrate_t minfeedrate = FEEDRATE_MIN_ALLOWED;
 
 	if (feedrate < minfeedrate)				  feedrate = minfeedrate;
@@ -615,6 +636,7 @@ void CGCodeParserBase::GetG92Axis(axis_t axis, uint8_t& axes)
 	_reader->GetNextChar();
 	_modalstate.G92Pospreset[axis] = 0;	// clear this => can use CalcAllPreset
 	_modalstate.G92Pospreset[axis] = ParseCoordinateAxis(axis) + CMotionControlBase::GetInstance()->GetPosition(axis) - CalcAllPreset(axis);
+	PresetChanged();
 }
 
 ////////////////////////////////////////////////////////////
@@ -679,6 +701,47 @@ void CGCodeParserBase::G0001Command(bool isG00)
 
 ////////////////////////////////////////////////////////////
 
+#ifdef _USE_BINARYGCODE
+
+bool CGCodeParserBase::BinaryMoveCommand(const CBinaryGCode::SMove& binarymove)
+{
+	// same as G0001Command, the distance is relative to the current position => presets do not matter
+
+	CStepper::GetInstance()->ClearError();
+	CMotionControlBase::GetInstance()->ClearError();
+
+	bool isG00 = (binarymove.header & CBinaryGCode::CutMove) == 0;
+
+	_modalstate.LastCommand = isG00 ? &CGCodeParserBase::G00Command : &CGCodeParserBase::G01Command;
+
+	if (binarymove.header & CBinaryGCode::FeedRate)
+		SetG1FeedRateLimited(binarymove.feedrate);
+
+	SAxisMove move(true);
+
+	for (axis_t axis = 0; axis < NUM_AXIS && axis < CBinaryGCode::MaxAxis; axis++)
+	{
+		if (binarymove.header & (1 << axis))
+		{
+			move.newpos[axis] += binarymove.distance[axis];
+			move.axes |= 1 << axis;
+		}
+	}
+
+	if (move.axes)
+	{
+		MoveStart(!isG00);
+		CMotionControlBase::GetInstance()->MoveAbs(move.newpos, isG00 ? _modalstate.G0FeedRate : _modalstate.G1FeedRate);
+		ConstantVelocity();
+	}
+
+	return !CStepper::GetInstance()->IsError() && !CMotionControlBase::GetInstance()->IsError();
+}
+
+#endif
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParserBase::G0203Command(bool isG02)
 {
 	_modalstate.LastCommand = isG02 ? &CGCodeParserBase::G02Command : &CGCodeParserBase::G03Command;
@@ -775,11 +838,41 @@ void CGCodeParserBase::G04Command()
 
 ////////////////////////////////////////////////////////////
 
+void CGCodeParserBase::G64Command()
+{
+	// G64 P: corner tolerance => junction speed as arc within P (see CStepper::SMovement::CalcMaxJunktionSpeed)
+	// G64 without P: junction speed from jerk
+
+	_modalstate.ConstantVelocity = true;
+
+#ifndef REDUCED_SIZE
+	mm1000_t tolerance = 0;
+
+	if (_reader->SkipSpacesToUpper() == 'P')
+	{
+		_reader->GetNextChar();
+		tolerance = ParseCoordinateAxis(_modalstate.Plane_axis_0);
+		if (CheckError()) { return; }
+
+		if (tolerance < 0)
+		{
+			Error(MESSAGE(MESSAGE_PARSER_ValueLessThanMin));
+			return;
+		}
+	}
+
+	CMotionControlBase::GetInstance()->SetJunctionDeviation(tolerance);
+#endif
+}
+
+////////////////////////////////////////////////////////////
+
 void CGCodeParserBase::G171819Command(axis_t axis0, axis_t axis1, axis_t axis2)
 {
 	_modalstate.Plane_axis_0 = axis0;
 	_modalstate.Plane_axis_1 = axis1;
 	_modalstate.Plane_axis_2 = axis2;
+	PresetChanged();		// tool height
 }
 
 ////////////////////////////////////////////////////////////
@@ -915,6 +1008,7 @@ void CGCodeParserBase::G92Command()
 	if (axes == 0)
 	{
 		for (axes = 0; axes < NUM_AXIS; axes++) _modalstate.G92Pospreset[axes] = 0;
+		PresetChanged();
 	}
 
 	CLcd::InvalidateLcd(); 
@@ -997,5 +1091,9 @@ void CGCodeParserBase::PrintInfo()
 	PrintPosition([](axis_t axis) { return CMotionControlBase::GetInstance()->GetPosition(axis); });
 	StepperSerial.print(F("|WCO:"));
 	PrintPosition([](axis_t axis) { return GetG92PosPreset(axis); });
+	StepperSerial.print(F("|Bf:"));									// free movements (planner) and free chars of the receive buffer (character counting)
+	StepperSerial.print(MOVEMENTBUFFERSIZE - CStepper::GetInstance()->QueuedMovements());
+	StepperSerial.print(',');
+	StepperSerial.print(CControl::GetInstance()->GetBufferFree());
 	StepperSerial.print('>');
 }
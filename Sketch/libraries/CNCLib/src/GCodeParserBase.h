@@ -25,6 +25,7 @@
 #include "GCodeTools.h"
 #include "MotionControlBase.h"
 #include "Control.h"
+#include "BinaryGCode.h"
 
 ////////////////////////////////////////////////////////
 
@@ -75,11 +76,15 @@ public:
 	static bool IsCutMove()									{ return _modalstate.CutMove; }
 	static short GetSpindleSpeed()							{ return _modalstate.SpindleSpeed; }
 
-	static void Init()										{ super::Init(); _modalstate.Init();  _modlessstate.Init(); }
+	static void Init()										{ super::Init(); _modalstate.Init();  _modlessstate.Init(); PresetChanged(); ResetJunctionDeviation(); }
 
 	static void SetFeedRate(feedrate_t feedrateG0, feedrate_t feedrateG1, feedrate_t feedrateG1max) {	SetG0FeedRate(feedrateG0); SetG1FeedRate(feedrateG1); SetG1MaxFeedRate(feedrateG1max); }
 	static void InitAndSetFeedRate(feedrate_t feedrateG0, feedrate_t feedrateG1, feedrate_t feedrateG1max) { Init();  SetG0FeedRate(feedrateG0); SetG1FeedRate(feedrateG1); SetG1MaxFeedRate(feedrateG1max); }
 
+#ifdef _USE_BINARYGCODE
+	bool BinaryMoveCommand(const CBinaryGCode::SMove& binarymove);	// G0/G1 from a binary frame (no reader), see CControl (M130)
+#endif
+
 protected:
 
 	// overrides to exend parser
@@ -98,6 +103,19 @@ protected:
 	virtual mm1000_t CalcAllPreset(axis_t axis);
 	virtual void CommentMessage(char* )					{ };
 
+	// CalcAllPreset is cached for all axis, call PresetChanged if a preset (G92, G5x, G43, plane, ...) is modified
+
+	static void PresetChanged()								{ _presetValid = false; }
+	mm1000_t GetAllPresetCached(axis_t axis)				{ if (!_presetValid) CalcAllPresetCache(); return _preset[axis]; }
+
+	// G64 P is stored in the stepper => reset with G61 and Init (next program)
+
+#ifndef REDUCED_SIZE
+	static void ResetJunctionDeviation()					{ CStepper::GetInstance()->SetJunctionDeviation(0); }
+#else
+	static void ResetJunctionDeviation()					{ }
+#endif
+
 	bool IsCommentStart(char);
 
 protected:
@@ -182,6 +200,15 @@ protected:
 
 	static SModelessState _modlessstate;
 
+private:
+
+	static mm1000_t	_preset[NUM_AXIS];
+	static bool		_presetValid;
+
+	void CalcAllPresetCache();
+
+protected:
+
 	////////////////////////////////////////////////////////
 	// Parser structure
 
@@ -236,7 +263,7 @@ protected:
 	unsigned short GetUint16OrParam()						{ return (unsigned short)GetUint32OrParam(65535); };
 	uint8_t GetUint8OrParam()								{ return (uint8_t)GetUint32OrParam(255); };
 
-	mm1000_t GetRelativePosition(mm1000_t pos, axis_t axis)	{ return pos - CalcAllPreset(axis); }
+	mm1000_t GetRelativePosition(mm1000_t pos, axis_t axis)	{ return pos - GetAllPresetCached(axis); }
 	mm1000_t GetRelativePosition(axis_t axis)				{ return GetRelativePosition(CMotionControlBase::GetInstance()->GetPosition(axis), axis); }
 
 	bool CheckAxisSpecified(axis_t axis, uint8_t& axes);
@@ -258,6 +285,7 @@ protected:
 	void GetUint8(uint8_t& value, uint8_t&specified, uint8_t bit);
 
 	void GetFeedrate(SAxisMove& move);
+	void SetG1FeedRateLimited(feedrate_t feedrate);
 	void GetAxis(axis_t axis, SAxisMove& move, EnumAsByte(EAxisPosType) posType);
 
 	void InfoNotImplemented()					{ Info(MESSAGE_GCODE_NotImplemented); }
@@ -265,6 +293,7 @@ protected:
 	unsigned long GetDweel();
 
 	void GetRadius(SAxisMove& move, mm1000_t& radius);
+	void GetIJK(axis_t axis, SAxisMove& move, mm1000_t offset[2]);
 
 	void CallIOControl(uint8_t io, unsigned short value);
 	void SpindleSpeedCommand();
@@ -280,8 +309,6 @@ protected:
 
 private:
 
-	void GetIJK(axis_t axis, SAxisMove& move, mm1000_t offset[2]);
-
 	void GetG92Axis(axis_t axis, uint8_t& count);
 
 	static bool G31TestProbe(uintptr_t);
@@ -299,8 +326,8 @@ private:
 	void G20Command()							{ _modalstate.UnitisMm = false; };
 	void G21Command()							{ _modalstate.UnitisMm = true; };
 	void G28Command();
-	void G61Command()							{ _modalstate.ConstantVelocity = false; }
-	void G64Command()							{ _modalstate.ConstantVelocity = true; }
+	void G61Command()							{ _modalstate.ConstantVelocity = false; ResetJunctionDeviation(); }
+	void G64Command();
 	void G90Command()							{ _modalstate.IsAbsolut = true; }
 	void G91Command();
 	void G92Command();
@@ -323,7 +350,7 @@ private:
 
 	/////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 public:
 	static bool _exit;
 #endif
@@ -71,5 +71,27 @@ public:
 		dest[1] = src[1][0] * srcV[0] + src[1][1] * srcV[1] + src[1][2] * srcV[2];
 		dest[2] = src[2][0] * srcV[0] + src[2][1] * srcV[1] + src[2][2] * srcV[2];
 	}
+
+	static void Mul(const T src1[3][3], const T src2[3][3], T dest[3][3])
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			for (uint8_t j = 0; j < 3; j++)
+			{
+				dest[i][j] = src1[i][0] * src2[0][j] + src1[i][1] * src2[1][j] + src1[i][2] * src2[2][j];
+			}
+		}
+	}
+
+	static void SetIdentity(T dest[3][3])
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			for (uint8_t j = 0; j < 3; j++)
+			{
+				dest[i][j] = i == j ? 1 : 0;
+			}
+		}
+	}
 };
 
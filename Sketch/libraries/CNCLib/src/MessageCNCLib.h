@@ -95,6 +95,15 @@
 #define MESSAGE_GCODE_SExpected						StepperMessage("3D","S expected")
 #define MESSAGE_GCODE_IJKVECTORIS0					StepperMessage("3E","Vector IJK is 0")
 #define MESSAGE_GCODE_SPECIFIED						StepperMessage("3F","IJK is specified")
+#define MESSAGE_GCODE_PandQExpected					StepperMessage("40","P and Q expected")
+#define MESSAGE_GCODE_IandJExpected					StepperMessage("41","I and J expected")
+#define MESSAGE_GCODE_UnsupportedOWord				StepperMessage("42","unsupported O-word")
+#define MESSAGE_GCODE_OWordBufferFull				StepperMessage("43","O-word buffer full")
+#define MESSAGE_GCODE_OWordNoMatchingBlock			StepperMessage("44","no matching O-word block")
+#define MESSAGE_GCODE_OWordSubNotFound				StepperMessage("45","O-word sub not found")
+#define MESSAGE_GCODE_OWordNestingTooDeep			StepperMessage("46","O-word nesting too deep")
+#define MESSAGE_GCODE_OWordKilled					StepperMessage("47","O-word block aborted")
+#define MESSAGE_GCODE_BinaryModeSerialOnly			StepperMessage("48","M130: serial only, no file executing")
 
 ////////////////////////////////////////////////////////
 
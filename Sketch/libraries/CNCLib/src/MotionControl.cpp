@@ -50,8 +50,12 @@ void CMotionControl::SetRotate(float rad, const mm1000_t vect[NUM_AXISXYZ], cons
 		_rotateType = Rotate;
 		memcpy(_rotateOffset,ofs,sizeof(_rotateOffset));
 		memcpy(_vect,vect,sizeof(_vect));
+#ifdef STEPPER_SIMULATION
 		_rotate3D.Set(rad,vect);
+#endif
 	}
+
+	UpdateRotation();
 }
 
 /////////////////////////////////////////////////////////
@@ -78,6 +82,8 @@ void CMotionControl::SetRotate2D(axis_t axis, float rad)
 	{
 		BitClear(_rotateEnabled2D,axis);
 	}
+
+	UpdateRotation();
 }
 
 /////////////////////////////////////////////////////////
@@ -92,48 +98,87 @@ void CMotionControl::SetOffset2D(const mm1000_t ofs[NUM_AXISXYZ])
 	{
 		memset(_rotateOffset2D,0,sizeof(_rotateOffset2D));
 	}
-}
 
+	UpdateRotation();
+}
 
 /////////////////////////////////////////////////////////
 
-void CMotionControl::TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+void CMotionControl::UpdateRotation()
 {
-	super::TransformFromMachinePosition(src, dest);
-	
+	// combine the 3D rotation and the 2D rotations (X, then Y, then Z) to one matrix:
+	// dest = m2D*(m3D*(src-ofs3D) + ofs3D - ofs2D) + ofs2D
+
+	_rotationEnabled = _rotateType != NoRotate || _rotateEnabled2D != 0;
+
+	if (!_rotationEnabled)
+		return;
+
+	float m[NUM_AXISXYZ][NUM_AXISXYZ];
+	float ofs[NUM_AXISXYZ] = { 0.0, 0.0, 0.0 };
+
+	CMatrix3x3<float>::SetIdentity(m);
+
+	if (_rotateType != NoRotate)
+	{
+		SRotate3D rotate3D;
+		rotate3D.Set(_angle, _vect);
+		memcpy(m, rotate3D._vect, sizeof(m));
+
+		float ofs3D[NUM_AXISXYZ] = { (float)_rotateOffset[X_AXIS], (float)_rotateOffset[Y_AXIS], (float)_rotateOffset[Z_AXIS] };
+		CMatrix3x3<float>::Mul(m, ofs3D, ofs);
+
+		for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+			ofs[i] = ofs3D[i] - ofs[i];
+	}
+
 	if (_rotateEnabled2D)
 	{
-		float x = (float)(dest[X_AXIS] - _rotateOffset2D[X_AXIS]);
-		float y = (float)(dest[Y_AXIS] - _rotateOffset2D[Y_AXIS]);
-		float z = (float)(dest[Z_AXIS] - _rotateOffset2D[Z_AXIS]);
+		for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+			ofs[i] -= _rotateOffset2D[i];
 
-		if (IsBitSet(_rotateEnabled2D, Z_AXIS))
+		for (axis_t axis = 0; axis < NUM_AXISXYZ; axis++)
 		{
-			_rotate2D[Z_AXIS].RotateInvert(x, y);
-		}
-		if (IsBitSet(_rotateEnabled2D, Y_AXIS))
-		{
-			_rotate2D[Y_AXIS].RotateInvert(z, x);
-		}
-		if (IsBitSet(_rotateEnabled2D, X_AXIS))
-		{
-			_rotate2D[X_AXIS].RotateInvert(y, z);
+			if (IsBitSet(_rotateEnabled2D, axis))
+			{
+				// same as SRotate::Rotate(ax1, ax2): X => (Y,Z), Y => (Z,X), Z => (X,Y)
+				axis_t ax1 = (axis + 1) % NUM_AXISXYZ;
+				axis_t ax2 = (axis + 2) % NUM_AXISXYZ;
+
+				float rotate2D[NUM_AXISXYZ][NUM_AXISXYZ];
+				CMatrix3x3<float>::SetIdentity(rotate2D);
+				rotate2D[ax1][ax1] = _rotate2D[axis]._cos;
+				rotate2D[ax1][ax2] = -_rotate2D[axis]._sin;
+				rotate2D[ax2][ax1] = _rotate2D[axis]._sin;
+				rotate2D[ax2][ax2] = _rotate2D[axis]._cos;
+
+				float mPrev[NUM_AXISXYZ][NUM_AXISXYZ];
+				float ofsPrev[NUM_AXISXYZ];
+				memcpy(mPrev, m, sizeof(m));
+				memcpy(ofsPrev, ofs, sizeof(ofs));
+
+				CMatrix3x3<float>::Mul(rotate2D, mPrev, m);
+				CMatrix3x3<float>::Mul(rotate2D, ofsPrev, ofs);
+			}
 		}
 
-
-		dest[X_AXIS] = CMm1000::Cast(x) + _rotateOffset2D[X_AXIS];
-		dest[Y_AXIS] = CMm1000::Cast(y) + _rotateOffset2D[Y_AXIS];
-		dest[Z_AXIS] = CMm1000::Cast(z) + _rotateOffset2D[Z_AXIS];
+		for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+			ofs[i] += _rotateOffset2D[i];
 	}
 
-	if (_rotateType != NoRotate)
+	_rotation.Set(m, ofs);
+}
+
+
+/////////////////////////////////////////////////////////
+
+void CMotionControl::TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+{
+	super::TransformFromMachinePosition(src, dest);
+
+	if (_rotationEnabled)
 	{
-		if (_rotateType != RotateInvert)
-		{
-			_rotateType = RotateInvert;
-			_rotate3D.Set(-_angle,_vect);
-		}
-		_rotate3D.Rotate(dest,_rotateOffset,dest);
+		_rotation.RotateInvert(dest);
 	}
 }
 
@@ -144,42 +189,99 @@ bool CMotionControl::TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t de
 	if (!super::TransformPosition(src, dest))
 		return false;
 
-	if (_rotateType != NoRotate)
+	if (_rotationEnabled)
 	{
-		if (_rotateType != Rotate)
-		{
-			_rotateType = Rotate;
-			_rotate3D.Set(_angle,_vect);
-		}
-		
-		_rotate3D.Rotate(dest, _rotateOffset, dest);
+		_rotation.Rotate(dest);
 	}
 
-	if (_rotateEnabled2D)
+	return true;
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControl::SRotationFixedPoint::Set(const float m[NUM_AXISXYZ][NUM_AXISXYZ], const float ofs[NUM_AXISXYZ])
+{
+	for (axis_t i = 0; i < NUM_AXISXYZ; i++)
 	{
-		float x = (float)(dest[X_AXIS] - _rotateOffset2D[X_AXIS]);
-		float y = (float)(dest[Y_AXIS] - _rotateOffset2D[Y_AXIS]);
-		float z = (float)(dest[Z_AXIS] - _rotateOffset2D[Z_AXIS]);
-		
-		if (IsBitSet(_rotateEnabled2D, X_AXIS))
+		for (axis_t j = 0; j < NUM_AXISXYZ; j++)
 		{
-			_rotate2D[X_AXIS].Rotate(y, z);
-		}
-		if (IsBitSet(_rotateEnabled2D, Y_AXIS))
-		{
-			_rotate2D[Y_AXIS].Rotate(z, x);
-		}
-		if (IsBitSet(_rotateEnabled2D, Z_AXIS))
-		{
-			_rotate2D[Z_AXIS].Rotate(x, y);
+			_m[i][j] = lround(m[i][j] * (float)(1L << Shift));
 		}
+		_ofs[i] = lround(ofs[i]);
+	}
+}
 
-		dest[X_AXIS] = CMm1000::Cast(x) + _rotateOffset2D[X_AXIS];
-		dest[Y_AXIS] = CMm1000::Cast(y) + _rotateOffset2D[Y_AXIS];
-		dest[Z_AXIS] = CMm1000::Cast(z) + _rotateOffset2D[Z_AXIS];
+/////////////////////////////////////////////////////////
+
+void CMotionControl::SRotationFixedPoint::Rotate(mm1000_t dest[NUM_AXIS]) const
+{
+	mm1000_t x = dest[X_AXIS];
+	mm1000_t y = dest[Y_AXIS];
+	mm1000_t z = dest[Z_AXIS];
+
+	for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+	{
+		uint32_t fraction = 1UL << (Shift - 1);	// round
+		mm1000_t sum = MulShift(x, _m[i][0], fraction) + MulShift(y, _m[i][1], fraction) + MulShift(z, _m[i][2], fraction);
+		dest[i] = sum + (mm1000_t)(fraction >> Shift) + _ofs[i];
 	}
+}
 
-	return true;
+/////////////////////////////////////////////////////////
+
+void CMotionControl::SRotationFixedPoint::RotateInvert(mm1000_t dest[NUM_AXIS]) const
+{
+	mm1000_t x = dest[X_AXIS] - _ofs[X_AXIS];
+	mm1000_t y = dest[Y_AXIS] - _ofs[Y_AXIS];
+	mm1000_t z = dest[Z_AXIS] - _ofs[Z_AXIS];
+
+	for (axis_t i = 0; i < NUM_AXISXYZ; i++)
+	{
+		uint32_t fraction = 1UL << (Shift - 1);	// round
+		mm1000_t sum = MulShift(x, _m[0][i], fraction) + MulShift(y, _m[1][i], fraction) + MulShift(z, _m[2][i], fraction);
+		dest[i] = sum + (mm1000_t)(fraction >> Shift);
+	}
+}
+
+/////////////////////////////////////////////////////////
+
+mm1000_t CMotionControl::SRotationFixedPoint::MulShift(mm1000_t x, long m, uint32_t& fraction)
+{
+	// the sum of 3 fractions (and the round) fits in 32 bit => the result is the same as a 64 bit sum of the products
+
+#if defined(__AVR_ARCH__) || defined(STEPPER_SIMULATION)
+
+	// AVR has no 32x32=>64 multiply (int64_t is a library call) => 4 multiplies 16x16=>32, hi:lo is the 64 bit product
+
+	bool negativ = (x < 0) != (m < 0);
+	uint32_t a = x < 0 ? 0 - (uint32_t)x : (uint32_t)x;
+	uint32_t b = m < 0 ? 0 - (uint32_t)m : (uint32_t)m;
+
+	uint32_t ll = (uint32_t)(uint16_t)a * (uint16_t)b;
+	uint32_t lh = (uint32_t)(uint16_t)a * (uint16_t)(b >> 16);
+	uint32_t hl = (uint32_t)(uint16_t)(a >> 16) * (uint16_t)b;
+	uint32_t hh = (uint32_t)(uint16_t)(a >> 16) * (uint16_t)(b >> 16);
+
+	uint32_t mid = (ll >> 16) + (lh & 0xffff) + (hl & 0xffff);
+	uint32_t lo = (mid << 16) | (ll & 0xffff);
+	uint32_t hi = hh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+
+	if (negativ)
+	{
+		lo = 0 - lo;
+		hi = ~hi + (lo == 0 ? 1 : 0);
+	}
+
+	fraction += lo & ((1UL << Shift) - 1);
+	return (mm1000_t)(int32_t)((hi << (32 - Shift)) | (lo >> Shift));
+
+#else
+
+	int64_t product = (int64_t)x*m;
+	fraction += (uint32_t)product & ((1UL << Shift) - 1);
+	return (mm1000_t)(product >> Shift);
+
+#endif
 }
 
 /////////////////////////////////////////////////////////
@@ -241,7 +343,94 @@ void CMotionControl::SRotate3D::Rotate(const mm1000_t src[NUM_AXIS], const mm100
 
 /////////////////////////////////////////////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
+
+void CMotionControl::TransformFromMachinePositionFloat(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+{
+	super::TransformFromMachinePosition(src, dest);
+	
+	if (_rotateEnabled2D)
+	{
+		float x = (float)(dest[X_AXIS] - _rotateOffset2D[X_AXIS]);
+		float y = (float)(dest[Y_AXIS] - _rotateOffset2D[Y_AXIS]);
+		float z = (float)(dest[Z_AXIS] - _rotateOffset2D[Z_AXIS]);
+
+		if (IsBitSet(_rotateEnabled2D, Z_AXIS))
+		{
+			_rotate2D[Z_AXIS].RotateInvert(x, y);
+		}
+		if (IsBitSet(_rotateEnabled2D, Y_AXIS))
+		{
+			_rotate2D[Y_AXIS].RotateInvert(z, x);
+		}
+		if (IsBitSet(_rotateEnabled2D, X_AXIS))
+		{
+			_rotate2D[X_AXIS].RotateInvert(y, z);
+		}
+
+
+		dest[X_AXIS] = CMm1000::Cast(x) + _rotateOffset2D[X_AXIS];
+		dest[Y_AXIS] = CMm1000::Cast(y) + _rotateOffset2D[Y_AXIS];
+		dest[Z_AXIS] = CMm1000::Cast(z) + _rotateOffset2D[Z_AXIS];
+	}
+
+	if (_rotateType != NoRotate)
+	{
+		if (_rotateType != RotateInvert)
+		{
+			_rotateType = RotateInvert;
+			_rotate3D.Set(-_angle,_vect);
+		}
+		_rotate3D.Rotate(dest,_rotateOffset,dest);
+	}
+}
+
+/////////////////////////////////////////////////////////
+
+bool CMotionControl::TransformPositionFloat(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS])
+{
+	if (!super::TransformPosition(src, dest))
+		return false;
+
+	if (_rotateType != NoRotate)
+	{
+		if (_rotateType != Rotate)
+		{
+			_rotateType = Rotate;
+			_rotate3D.Set(_angle,_vect);
+		}
+		
+		_rotate3D.Rotate(dest, _rotateOffset, dest);
+	}
+
+	if (_rotateEnabled2D)
+	{
+		float x = (float)(dest[X_AXIS] - _rotateOffset2D[X_AXIS]);
+		float y = (float)(dest[Y_AXIS] - _rotateOffset2D[Y_AXIS]);
+		float z = (float)(dest[Z_AXIS] - _rotateOffset2D[Z_AXIS]);
+		
+		if (IsBitSet(_rotateEnabled2D, X_AXIS))
+		{
+			_rotate2D[X_AXIS].Rotate(y, z);
+		}
+		if (IsBitSet(_rotateEnabled2D, Y_AXIS))
+		{
+			_rotate2D[Y_AXIS].Rotate(z, x);
+		}
+		if (IsBitSet(_rotateEnabled2D, Z_AXIS))
+		{
+			_rotate2D[Z_AXIS].Rotate(x, y);
+		}
+
+		dest[X_AXIS] = CMm1000::Cast(x) + _rotateOffset2D[X_AXIS];
+		dest[Y_AXIS] = CMm1000::Cast(y) + _rotateOffset2D[Y_AXIS];
+		dest[Z_AXIS] = CMm1000::Cast(z) + _rotateOffset2D[Z_AXIS];
+	}
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////
 
 void CMotionControl::UnitTest()
 {
@@ -289,6 +478,45 @@ void CMotionControl::UnitTest()
 
 	CMatrix4x4<float>::Mul(A1, ps, pd);
 
+	// 3d and 2D Test
+
+	TestFixedPoint(true);
+
+#endif
+}
+
+inline bool CompareMaxDiff(mm1000_t a, mm1000_t b, mm1000_t diff = 3) { return  (abs(a - b) >= diff); }
+
+bool CMotionControl::TestMulShift()
+{
+	// same result as the int64_t multiply (the 16x16 path of AVR), for all signs and the max values of Q30
+
+	const long values[] = { 0, 1, -1, 1000, -1000, 0xffff, 0x10000, -0x10000, 123456789, -987654321, 0x7fffffff, -0x7fffffff, 1L << SRotationFixedPoint::Shift, -(1L << SRotationFixedPoint::Shift) };
+
+	for (long x : values)
+	{
+		for (long m : values)
+		{
+			int64_t product = (int64_t)x*m;
+			if ((product >> SRotationFixedPoint::Shift) > 0x7fffffff || (product >> SRotationFixedPoint::Shift) < -0x7fffffff)
+				continue;	// result does not fit in mm1000_t (32 bit)
+
+			uint32_t fraction = 0;
+			mm1000_t result = SRotationFixedPoint::MulShift(x, m, fraction);
+
+			if (result != (mm1000_t)(product >> SRotationFixedPoint::Shift) || fraction != ((uint32_t)product & ((1UL << SRotationFixedPoint::Shift) - 1)))
+				return false;
+		}
+	}
+	return true;
+}
+
+mm1000_t CMotionControl::TestFixedPoint(bool printOK)
+{
+	InitConversion(ToMm1000_1_1000, ToMachine_1_1000);
+
+	_maxDiffFloat = 0;
+
 	// 3d Test
 
 	mm1000_t ofs[3] = { 1000,2000,71000 };
@@ -312,45 +540,45 @@ void CMotionControl::UnitTest()
 	float angle=(float)(M_PI/6);
 	//angle=0.001;
 
-	Test3D(srcX,ofs,dest,vectX,angle,true);
-	Test3D(srcX,ofs,dest,vectY,angle,true);
-	Test3D(srcX,ofs,dest,vectZ,angle,true);
+	Test3D(srcX,ofs,dest,vectX,angle,printOK);
+	Test3D(srcX,ofs,dest,vectY,angle,printOK);
+	Test3D(srcX,ofs,dest,vectZ,angle,printOK);
 
-	Test3D(srcX,ofs,dest,vectXY,angle,true);
-	Test3D(srcX,ofs,dest,vectXZ,angle,true);
-	Test3D(srcX,ofs,dest,vectYZ,angle,true);
+	Test3D(srcX,ofs,dest,vectXY,angle,printOK);
+	Test3D(srcX,ofs,dest,vectXZ,angle,printOK);
+	Test3D(srcX,ofs,dest,vectYZ,angle,printOK);
 
-	Test3D(srcX,ofs,dest,vectXYZ,angle,true);
+	Test3D(srcX,ofs,dest,vectXYZ,angle,printOK);
 
-	Test3D(srcY,ofs,dest,vectX,angle,true);
-	Test3D(srcY,ofs,dest,vectY,angle,true);
-	Test3D(srcY,ofs,dest,vectZ,angle,true);
+	Test3D(srcY,ofs,dest,vectX,angle,printOK);
+	Test3D(srcY,ofs,dest,vectY,angle,printOK);
+	Test3D(srcY,ofs,dest,vectZ,angle,printOK);
 			
-	Test3D(srcY,ofs,dest,vectXY,angle,true);
-	Test3D(srcY,ofs,dest,vectXZ,angle,true);
-	Test3D(srcY,ofs,dest,vectYZ,angle,true);
+	Test3D(srcY,ofs,dest,vectXY,angle,printOK);
+	Test3D(srcY,ofs,dest,vectXZ,angle,printOK);
+	Test3D(srcY,ofs,dest,vectYZ,angle,printOK);
 			
-	Test3D(srcY,ofs,dest,vectXYZ,angle,true);
+	Test3D(srcY,ofs,dest,vectXYZ,angle,printOK);
 
-	Test3D(srcZ,ofs,dest,vectX,angle,true);
-	Test3D(srcZ,ofs,dest,vectY,angle,true);
-	Test3D(srcZ,ofs,dest,vectZ,angle,true);
+	Test3D(srcZ,ofs,dest,vectX,angle,printOK);
+	Test3D(srcZ,ofs,dest,vectY,angle,printOK);
+	Test3D(srcZ,ofs,dest,vectZ,angle,printOK);
 			
-	Test3D(srcZ,ofs,dest,vectXY,angle,true);
-	Test3D(srcZ,ofs,dest,vectXZ,angle,true);
-	Test3D(srcZ,ofs,dest,vectYZ,angle,true);
+	Test3D(srcZ,ofs,dest,vectXY,angle,printOK);
+	Test3D(srcZ,ofs,dest,vectXZ,angle,printOK);
+	Test3D(srcZ,ofs,dest,vectYZ,angle,printOK);
 			
-	Test3D(srcZ,ofs,dest,vectXYZ,angle,true);
+	Test3D(srcZ,ofs,dest,vectXYZ,angle,printOK);
 
-	Test3D(srcXY,ofs,dest,vectX,angle,true);
-	Test3D(srcXY,ofs,dest,vectY,angle,true);
-	Test3D(srcXY,ofs,dest,vectZ,angle,true);
+	Test3D(srcXY,ofs,dest,vectX,angle,printOK);
+	Test3D(srcXY,ofs,dest,vectY,angle,printOK);
+	Test3D(srcXY,ofs,dest,vectZ,angle,printOK);
 			
-	Test3D(srcXY,ofs,dest,vectXY,angle,true);
-	Test3D(srcXY,ofs,dest,vectXZ,angle,true);
-	Test3D(srcXY,ofs,dest,vectYZ,angle,true);
+	Test3D(srcXY,ofs,dest,vectXY,angle,printOK);
+	Test3D(srcXY,ofs,dest,vectXZ,angle,printOK);
+	Test3D(srcXY,ofs,dest,vectYZ,angle,printOK);
 			
-	Test3D(srcXY,ofs,dest,vectXYZ,angle,true);
+	Test3D(srcXY,ofs,dest,vectXYZ,angle,printOK);
 
 	ClearRotate();
 
@@ -361,25 +589,24 @@ void CMotionControl::UnitTest()
 	float angle2dZ[3]={ 0,0, angle };
 	float angle2d[3]={ angle,angle, angle };
 
-	Test2D(srcXY,ofs,dest,angle2dX,true);
-	Test2D(srcXY,ofs,dest,angle2dY,true);
-	Test2D(srcXY,ofs,dest,angle2dZ,true);
+	Test2D(srcXY,ofs,dest,angle2dX,printOK);
+	Test2D(srcXY,ofs,dest,angle2dY,printOK);
+	Test2D(srcXY,ofs,dest,angle2dZ,printOK);
 
-	Test2D(srcXY,ofs,dest,angle2d,true);
+	Test2D(srcXY,ofs,dest,angle2d,printOK);
 
 	//2d+3D
 
 	SetRotate(angle,vectXYZ,ofs);
-	Test2D(srcXY,ofs,dest,angle2d,true);
+	Test2D(srcXY,ofs,dest,angle2d,printOK);
+
 
 	ClearRotate2D();
 	ClearRotate();
 
-#endif
+	return _maxDiffFloat;
 }
 
-inline bool CompareMaxDiff(mm1000_t a, mm1000_t b, mm1000_t diff = 3) { return  (abs(a - b) >= diff); }
-
 bool CMotionControl::Test3D(const mm1000_t src[NUM_AXIS],const mm1000_t ofs[NUM_AXIS],mm1000_t dest[NUM_AXIS], mm1000_t vect[NUM_AXIS], float angle, bool printOK)
 {
 	SetRotate(angle,vect,ofs);
@@ -404,25 +631,39 @@ bool CMotionControl::Test(const mm1000_t src[NUM_AXIS],const mm1000_t ofs[NUM_AX
 {
 	udist_t	to_m[NUM_AXIS];
 	mm1000_t toorig[NUM_AXIS];
+	mm1000_t destFloat[NUM_AXIS];
+	mm1000_t toorigFloat[NUM_AXIS];
 
 	memcpy(dest,src,sizeof(toorig));
+	memcpy(destFloat,src,sizeof(toorig));
 
 	bool isError = false;
+	mm1000_t maxDiff = 0;
 
-	if (TransformPosition(src,dest))
+	if (TransformPosition(src,dest) && TransformPositionFloat(src,destFloat))
 	{
 		ToMachine(dest, to_m);
 
 		TransformFromMachinePosition(to_m,toorig);
+		TransformFromMachinePositionFloat(to_m,toorigFloat);
 
-		for (uint8_t i = 0; i < NUM_AXIS && !isError; i++)
-			isError = CompareMaxDiff(src[i], toorig[i]);
+		for (uint8_t i = 0; i < NUM_AXIS; i++)
+		{
+			isError = isError || CompareMaxDiff(src[i], toorig[i]);
+
+			// accuracy of the fixed point path (_rotation) against the float path
+			maxDiff = max(maxDiff, (mm1000_t) abs(dest[i] - destFloat[i]));
+			maxDiff = max(maxDiff, (mm1000_t) abs(toorig[i] - toorigFloat[i]));
+		}
+		isError = isError || CompareMaxDiff(maxDiff, 0);
 	}
 	else
 	{
 		isError = true;
 	}
 
+	_maxDiffFloat = max(_maxDiffFloat, maxDiff);
+
 	if (printOK || isError)
 	{
 		DumpArray<mm1000_t, NUM_AXIS>(F("Src"), src, false);
@@ -430,6 +671,7 @@ bool CMotionControl::Test(const mm1000_t src[NUM_AXIS],const mm1000_t ofs[NUM_AX
 		print();
 		DumpArray<mm1000_t, NUM_AXIS>(F(" =>"), dest, false);
 		DumpArray<mm1000_t, NUM_AXIS>(F("Back"), toorig, false);
+		DumpType<mm1000_t>(F("DiffFloat"), maxDiff, false);
 
 		if (isError)
 			printf(" ERROR");
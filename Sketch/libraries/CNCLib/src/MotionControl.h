@@ -41,7 +41,7 @@ public:
 	CMotionControl();
 
 	void SetRotate(float rad, const mm1000_t vect[NUM_AXISXYZ], const mm1000_t ofs[NUM_AXISXYZ]);
-	void ClearRotate()												{ _rotateType = NoRotate; }
+	void ClearRotate()												{ _rotateType = NoRotate; UpdateRotation(); }
 	bool IsRotate()													{ return _rotateType != NoRotate; }
 	mm1000_t GetOffset(axis_t axis)									{ return _rotateOffset[axis]; }
 	mm1000_t GetVector(axis_t axis)									{ return _vect[axis]; }
@@ -53,7 +53,7 @@ public:
 	mm1000_t GetOffset2D(axis_t axis)								{ return _rotateOffset2D[axis]; }
 	float GetAngle2D(axis_t axis)									{ return _rotate2D[axis].GetAngle(); }
 	bool IsEnabled2D(axis_t axis)									{ return IsBitSet(_rotateEnabled2D,axis); }
-	void ClearRotate2D()											{ _rotateEnabled2D=0; }
+	void ClearRotate2D()											{ _rotateEnabled2D=0; UpdateRotation(); }
 
 	static CMotionControl* GetInstance()							{ return (CMotionControl*) CMotionControlBase::GetInstance(); } 
 
@@ -61,6 +61,7 @@ protected:
 
 	virtual void TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
 	virtual bool TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override;
+	virtual bool CanMoveArc() override								{ return !_rotationEnabled; }
 
 private:
 
@@ -76,7 +77,6 @@ private:
 		void Rotate(const mm1000_t src[NUM_AXIS], const mm1000_t ofs[NUM_AXISXYZ], mm1000_t dest[NUM_AXIS]);
 	};
 
-	SRotate3D	_rotate3D;
 	mm1000_t	_rotateOffset[NUM_AXISXYZ];
 
 	enum ERotateType
@@ -129,10 +129,46 @@ private:
 
 	axisArray_t _rotateEnabled2D=0;
 
-#ifdef _MSC_VER
+private:
+
+	struct SRotationFixedPoint	// 3D and all 2D rotations in one matrix: dest = m*src + ofs (integer math)
+	{
+		enum { Shift = 30 };	// fixed point of _m: 1.0 == 1<<30
+
+		long	 _m[NUM_AXISXYZ][NUM_AXISXYZ];
+		mm1000_t _ofs[NUM_AXISXYZ];
+
+		void Set(const float m[NUM_AXISXYZ][NUM_AXISXYZ], const float ofs[NUM_AXISXYZ]);
+
+		void Rotate(mm1000_t dest[NUM_AXIS]) const;
+		void RotateInvert(mm1000_t dest[NUM_AXIS]) const;	// _m is a rotation => invert is transposed
+
+		static mm1000_t MulShift(mm1000_t x, long m, uint32_t& fraction);	// x*m >> Shift, add the shifted out bits to fraction
+	};
+
+	SRotationFixedPoint _rotation;
+	bool _rotationEnabled=false;
+
+	void UpdateRotation();
+
+#ifdef STEPPER_SIMULATION
+
+private:
+
+	// float path (before SRotationFixedPoint) => reference for UnitTest
+
+	SRotate3D	_rotate3D;
+
+	void TransformFromMachinePositionFloat(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
+	bool TransformPositionFloat(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
+
+	mm1000_t _maxDiffFloat;
 
 public:
 
+	mm1000_t TestFixedPoint(bool printOK);		// accuracy of fixed point against float path, return max diff
+	static bool TestMulShift();					// SRotationFixedPoint::MulShift against int64_t
+
 	virtual void UnitTest() override;
 	bool Test3D(const mm1000_t src[NUM_AXIS], const mm1000_t ofs[NUM_AXISXYZ],mm1000_t dest[NUM_AXIS], mm1000_t vect[NUM_AXISXYZ], float angle, bool pintOK);
 	bool Test2D(const mm1000_t src[NUM_AXIS], const mm1000_t ofs[NUM_AXISXYZ],mm1000_t dest[NUM_AXIS], float angle[NUM_AXISXYZ], bool pintOK);
@@ -27,7 +27,7 @@
 #include "CNCLib.h"
 #include "MotionControlBase.h"
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #include "Control.h"
 #endif
 
@@ -35,6 +35,7 @@
 
 ToMm1000_t CMotionControlBase::_ToMm1000;
 ToMachine_t CMotionControlBase::_ToMachine;
+CMotionControlBase::SFeedRateToStepRate CMotionControlBase::_feedRateToStepRate[NUM_AXIS];
 
 /////////////////////////////////////////////////////////
 
@@ -90,32 +91,172 @@ void CMotionControlBase::MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrat
 	// the ONLY methode to move!!!!!
 	// do not call Stepper direct
 
-#ifdef _MSC_VER
-	CStepper::GetInstance()->MSCInfo = CControl::GetInstance()->GetBuffer();
-#endif
-
 	mm1000_t	to_proj[NUM_AXIS];
-	udist_t		to_m[NUM_AXIS];
 
 	memcpy(to_proj, to, sizeof(_current));
 
 	if (TransformPosition(to, to_proj))
 	{
-		ToMachine(to_proj, to_m);
-
-		CStepper::GetInstance()->MoveAbs(to_m, GetFeedRate(to_proj, feedrate));
-
-		if (CStepper::GetInstance()->IsError())
+#ifndef REDUCED_SIZE
+		if (GetMaxSegmentLength() != 0)
 		{
-			SetPositionFromMachine();
+			MoveAbsSegments(to, to_proj, feedrate);
+			return;
 		}
-		else
+#endif
+		MoveAbsTransformed(to, to_proj, feedrate);
+	}
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::MoveAbsTransformed(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate)
+{
+	udist_t		to_m[NUM_AXIS];
+
+	ToMachine(to_proj, to_m);
+	MoveAbsMachine(to, to_m, GetFeedRate(to_proj, feedrate));
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::MoveAbsMachine(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], steprate_t steprate)
+{
+#ifdef STEPPER_SIMULATION
+	CStepper::GetInstance()->MSCInfo = CControl::GetInstance()->GetBuffer();
+#endif
+
+	CStepper::GetInstance()->MoveAbs(to_m, steprate);
+
+	if (CStepper::GetInstance()->IsError())
+	{
+		SetPositionFromMachine();
+	}
+	else
+	{
+		memcpy(_current, to, sizeof(_current));
+	}
+}
+
+/////////////////////////////////////////////////////////
+
+#ifndef REDUCED_SIZE
+
+void CMotionControlBase::MoveAbsSegments(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate)
+{
+	// TransformPosition is not linear (e.g. robot arm) => split the line in segments
+	// the length of a segment adapts to the deviation of the transformed midpoint from the middle of the transformed end points
+	// => long segments where the kinematics is (almost) linear, short segments only where it bends the line
+	//
+	// the transformed end of a segment is used for the move and is the start of the next segment
+	// => the start is transformed once per line, each segment needs the end and the midpoint
+
+	mm1000_t start[NUM_AXIS];
+	mm1000_t from[NUM_AXIS];
+	mm1000_t from_proj[NUM_AXIS];
+	mm1000_t next[NUM_AXIS];
+	mm1000_t next_proj[NUM_AXIS];
+
+	GetPositions(start);
+	memcpy(from, start, sizeof(_current));
+	memcpy(from_proj, start, sizeof(_current));
+
+	if (!TransformPosition(from, from_proj))
+		return;
+
+	mm1000_t maxdist = 0;
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		mm1000_t dist = abs(to[x] - start[x]);
+		if (dist > maxdist)
+			maxdist = dist;
+	}
+
+	// see GetArcSegments: the planner must keep up
+
+	mm1000_t maxlength = GetMaxSegmentLength();
+	mm1000_t minlength = max(mm1000_t(1), mm1000_t(abs(feedrate) * (ARC_MINSEGMENTTIME / 60000000.0f)));
+	mm1000_t tolerance = GetSegmentTolerance();
+
+	mm1000_t pos = 0;						// position on the line (of the axis with the longest distance)
+	mm1000_t length = maxlength;
+
+	do
+	{
+		// start with the double of the last segment, halve until the deviation is ok
+
+		length = min(length * 2, maxlength);
+
+		while (true)
 		{
-			memcpy(_current, to, sizeof(_current));
+			if (pos + length >= maxdist)
+			{
+				length = maxdist - pos;
+				memcpy(next, to, sizeof(_current));
+				memcpy(next_proj, to_proj, sizeof(_current));
+			}
+			else
+			{
+				for (axis_t x = 0; x < NUM_AXIS; x++)
+					next[x] = start[x] + RoundMulDivI32(to[x] - start[x], pos + length, maxdist);
+
+				memcpy(next_proj, next, sizeof(_current));
+				if (!TransformPosition(next, next_proj))
+					return;
+			}
+
+			mm1000_t deviation = SegmentDeviation(from, from_proj, next, next_proj);
+			if (deviation < 0)
+				return;
+
+			if (deviation <= tolerance || length <= minlength)
+				break;
+
+			length = max(length / 2, minlength);
 		}
+
+		pos += length;
+
+		MoveAbsTransformed(next, next_proj, feedrate);
+		if (IsError()) return;
+
+		memcpy(from, next, sizeof(_current));
+		memcpy(from_proj, next_proj, sizeof(_current));
+	}
+	while (pos < maxdist);
+}
+
+/////////////////////////////////////////////////////////
+
+mm1000_t CMotionControlBase::SegmentDeviation(const mm1000_t from[NUM_AXIS], const mm1000_t from_proj[NUM_AXIS], const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS])
+{
+	// max deviation (of all axis) of the transformed midpoint, < 0 if TransformPosition fails
+
+	mm1000_t mid[NUM_AXIS];
+	mm1000_t mid_proj[NUM_AXIS];
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+		mid[x] = from[x] + (to[x] - from[x]) / 2;
+
+	memcpy(mid_proj, mid, sizeof(_current));
+	if (!TransformPosition(mid, mid_proj))
+		return -1;
+
+	mm1000_t deviation = 0;
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		mm1000_t dist = abs(mid_proj[x] - (from_proj[x] + (to_proj[x] - from_proj[x]) / 2));
+		if (dist > deviation)
+			deviation = dist;
 	}
+
+	return deviation;
 }
 
+#endif
+
 /////////////////////////////////////////////////////////
 // based on:
 //	motion_control.c - high level interface for issuing motion commands
@@ -201,11 +342,27 @@ void CMotionControlBase::Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm10
 		return;
 	}
 
+#ifdef USE_ARCMOVE
+	if (MoveArc(to, center_axis0, center_axis1, axis_0, axis_1, isclockwise, radius, angular_travel, feedrate))
+	{
+		return;
+	}
+#endif
+
 	// difference to Grbl => use dynamic calculation of segements => suitable for small r
 	//
 	// segments for full circle => (CONST_K * r * M_PI * b + CONST_D)		(r in mm, b ...2?)
 
-	unsigned short segments = (unsigned short) abs(floor((CMm1000::ConvertTo((const mm1000_t) (2 * SEGMENTS_K*M_PI))*radius + SEGMENTS_D) * angular_travel / (2.0*M_PI)));
+	unsigned short segments;
+	
+	if (_arcChordTolerance != 0)
+	{
+		segments = GetArcSegments(radius, angular_travel, feedrate);
+	}
+	else
+	{
+		segments = (unsigned short) abs(floor((CMm1000::ConvertTo((const mm1000_t) (2 * SEGMENTS_K*M_PI))*radius + SEGMENTS_D) * angular_travel / (2.0*M_PI)));
+	}
 
 #if defined(_MSC_VER)
 	double segments_full = CMm1000::ConvertTo((const mm1000_t)(2 * SEGMENTS_K*M_PI))*radius + SEGMENTS_D;
@@ -274,79 +431,322 @@ void CMotionControlBase::Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm10
 
 /////////////////////////////////////////////////////////
 
+#ifdef USE_ARCMOVE
+
+bool CMotionControlBase::MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t center_axis0, mm1000_t center_axis1, axis_t axis_0, axis_t axis_1, bool isclockwise, float radius, float angular_travel, feedrate_t feedrate)
+{
+	// arc as one movement (circular interpolation of the stepper)
+	// return false if not possible => line segments
+
+	if (!CanMoveArc() || ToMachine(axis_0, 1000000) != ToMachine(axis_1, 1000000))
+		return false;								// transformed or different steps/mm
+
+	// the stepper rounds start and end to steps => start == end is a full circle
+
+	float radius_m = (float) ToMachine(axis_0, (mm1000_t) radius);
+	float travel = fabs(angular_travel);
+
+	if (travel < float(2.0 * M_PI) && min(travel, float(2.0 * M_PI) - travel) * radius_m < 4.0f)
+		return false;
+
+#ifdef STEPPER_SIMULATION
+	CStepper::GetInstance()->MSCInfo = CControl::GetInstance()->GetBuffer();
+#endif
+
+	udist_t to_m[NUM_AXIS];
+	ToMachine(to, to_m);
+
+	if (!CStepper::GetInstance()->MoveArc(to_m, ToMachine(axis_0, center_axis0), ToMachine(axis_1, center_axis1), axis_0, axis_1, isclockwise, FeedRateToStepRate(axis_0, feedrate)))
+		return false;
+
+	if (CStepper::GetInstance()->IsError())
+	{
+		SetPositionFromMachine();
+	}
+	else
+	{
+		memcpy(_current, to, sizeof(_current));
+	}
+
+	return true;
+}
+
+#endif
+
+/////////////////////////////////////////////////////////
+
+unsigned short CMotionControlBase::GetArcSegments(float radius, float angular_travel, feedrate_t feedrate)
+{
+	// segment length from max chord deviation e: e = r*(1-cos(theta/2)) => theta = sqrt(8*e/r) (small angle, a little too small => safe)
+
+	float theta_per_segment = float(M_PI / 4.0);
+	if (radius > _arcChordTolerance)
+	{
+		theta_per_segment = min(theta_per_segment, sqrt(8.0f * _arcChordTolerance / radius));
+	}
+	float segment_length = theta_per_segment * radius;
+
+	// the planner must keep up: a segment must not be faster than QueueMove and OptimizeMovementQueue (depends on the look-ahead depth)
+	// feedrate in mm1000/min, ARC_MINSEGMENTTIME in us
+
+	float min_length = abs(feedrate) * (ARC_MINSEGMENTTIME / 60000000.0f);
+
+	if (segment_length < min_length)
+		segment_length = min_length;
+
+	float segments = ceil(fabs(angular_travel) * radius / segment_length);
+
+	return segments > 65535.0f ? 65535 : (unsigned short)segments;
+}
+
+/////////////////////////////////////////////////////////
+
+#ifndef REDUCED_SIZE
+
+void CMotionControlBase::SetJunctionDeviation(mm1000_t tolerance)
+{
+	// the stepper calculates the corner in steps (one value for all axis)
+	// different steps/mm => use the smallest of the xyz axis => the deviation is never more than the tolerance
+
+	sdist_t steps = ToMachine(X_AXIS, tolerance);
+
+	for (axis_t axis = 1; axis < NUM_AXISXYZ && axis < NUM_AXIS; axis++)
+	{
+		steps = min(steps, ToMachine(axis, tolerance));
+	}
+
+	CStepper::GetInstance()->SetJunctionDeviation((mdist_t) steps);
+}
+
+#endif
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::CubicBezier(const mm1000_t to[NUM_AXIS], const mm1000_t control1[2], const mm1000_t control2[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate)
+{
+	// control points relative to the current position (float precision)
+
+	float p1[2] = { (float)(control1[0] - GetPosition(axis_0)), (float)(control1[1] - GetPosition(axis_1)) };
+	float p2[2] = { (float)(control2[0] - GetPosition(axis_0)), (float)(control2[1] - GetPosition(axis_1)) };
+
+	Bezier(to, p1, p2, axis_0, axis_1, feedrate);
+}
+
+/////////////////////////////////////////////////////////
+
+void CMotionControlBase::QuadraticBezier(const mm1000_t to[NUM_AXIS], const mm1000_t control[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate)
+{
+	// degree elevation (exact): p1 = 2/3 q, p2 = p3 + 2/3 (q - p3)		(relative to p0)
+
+	float q[2]  = { (float)(control[0] - GetPosition(axis_0)), (float)(control[1] - GetPosition(axis_1)) };
+	float p3[2] = { (float)(to[axis_0] - GetPosition(axis_0)), (float)(to[axis_1] - GetPosition(axis_1)) };
+
+	float p1[2] = { q[0] * 2.0f / 3.0f, q[1] * 2.0f / 3.0f };
+	float p2[2] = { p3[0] + (q[0] - p3[0]) * 2.0f / 3.0f, p3[1] + (q[1] - p3[1]) * 2.0f / 3.0f };
+
+	Bezier(to, p1, p2, axis_0, axis_1, feedrate);
+}
+
+/////////////////////////////////////////////////////////
+
+// B(t) = ((a*t + b)*t + c)*t,  B'(t) = (3a*t + 2b)*t + c,  B''(t) = 6a*t + 2b		(p0 = 0)
+
+static void BezierPoint(const float a[2], const float b[2], const float c[2], float t, float p[2])
+{
+	p[0] = ((a[0] * t + b[0]) * t + c[0]) * t;
+	p[1] = ((a[1] * t + b[1]) * t + c[1]) * t;
+}
+
+static float BezierChordDeviation8(const float a[2], const float b[2], const float c[2], const float from[2], const float to[2], float t, float dt)
+{
+	// 8 * max deviation of B(t..t+dt) to the chord from-to
+	//
+	// distance to the line: <= max|n*B''| * dt^2 / 8 (n: normal of the chord)
+	// if the curve turns back (along the chord) use the distance to the linear interpolation: <= max|B''| * dt^2 / 8 
+	// B'' is linear in t => the max is at t or t+dt
+
+	float u[2] = { to[0] - from[0], to[1] - from[1] };
+	float len = hypot(u[0], u[1]);
+	float dd0[2] = { 6.0f * a[0] * t + 2.0f * b[0], 6.0f * a[1] * t + 2.0f * b[1] };
+	float dd1[2] = { 6.0f * a[0] * (t + dt) + 2.0f * b[0], 6.0f * a[1] * (t + dt) + 2.0f * b[1] };
+
+	bool forward = len > 0.0f;
+	if (forward)
+	{
+		// u*B'(s) = qa*s^2 + qb*s + qc must be > 0 in [t,t+dt]
+		float qa = 3.0f * (u[0] * a[0] + u[1] * a[1]);
+		float qb = 2.0f * (u[0] * b[0] + u[1] * b[1]);
+		float qc = u[0] * c[0] + u[1] * c[1];
+		float s = t + dt;
+		forward = (qa * t + qb) * t + qc > 0.0f && (qa * s + qb) * s + qc > 0.0f;
+		if (forward && qa != 0.0f)
+		{
+			s = -qb / (2.0f * qa);
+			if (s > t && s < t + dt)
+				forward = (qa * s + qb) * s + qc > 0.0f;
+		}
+	}
+
+	float dd;
+	if (forward)
+		dd = max(fabs(dd0[0] * u[1] - dd0[1] * u[0]), fabs(dd1[0] * u[1] - dd1[1] * u[0])) / len;
+	else
+		dd = max(hypot(dd0[0], dd0[1]), hypot(dd1[0], dd1[1]));
+
+	return dd * dt * dt;
+}
+
+void CMotionControlBase::Bezier(const mm1000_t to[NUM_AXIS], const float control1[2], const float control2[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate)
+{
+	// adaptive flattening of the cubic bezier, control points relative to the current position
+	//
+	// the next segment is calculated after the previous is queued (MoveAbs waits for a free entry in the movement queue)
+	// => no list of points and the stepper is running while the next segment is calculated
+
+	mm1000_t start[NUM_AXIS];
+	mm1000_t current[NUM_AXIS];
+	GetPositions(start);
+
+	float a[2], b[2], c[2];
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		float p3 = (float)(to[i == 0 ? axis_0 : axis_1] - start[i == 0 ? axis_0 : axis_1]);
+		a[i] = p3 - 3.0f * control2[i] + 3.0f * control1[i];
+		b[i] = 3.0f * control2[i] - 6.0f * control1[i];
+		c[i] = 3.0f * control1[i];
+	}
+
+	float tolerance8 = 8.0f * (_arcChordTolerance != 0 ? _arcChordTolerance : BEZIER_CHORDTOLERANCE);
+
+	// see GetArcSegments: the planner must keep up
+
+	float min_length = abs(feedrate) * (ARC_MINSEGMENTTIME / 60000000.0f);
+
+	float t = 0.0f;
+	float dt = 0.5f;
+	float p[2] = { 0.0f, 0.0f };
+	float next[2];
+
+	while (true)
+	{
+		// start with the double of the last step, shrink until the deviation is ok
+
+		dt = min(2.0f * dt, 1.0f - t);
+
+		while (true)
+		{
+			BezierPoint(a, b, c, t + dt, next);
+			float deviation8 = BezierChordDeviation8(a, b, c, p, next, t, dt);
+			if (deviation8 <= tolerance8)
+				break;
+			dt *= 0.9f * sqrt(tolerance8 / deviation8);
+		}
+
+		float length = hypot(next[0] - p[0], next[1] - p[1]);
+
+		if (length < min_length && length > 0.0f)
+		{
+			dt = min(dt * min_length / length, 1.0f - t);
+			BezierPoint(a, b, c, t + dt, next);
+		}
+
+		if (dt >= 1.0f - t)
+			break;
+
+		t += dt;
+		p[0] = next[0];
+		p[1] = next[1];
+
+		for (axis_t x = 0; x < NUM_AXIS; x++)
+		{
+			current[x] = start[x] + (mm1000_t)lround((to[x] - start[x]) * t);
+		}
+
+		current[axis_0] = start[axis_0] + (mm1000_t)lround(p[0]);
+		current[axis_1] = start[axis_1] + (mm1000_t)lround(p[1]);
+
+		MoveAbs(current, feedrate);
+	}
+
+	// Ensure last segment arrives at target location.
+	MoveAbs(to, feedrate);
+}
+
+/////////////////////////////////////////////////////////
+
+static unsigned long MaxDistRatio16(const mm1000_t dist[NUM_AXIS], mm1000_t maxdist)
+{
+	// maxdist / hypot(dist) * 65536
+	// integer hypot: scale the distances to 14 bit (maxdist) => sum of squares fits in 32 bit with 6 axis
+
+	uint8_t shiftRight = 0;
+	uint8_t shiftLeft = 0;
+
+	while ((maxdist >> shiftRight) > 0x3fff)	shiftRight++;
+	while ((maxdist << shiftLeft) < 0x2000)		shiftLeft++;
+
+	unsigned long sum = 0;
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		unsigned long d = ((unsigned long)dist[x] << shiftLeft) >> shiftRight;
+		sum += d*d;
+	}
+
+	unsigned long max = ((unsigned long)maxdist << shiftLeft) >> shiftRight;
+	unsigned long hypot = _ulsqrt_round(sum);
+
+	return ((max << 16) + hypot / 2) / hypot;
+}
+
+/////////////////////////////////////////////////////////
+
 steprate_t CMotionControlBase::GetFeedRate(const mm1000_t to[NUM_AXIS], feedrate_t feedrate)
+{
+	axis_t maxdistaxis;
+	feedrate = GetMaxDistFeedRate(to, feedrate, maxdistaxis);
+	return FeedRateToStepRate(maxdistaxis, feedrate);
+}
+
+/////////////////////////////////////////////////////////
+
+feedrate_t CMotionControlBase::GetMaxDistFeedRate(const mm1000_t to[NUM_AXIS], feedrate_t feedrate, axis_t& maxdistaxis)
 {
 	// feedrate < 0 => no arc correction (allowable max for all axis)
 	// from current position
 
-#define AvoidOverrun 256
-
-	axis_t   maxdistaxis = 0;
+	maxdistaxis = 0;
 
 	if (feedrate >= 0)
 	{
+		mm1000_t dist[NUM_AXIS];
 		mm1000_t maxdist = 0;
-		mm1000_t sum = 0;
-		mm1000_t sumOverRun = 0;
-		bool useOverrun = false;
 		uint8_t axiscount = 0;
 
 		for (register axis_t x = 0; x < NUM_AXIS; x++)
 		{
-			mm1000_t dist = GetPosition(x);
-			dist = to[x] > dist ? (to[x] - dist) : (dist - to[x]);
+			mm1000_t pos = GetPosition(x);
+			dist[x] = to[x] > pos ? (to[x] - pos) : (pos - to[x]);
 
-			if (dist != 0)
+			if (dist[x] != 0)
 			{
 				axiscount++;
-				if (dist > maxdist)
+				if (dist[x] > maxdist)
 				{
 					maxdistaxis = x;
-					maxdist = dist;
-				}
-
-				if (dist > 0xffff)
-				{
-					useOverrun = true;
+					maxdist = dist[x];
 				}
-				else
-				{
-					mm1000_t oldsum = sum;
-					sum += dist*dist;
-					useOverrun |= oldsum > sum;
-				}
-				sumOverRun += (dist / AvoidOverrun)*(dist / AvoidOverrun);
 			}
 		}
-		if (axiscount > 1)   //  && maxdist > 0)
-		{
-			if (useOverrun)
-			{
-				maxdist = maxdist / AvoidOverrun;
-				sum = _ulsqrt_round(sumOverRun);
-			}
-			else
-			{
-				sum = _ulsqrt_round(sum);
-			}
 
-			if (maxdist != sum && sum != 0)
-			{
-				// avoid overrun: feedrate * maxdist
-				if (ToPrecisionU2((unsigned long)feedrate) + ToPrecisionU2((unsigned long)maxdist) > 30)
-				{
-					// use float to avoid overruns
-					feedrate = feedrate_t(float(feedrate) * float(maxdist) / float(sum));
-				}
-				else
-				{
-					feedrate = RoundMulDivU32(feedrate, maxdist, sum);
-				}
-			}
+		if (axiscount > 1)
+		{
+			// feedrate of the path => feedrate of the axis with maxdist
+			feedrate = (feedrate_t) MulShr16U32((unsigned long)feedrate, MaxDistRatio16(dist, maxdist));
 		}
 	}
 
-	return FeedRateToStepRate(maxdistaxis, feedrate);
+	return feedrate;
 }
 
 /////////////////////////////////////////////////////////
@@ -356,7 +756,12 @@ steprate_t CMotionControlBase::FeedRateToStepRate(axis_t axis, feedrate_t feedra
 	// 60 because of min=>sec (feedrate in mm1000/min)
 	if (feedrate < 0) feedrate = -feedrate;
 	// feedrate => 32bit, steprate can be 16 bit
-	feedrate_t steprate32 = _ToMachine(axis, feedrate / 60);
+	feedrate_t steprate32;
+	uint8_t shift = _feedRateToStepRate[axis]._shift;
+	if (shift != 0)
+		steprate32 = (feedrate_t) (MulShr16U32((unsigned long)feedrate, _feedRateToStepRate[axis]._mul) >> (shift - 16));
+	else
+		steprate32 = _ToMachine(axis, feedrate / 60);
 	if (steprate32 > STEPRATE_MAX) return STEPRATE_MAX;
 	steprate_t steprate = (steprate_t)steprate32;
 	return steprate ? steprate : 1; 
@@ -395,8 +800,8 @@ void CMotionControlBase::MoveAbsEx(feedrate_t feedrate, unsigned short axis, mm1
 	{
 		dest[axis] = d;								// replace current position
 
-#ifdef _MSC_VER
-		axis = va_arg(arglist, unsigned short);
+#ifdef STEPPER_SIMULATION
+		axis = (unsigned short) va_arg(arglist, int);	// unsigned short is promoted to int
 		d = va_arg(arglist, mm1000_t);
 #else
 		axis = va_arg(arglist, unsigned int);		// only "int" supported on arduino
@@ -424,8 +829,8 @@ void CMotionControlBase::MoveRelEx(feedrate_t feedrate, unsigned short axis, mm1
 	{
 		dest[axis] += d;							// add to current postition
 
-#ifdef _MSC_VER
-		axis = va_arg(arglist, unsigned short);
+#ifdef STEPPER_SIMULATION
+		axis = (unsigned short) va_arg(arglist, int);	// unsigned short is promoted to int
 		d = va_arg(arglist, mm1000_t);
 #else
 		axis = va_arg(arglist, unsigned int);		// only "int" supported on arduino
@@ -440,6 +845,34 @@ void CMotionControlBase::MoveRelEx(feedrate_t feedrate, unsigned short axis, mm1
 
 ////////////////////////////////////////////////////////
 
+void CMotionControlBase::InitFeedRateToStepRate()
+{
+	// steps/mm1000 (of 1m, linear conversion) / 60 (min=>sec) as 16 bit mantissa and shift
+	// round up => 1234*60 mm1000/min with 1 step/mm1000 is 1234 (not 1233.99)
+
+	for (axis_t x = 0; x < NUM_AXIS; x++)
+	{
+		float mul = float(_ToMachine(x, 1000000)) / (1000000.0f * 60.0f) * 65536.0f;
+		uint8_t shift = 16;
+
+		while (mul > 0.0f && mul < 32768.0f && shift < 16 + 31)
+		{
+			mul *= 2.0f;
+			shift++;
+		}
+
+		if (mul < 32768.0f || mul >= 65536.0f)
+		{
+			shift = 0;		// out of range => use _ToMachine
+		}
+
+		_feedRateToStepRate[x]._mul = (unsigned long)ceil(mul);
+		_feedRateToStepRate[x]._shift = shift;
+	}
+}
+
+////////////////////////////////////////////////////////
+
 void CMotionControlBase::InitConversionBestStepsPer(float stepspermm1000)
 {
 	InitConversionStepsPer(stepspermm1000);
@@ -60,11 +60,11 @@ public:
 #define STEPSPERMM1000_SIZE NUM_AXIS
 #endif
 
-	static void InitConversion(ToMm1000_t toMm1000, ToMachine_t toMachine)						{ _ToMm1000 = toMm1000; _ToMachine = toMachine; }
-	static void InitConversionStepsPer(float stepspermm1000)									{ InitConversion(ToMm1000_StepsPer, ToMachine_StepsPer); for (axis_t x = 0; x < STEPSPERMM1000_SIZE; x++) StepsPerMm1000[x] = stepspermm1000; }
+	static void InitConversion(ToMm1000_t toMm1000, ToMachine_t toMachine)						{ _ToMm1000 = toMm1000; _ToMachine = toMachine; InitFeedRateToStepRate(); }
+	static void InitConversionStepsPer(float stepspermm1000)									{ for (axis_t x = 0; x < STEPSPERMM1000_SIZE; x++) StepsPerMm1000[x] = stepspermm1000; InitConversion(ToMm1000_StepsPer, ToMachine_StepsPer); }
 	static void InitConversionBestStepsPer(float stepspermm1000);
 	static void SetConversionStepsPerEx()															{ InitConversion(ToMm1000_StepsPerEx, ToMachine_StepsPerEx); }
-	static void SetConversionStepsPerEx(axis_t axis, float stepspermm1000)						{ StepsPerMm1000[axis] = stepspermm1000;; }
+	static void SetConversionStepsPerEx(axis_t axis, float stepspermm1000)						{ StepsPerMm1000[axis] = stepspermm1000; InitFeedRateToStepRate(); }
 
 	static mm1000_t ToMm1000(axis_t axis, sdist_t val)											{ return _ToMm1000(axis,val);  }
 	static sdist_t ToMachine(axis_t axis, mm1000_t val)											{ return _ToMachine(axis, val); }
@@ -72,6 +72,8 @@ public:
 	static void ToMachine(const mm1000_t mm1000[NUM_AXIS], udist_t machine[NUM_AXIS])			{ for (axis_t x = 0; x < NUM_AXIS; x++) { machine[x] = _ToMachine(x, mm1000[x]); } };
 	static void ToMm1000(const udist_t machine[NUM_AXIS], mm1000_t mm1000[NUM_AXIS])			{ for (axis_t x = 0; x < NUM_AXIS; x++) { mm1000[x] = _ToMm1000(x, machine[x]); } };
 
+	virtual bool IsConversionFixed()						{ return false; }		// compile time conversion (CMotionControlT) => not from eeprom
+
 	bool IsError()											{ return _error != 0; };
 	error_t GetError()										{ return _error; }
 	void ClearError()										{ _error = 0; }
@@ -80,6 +82,15 @@ protected:
 
 	virtual void TransformFromMachinePosition(const udist_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
 	virtual bool TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]);
+	virtual bool CanMoveArc()								{ return true; }		// TransformPosition keeps an arc => arc can be one movement of the stepper
+#ifndef REDUCED_SIZE
+	virtual mm1000_t GetMaxSegmentLength()					{ return 0; }		// TransformPosition is not linear (kinematics) => MoveAbs splits the line, 0 => linear
+	virtual mm1000_t GetSegmentTolerance()					{ return 1; }		// max deviation of a segment, in units of TransformPosition
+#endif
+
+	feedrate_t GetMaxDistFeedRate(const mm1000_t to[NUM_AXIS], feedrate_t feedrate, axis_t& maxdistaxis);	// feedrate of the axis with the longest distance
+	void MoveAbsMachine(const mm1000_t to[NUM_AXIS], const udist_t to_m[NUM_AXIS], steprate_t steprate);
+	virtual void MoveAbsTransformed(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate);	// to_proj = TransformPosition(to)
 
 	mm1000_t	_current[NUM_AXIS];
 
@@ -92,6 +103,28 @@ private:
 	static ToMachine_t _ToMachine;
 	error_t	_error=0;
 
+	struct SFeedRateToStepRate								// fixed point: steprate = feedrate * _mul >> _shift
+	{
+		unsigned long	_mul;								// 16 bit mantissa (32768 .. 65536)
+		uint8_t			_shift;								// 0 => use _ToMachine
+	};
+
+	static SFeedRateToStepRate _feedRateToStepRate[NUM_AXIS];
+
+	static void InitFeedRateToStepRate();					// build the table from _ToMachine
+
+	mm1000_t _arcChordTolerance=0;
+
+	unsigned short GetArcSegments(float radius, float angular_travel, feedrate_t feedrate);
+	void Bezier(const mm1000_t to[NUM_AXIS], const float control1[2], const float control2[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate);
+#ifndef REDUCED_SIZE
+	void MoveAbsSegments(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate);
+	mm1000_t SegmentDeviation(const mm1000_t from[NUM_AXIS], const mm1000_t from_proj[NUM_AXIS], const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS]);
+#endif
+#ifdef USE_ARCMOVE
+	bool MoveArc(const mm1000_t to[NUM_AXIS], mm1000_t center_axis0, mm1000_t center_axis1, axis_t axis_0, axis_t axis_1, bool isclockwise, float radius, float angular_travel, feedrate_t feedrate);
+#endif
+
 public:
 
 	void SetPositionFromMachine();
@@ -99,7 +132,7 @@ public:
 
 public:
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 	virtual void UnitTest() {};
 
@@ -114,6 +147,15 @@ public:
 	// all positions are logical-pos
 
 	void Arc(const mm1000_t to[NUM_AXIS], mm1000_t offset0, mm1000_t offset1, axis_t  axis_0, axis_t axis_1, bool isclockwise, feedrate_t feedrate);
+	void SetArcChordTolerance(mm1000_t tolerance)			{ _arcChordTolerance = tolerance; }	// 0 => segments from radius
+	mm1000_t GetArcChordTolerance() const					{ return _arcChordTolerance; }
+#ifndef REDUCED_SIZE
+	void SetJunctionDeviation(mm1000_t tolerance);			// corner tolerance (G64 P), 0 => jerk only
+#endif
+
+	// control points are absolute positions of axis_0/axis_1, other axis are linear
+	void CubicBezier(const mm1000_t to[NUM_AXIS], const mm1000_t control1[2], const mm1000_t control2[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate);
+	void QuadraticBezier(const mm1000_t to[NUM_AXIS], const mm1000_t control[2], axis_t axis_0, axis_t axis_1, feedrate_t feedrate);
 	virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t feedrate);
 
 	void GetPositions(mm1000_t current[NUM_AXIS]);
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////
+/*
+  This file is part of CNCLib - A library for stepper motors.
+
+  Copyright (c) 2013-2018 Herbert Aitenbichler
+
+  CNCLib is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  CNCLib is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#pragma once
+
+////////////////////////////////////////////////////////
+
+// Compile time conversion: StepsPerRot steps == Mm1000PerRot mm1000 (all axis)
+// e.g. CMotionControlT<200*16, 5000, CMotionControlDefault> for a 5mm screw with 1/16 microstepping
+// the conversion is inlined in MoveAbsTransformed (positions and feedrate), ToMachine/ToMm1000 of CMotionControlBase use the same functions
+
+////////////////////////////////////////////////////////
+
+#include "MotionControlBase.h"
+
+////////////////////////////////////////////////////////
+
+template <unsigned long A, unsigned long B>
+struct SConversionGcd											{ static constexpr unsigned long Value = SConversionGcd<B, A % B>::Value; };
+
+template <unsigned long A>
+struct SConversionGcd<A, 0>										{ static constexpr unsigned long Value = A; };
+
+////////////////////////////////////////////////////////
+
+template <unsigned long StepsPerRot, unsigned long Mm1000PerRot, class TBase = CMotionControlBase>
+class CMotionControlT : public TBase
+{
+private:
+
+	typedef TBase super;
+
+	static constexpr unsigned long Steps  = StepsPerRot / SConversionGcd<StepsPerRot, Mm1000PerRot>::Value;
+	static constexpr unsigned long Mm1000 = Mm1000PerRot / SConversionGcd<StepsPerRot, Mm1000PerRot>::Value;
+
+	static_assert(Steps <= 1024 && Mm1000 <= 1024, "StepsPerRot/Mm1000PerRot must be reducible to <= 1024 (MulDiv overrun)");
+
+public:
+
+	CMotionControlT()												{ super::InitConversion(ToMm1000, ToMachine); }
+
+	using super::ToMm1000;
+	using super::ToMachine;
+
+	static mm1000_t ToMm1000(axis_t /* axis */, sdist_t val)		{ return RoundMulDivU32(val, Mm1000, Steps); }
+	static sdist_t  ToMachine(axis_t /* axis */, mm1000_t val)		{ return MulDivU32(val, Steps, Mm1000); }
+
+	static steprate_t FeedRateToStepRate(axis_t axis, feedrate_t feedrate)
+	{
+		// 60 because of min=>sec (feedrate in mm1000/min)
+		if (feedrate < 0) feedrate = -feedrate;
+		feedrate_t steprate32 = ToMachine(axis, feedrate / 60);
+		if (steprate32 > STEPRATE_MAX) return STEPRATE_MAX;
+		steprate_t steprate = (steprate_t)steprate32;
+		return steprate ? steprate : 1;
+	}
+
+	virtual bool IsConversionFixed() override						{ return true; }
+
+protected:
+
+	// MoveAbs of the base class transforms (and splits, see GetMaxSegmentLength) the line
+
+	virtual void MoveAbsTransformed(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t feedrate) override
+	{
+		udist_t		to_m[NUM_AXIS];
+
+		for (axis_t x = 0; x < NUM_AXIS; x++)
+		{
+			to_m[x] = ToMachine(x, to_proj[x]);
+		}
+
+		axis_t maxdistaxis;
+		feedrate = this->GetMaxDistFeedRate(to_proj, feedrate, maxdistaxis);
+		this->MoveAbsMachine(to, to_m, FeedRateToStepRate(maxdistaxis, feedrate));
+	}
+};
+
+////////////////////////////////////////////////////////
@@ -248,6 +248,31 @@ bool CParser::TryToken(const char* buffer, const __FlashStringHelper* b, bool ig
 
 ////////////////////////////////////////////////////////////
 
+CParser::mnemonic_t CParser::TryMnemonic(const char* buffer, bool ignorecase)
+{
+	if (!CStreamReader::IsAlpha(buffer[0]) || !CStreamReader::IsAlpha(buffer[1]))
+		return 0;
+
+	return Mnemonic(ConvertChar(buffer[0], ignorecase), ConvertChar(buffer[1], ignorecase));
+}
+
+////////////////////////////////////////////////////////////
+
+CParser::mnemonic_t CParser::GetMnemonic(bool ignorecase)
+{
+	mnemonic_t mnemonic = TryMnemonic(ignorecase);
+
+	if (mnemonic != 0)
+	{
+		_reader->ResetBuffer(_reader->GetBuffer() + 2);
+		_reader->SkipSpaces();
+	}
+
+	return mnemonic;
+}
+
+////////////////////////////////////////////////////////////
+
 bool CParser::TryToken(const char* buffer, const __FlashStringHelper* b, bool expectdel, bool ignorecase, const char*&nextchar)
 {
 	const char* p = (const char*) b;
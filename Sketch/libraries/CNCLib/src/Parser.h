@@ -116,6 +116,17 @@ protected:
 	bool TryToken(const char* buffer, const __FlashStringHelper * b, bool ignorecase);					// same as stricmp (with Progmem)	
 
 	//////////////////////////////////////////////////////
+	// Mnemonic: two letter command (e.g. HPGL "PA") scanned once and dispatched with switch/case (no list of IsToken)
+
+	typedef uint16_t mnemonic_t;
+
+	static constexpr mnemonic_t Mnemonic(char ch1, char ch2)		{ return (mnemonic_t(uint8_t(ch1)) << 8) + uint8_t(ch2); }
+
+	mnemonic_t TryMnemonic(bool ignorecase)							{ return TryMnemonic(_reader->GetBuffer(), ignorecase); }
+	mnemonic_t TryMnemonic(const char* buffer, bool ignorecase);	// 0 if not two letters, scan from different location, do not remove it
+	mnemonic_t GetMnemonic(bool ignorecase);						// see TryMnemonic, remove it and skip spaces
+
+	//////////////////////////////////////////////////////
 
 private:
 
@@ -82,7 +82,7 @@ void CU8GLcd::SetRotaryPin(pin_t pin1, pin_t pin2, pin_t pinPush, uint8_t onValu
 
 	_rotarybutton.SetPin(pin1, pin2);
 
-#if defined(__AVR_ARCH__) || defined(_MSC_VER)
+#if defined(__AVR_ARCH__) || defined(STEPPER_SIMULATION)
 #else
 
 	CHAL::attachInterruptPin(pin1, CallRotaryButtonTickISR, CHANGE);
@@ -161,7 +161,7 @@ void CU8GLcd::TimerInterrupt()
 {
 	super::TimerInterrupt();
 
-#if defined(__AVR_ARCH__) || defined(_MSC_VER)
+#if defined(__AVR_ARCH__) || defined(STEPPER_SIMULATION)
 
 	CallRotaryButtonTick();
 
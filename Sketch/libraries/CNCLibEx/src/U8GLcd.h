@@ -101,7 +101,7 @@ protected:
 #endif
 	}
 
-#ifndef _MSC_VER
+#ifndef STEPPER_SIMULATION
 
 	inline void Print(const __FlashStringHelper* s)
 	{
@@ -66,6 +66,18 @@ typedef const __FlashStringHelper * error_t;
 ////////////////////////////////////////////////////////
 
 #define SYNC_STEPBUFFERCOUNT		8		// allow only x element in step buffer when io or wait starts
+#define MOVEMENTPLANMAXCOUNT		16		// max movements (from tail) to re-plan for each queued move => bounded time for QueueMove
+
+//#define USE_DYNAMICSTEPMULTIPLIER	// calc step multiplier for each step (from current timer) instead of once per move (from max speed)
+//#define USE_RAMPTABLE				// calc acc/dec timer with ramptab (multiplication) instead of the recurrence with a division for each step
+//#define USE_ARCMOVE					// circular interpolation in the step generator => G2/G3 is one movement (not line segments), 32 bit only
+
+#define ARCMOVE_MINRADIUS			16		// min radius (steps) of an arc move, smaller => line segments
+#define ARCMOVE_MAXRADIUSDIFF		4		// max difference of radius (steps) at start and end of an arc move
+
+//#define USE_MERGEMOVE				// fold a co-linear move into the (not started) tail of the movement queue => less movements, longer look-ahead
+
+#define MERGEMOVE_TOLERANCE			1		// max deviation (steps) of the merged junction points (set by CControl), 0 => no merge
 
 ////////////////////////////////////////////////////////
 
@@ -78,7 +90,7 @@ typedef const __FlashStringHelper * error_t;
 
 #define NUM_AXIS			5
 
-#define STEPBUFFERSIZE		128		// size 2^x but not 256
+#define STEPBUFFERSIZE		128		// size 2^x (faster), > 128 only on 32 bit
 #define MOVEMENTBUFFERSIZE	64
 
 ////////////////////////////////////////////////////////
@@ -90,7 +102,7 @@ typedef const __FlashStringHelper * error_t;
 #undef use32bit
 #define use16bit
 
-#define STEPBUFFERSIZE		16		// size 2^x but not 256
+#define STEPBUFFERSIZE		16		// size 2^x (faster), > 128 only on 32 bit
 #define MOVEMENTBUFFERSIZE	8
 
 #define NUM_AXIS 4
@@ -110,16 +122,19 @@ typedef const __FlashStringHelper * error_t;
 
 #define NUM_AXIS			6
 
-#define STEPBUFFERSIZE		128		// size 2^x but not 256
+#define STEPBUFFERSIZE		128		// size 2^x (faster), > 128 only on 32 bit
 #define MOVEMENTBUFFERSIZE	64
 
+//#define USE_ARCMOVE
+//#define USE_MERGEMOVE
+
 ////////////////////////////////////////////////////////
 
-#elif defined (_MSC_VER)
+#elif defined (STEPPER_SIMULATION)
 
-// test environment only
+// test environment only (msvc and host build)
 
-typedef unsigned long long uint64_t;
+#include <stdint.h>
 
 //#undef use32bit
 //#define use16bit
@@ -127,7 +142,7 @@ typedef unsigned long long uint64_t;
 #undef use16bit
 #define use32bit
 
-#define STEPBUFFERSIZE		16		// size 2^x but not 256
+#define STEPBUFFERSIZE		16		// size 2^x (faster), > 128 only on 32 bit
 #define MOVEMENTBUFFERSIZE	8
 
 //#define NUM_AXIS 5
@@ -138,6 +153,9 @@ typedef unsigned long long uint64_t;
 
 #define MOVEMENTINFOSIZE	128
 
+#define USE_ARCMOVE
+#define USE_MERGEMOVE
+
 ////////////////////////////////////////////////////////
 
 #else
@@ -182,7 +200,7 @@ typedef unsigned long steprate_t;		// tpye for speed (Hz), Steps/sec
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 #define EnumAsByte(a) a
 #define debugvirtula virtual
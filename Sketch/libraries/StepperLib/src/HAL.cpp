@@ -45,7 +45,7 @@ CHAL::HALEvent CHAL::_TimerEvent2 = IgnoreIrq;
 
 #endif
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 std::function<uint8_t(short)> digitalReadEvent=NULL;
 
@@ -26,7 +26,7 @@
 
 //////////////////////////////////////////
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 
 #else
 
@@ -183,6 +183,8 @@ public:
 	static inline irqflags_t GetSREG() ALWAYSINLINE;
 	static inline void SetSREG(irqflags_t) ALWAYSINLINE;
 
+	static inline void MemoryFence() ALWAYSINLINE;				// compiler (and cpu) barrier, used for lock free queues
+
 	static inline void pinMode(pin_t pin, uint8_t mode);
 	static inline void pinModeInput(pin_t pin) NEVER_INLINE_AVR;
 	static inline void pinModeInputPullUp(pin_t pin) NEVER_INLINE_AVR;
@@ -208,7 +210,7 @@ public:
 
 	static uint32_t* GetEepromBaseAdr() ALWAYSINLINE;
 
-#if defined(_MSC_VER)
+#if defined(STEPPER_SIMULATION)
 
 	static void SetEepromFilename(char* filename) { _eepromFileName = filename; }
 
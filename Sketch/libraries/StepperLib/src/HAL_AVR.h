@@ -79,6 +79,8 @@ inline void CHAL::EnableInterrupts()	{	sei(); }
 inline irqflags_t CHAL::GetSREG()		{ return SREG; }
 inline void CHAL::SetSREG(irqflags_t a)	{ SREG=a; }
 
+inline void CHAL::MemoryFence()			{ __asm__ __volatile__("" ::: "memory"); }
+
 inline void  CHAL::RemoveTimer0()		{}
 
 inline void  CHAL::InitTimer0(HALEvent evt)
@@ -21,12 +21,13 @@
 
 ////////////////////////////////////////////////////////
 
-#if defined(_MSC_VER)
+#include <Arduino.h>		// defines STEPPER_SIMULATION
+
+#if defined(STEPPER_SIMULATION)
 
 #include <stdlib.h>
 #include <string.h>
 
-#include <Arduino.h>
 #include <ctype.h>
 
 #include "HAL.h"
@@ -78,5 +79,5 @@ void CHAL::FlushEeprom()
 
 ////////////////////////////////////////////////////////
 
-#endif		// _MSC_VER
+#endif		// STEPPER_SIMULATION
 
@@ -23,11 +23,12 @@
 // MSC
 ////////////////////////////////////////////////////////
 
-#if defined(_MSC_VER)
+#if defined(STEPPER_SIMULATION)
 
 #include <Arduino.h>
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <atomic>
 
 #define pgm_read_int pgm_read_dword
 #define pgm_read_uint pgm_read_dword
@@ -67,6 +68,8 @@ inline void CHAL::DelayMicroseconds(unsigned int) {}
 inline irqflags_t CHAL::GetSREG()				{ return SREG; }
 inline void CHAL::SetSREG(irqflags_t a)			{ SREG=a; }
 
+inline void CHAL::MemoryFence()					{ std::atomic_thread_fence(std::memory_order_seq_cst); }
+
 #define __asm__(a)
 
 inline void CHAL::InitTimer0(HALEvent evt){ _TimerEvent0 = evt; }
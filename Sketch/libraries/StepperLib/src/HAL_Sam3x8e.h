@@ -91,6 +91,8 @@ inline void CHAL::EnableInterrupts()		{	cpu_irq_enable(); }
 inline irqflags_t CHAL::GetSREG()			{ return cpu_irq_save(); }
 inline void CHAL::SetSREG(irqflags_t a)		{ cpu_irq_restore(a); }
 
+inline void CHAL::MemoryFence()				{ __DMB(); }
+
 // use CAN as backgroundworker thread
 #define IRQTYPE CAN0_IRQn
 
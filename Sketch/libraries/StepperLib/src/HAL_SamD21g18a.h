@@ -87,6 +87,8 @@ static inline unsigned char __interruptsStatus(void)
 inline irqflags_t CHAL::GetSREG()			{ return interruptsStatus(); }
 inline void CHAL::SetSREG(irqflags_t a)		{ if (a != GetSREG()) { if (a) EnableInterrupts(); else DisableInterrupts(); } }
 
+inline void CHAL::MemoryFence()				{ __DMB(); }
+
 #define IRQTYPE I2S_IRQn
 //#define IRQTYPE TC3_IRQn
 
@@ -24,189 +24,321 @@
 #include "HAL.h"
 
 //////////////////////////////////////////
+// index type: uint8_t up to 128 elements, uint16_t for larger queues (32 bit targets)
 
-template <class T, const uint8_t maxsize>		// do not use maxsize > 254 (255 is used internal)
-class CRingBufferQueue								// maxxsize should be 2^n (because of % operation)
+template <bool small> struct SRingBufferIndexType			{ typedef uint8_t type; };
+template <> struct SRingBufferIndexType<false>				{ typedef uint16_t type; };
+
+//////////////////////////////////////////
+//
+// _head and _nexttail are counters, not positions in Buffer
+// maxsize = 2^n:  counters are free running and wrap with the index type, position is counter & (maxsize-1) (no % and no branch)
+// other sizes:    counters wrap at 2*maxsize, position is counter or counter-maxsize
+// in both cases full and empty can be distinguished by the counters (no _empty flag, all maxsize elements can be used)
+//
+// All "Pos" and "Index" functions (GetHeadPos, NextIndex, H2T/T2H, InsertTail, ...) work on positions in Buffer
+
+template <class T, const unsigned int maxsize>
+class CRingBufferQueueBase
 {
 public:
 
-	CRingBufferQueue()
-	{
-		Clear();
-	}
+	typedef typename SRingBufferIndexType<(maxsize <= 128)>::type index_t;
 
-	void Dequeue()
+	bool IsEmpty() const
 	{
-		CCriticalRegion crit;
-		_head = NextIndex(_head);
-		_empty = _head == _nexttail;
+		return _head == _nexttail;
 	}
 
-	void Enqueue()
+	bool IsFull() const
 	{
-		CCriticalRegion crit;
-		_nexttail = NextIndex(_nexttail);
-		_empty = false;
+		return Count() == maxsize;
 	}
 
-	void Enqueue(T value)
+	index_t Count() const
 	{
-		Buffer[GetNextTailPos()] = value;
-		Enqueue();
+		// read each counter only once, it may be changed in an ISR
+		index_t head = _head;
+		index_t nexttail = _nexttail;
+
+		if (IsPowerOfTwo())
+		{
+			return (index_t)(nexttail - head);
+		}
+		return nexttail >= head ? nexttail - head : (2 * maxsize) - head + nexttail;
 	}
 
-	void EnqueueCount(uint8_t cnt)
+	index_t FreeCount() const
 	{
-		CCriticalRegion crit;
-		_nexttail = NextIndex(_nexttail, cnt);
-		_empty = false;
+		return maxsize - Count();
 	}
 
 	void RemoveTail()
 	{
 		CCriticalRegion crit;
-		_nexttail = PrevIndex(_nexttail);
-		_empty = _head == _nexttail;
+		_nexttail = DecCounter(_nexttail);
 	}
 
-	void RemoveTail(uint8_t tail)
+	void RemoveTail(index_t tail)
 	{
 		CCriticalRegion crit;
-		_nexttail = NextIndex(tail);
-		_empty = _head == _nexttail;
+		index_t head = _head;
+		_nexttail = IncCounter(head, DiffIndex(tail, ToPos(head)) + 1);
 	}
 
-	bool IsEmpty() const
-	{
-		return _empty;
-	}
+	// next functions no check if empty or full
 
-	bool IsFull() const
+	T& Head()                       { return Buffer[GetHeadPos()]; }
+	T& Tail()                       { return Buffer[GetTailPos()]; }
+	T& NextTail()                   { return Buffer[GetNextTailPos()]; }
+	T& NextTail(index_t ofs)		{ return Buffer[NextIndex(GetNextTailPos(), ofs)]; }
+
+	T* SaveTail()                   { return IsEmpty() ? 0 : &Tail(); }
+	T* SaveHead()                   { return IsEmpty() ? 0 : &Head(); }
+
+	T* GetNext(index_t idx)	{
+		idx = NextIndex(idx);
+		return idx != GetNextTailPos() && IsInQueue(idx) ? &Buffer[idx] : NULL;
+	}
+	T* GetPrev(index_t idx)	
 	{
-		return !_empty && _head == _nexttail;
+		if (idx == GetHeadPos()) return NULL;
+		idx = PrevIndex(idx);
+		return IsInQueue(idx) ? &Buffer[idx] : NULL;
 	}
+	index_t GetHeadPos() const		{ return ToPos(_head); }
+	index_t GetNextTailPos() const	{ return ToPos(_nexttail); }
+	index_t GetTailPos() const		{ return ToPos(DecCounter(_nexttail)); }
 
-	uint8_t Count() const
+	bool IsInQueue(index_t idx) const	
 	{
-		if (_empty)
-			return 0;
+		index_t head = _head;
+		index_t nexttail = _nexttail;
 
-		if (_head < _nexttail)
+		if (IsPowerOfTwo())
 		{
-			return _nexttail - _head;
+			return ((index_t)(idx - head) & (maxsize - 1)) < (index_t)(nexttail - head);
 		}
-		return maxsize - _head + _nexttail;
+		return DiffIndex(idx, ToPos(head)) < Count();
+	}
+
+	// iteration from head to tail (H2T)
+	index_t H2TInit() const					{ return  IsEmpty() ? NoIndex() : GetHeadPos(); }
+	bool H2TTest(index_t idx) const			{ return  idx != NoIndex(); }
+	index_t H2TInc(index_t idx) const		{ idx = NextIndex(idx); return idx == GetNextTailPos() ? NoIndex() : idx; }
+
+	// iteration from tail to head (T2H)
+	index_t T2HInit() const					{ return  IsEmpty() ? NoIndex() : GetTailPos(); }
+	bool T2HTest(index_t idx) const			{ return  idx != NoIndex(); }
+	index_t T2HInc(index_t idx) const		{ return idx == GetHeadPos() ? NoIndex() : PrevIndex(idx); }
+
+	void Clear()
+	{
+		CCriticalRegion crit;
+		_head = 0;
+		_nexttail = 0;
 	}
 
-	uint8_t FreeCount() const
+protected:
+
+	CRingBufferQueueBase()
 	{
-		return maxsize - Count();
+		Clear();
 	}
 
-	T* InsertTail(uint8_t insertat)
+	// make space at insertat (move elements from insertat to tail), return position of new element (not enqueued)
+	index_t ShiftTail(index_t insertat)
 	{
 		if (IsInQueue(insertat))
 		{
-			for (uint8_t idx = T2HInit(); T2HTest(idx); idx = T2HInc(idx))
+			for (index_t idx = T2HInit(); T2HTest(idx); idx = T2HInc(idx))
 			{
 				Buffer[NextIndex(idx)] = Buffer[idx];
 				if (insertat == idx)
 					break;
 			}
+			return insertat;
 		}
-		else
+		// add tail
+		return GetNextTailPos();
+	}
+
+	// often accessed members first => is faster
+
+	volatile index_t	_head;      // counter of head of queue
+	volatile index_t	_nexttail;  // counter of next free tail (NOT tail position)
+
+public:
+
+	T Buffer[maxsize];
+
+	////////////////////////////////////////////////////////
+
+public:
+
+	static bool IsPowerOfTwo()		{ return (maxsize & (maxsize - 1)) == 0; }
+	static index_t NoIndex()		{ return (index_t) ~((index_t) 0); }		// end of iteration (H2T, T2H)
+
+	index_t NextIndex(index_t idx) const
+	{
+		return NextIndex(idx, 1);
+	}
+
+	index_t NextIndex(index_t idx, index_t count) const
+	{
+		if (IsPowerOfTwo())
 		{
-			// add tail
-			insertat = GetNextTailPos();
+			return (index_t)(idx + count) & (maxsize - 1);
 		}
-
-		Enqueue();
-		return &Buffer[insertat];
+		return (index_t)((idx + count) % maxsize);
 	}
 
+	index_t PrevIndex(index_t idx) const
+	{
+		return PrevIndex(idx, 1);
+	}
 
-	// next functions no check if empty or full
+	index_t PrevIndex(index_t idx, index_t count) const
+	{
+		if (IsPowerOfTwo())
+		{
+			return (index_t)(idx - count) & (maxsize - 1);
+		}
+		return (idx >= count) ? idx - count : (maxsize)-(count - idx);
+	}
 
-	T& Head()                       { return Buffer[GetHeadPos()]; }
-	T& Tail()                       { return Buffer[GetTailPos()]; }
-	T& NextTail()                   { return Buffer[GetNextTailPos()]; }
-	T& NextTail(uint8_t ofs)  { return Buffer[NextIndex(GetNextTailPos(), ofs)]; }
+protected:
 
-	T* SaveTail()                   { return IsEmpty() ? 0 : &Tail(); }
-	T* SaveHead()                   { return IsEmpty() ? 0 : &Head(); }
+	static index_t ToPos(index_t counter)
+	{
+		if (IsPowerOfTwo())
+		{
+			return counter & (maxsize - 1);
+		}
+		return counter >= maxsize ? counter - maxsize : counter;
+	}
 
-	T* GetNext(uint8_t idx)	{
-		idx = NextIndex(idx);
-		return idx != _nexttail && IsInQueue(idx) ? &Buffer[idx] : NULL;
+	static index_t IncCounter(index_t counter, index_t count)
+	{
+		if (IsPowerOfTwo())
+		{
+			return (index_t)(counter + count);
+		}
+		unsigned int newcounter = counter + count;
+		return (index_t)(newcounter >= 2 * maxsize ? newcounter - 2 * maxsize : newcounter);
 	}
-	T* GetPrev(uint8_t idx)	
+
+	static index_t DecCounter(index_t counter)
 	{
-		if (idx == _head) return NULL;
-		idx = PrevIndex(idx);
-		return IsInQueue(idx) ? &Buffer[idx] : NULL;
+		if (IsPowerOfTwo())
+		{
+			return (index_t)(counter - 1);
+		}
+		return counter == 0 ? (2 * maxsize - 1) : counter - 1;
 	}
-	uint8_t GetHeadPos() const		{ return _head; }
-	uint8_t GetNextTailPos() const	{ return _nexttail; }
-	uint8_t GetTailPos() const		{ return PrevIndex(_nexttail); }
 
-	bool IsInQueue(uint8_t idx) const	
+	static index_t DiffIndex(index_t idx, index_t fromidx)		// distance of positions from "fromidx" to "idx"
 	{
-		if (_empty) return false;
-		if (_nexttail == _head) return true;
-		if (_nexttail > _head) return idx >= _head && idx < _nexttail;
-		return idx >= _head || idx < _nexttail;
+		if (IsPowerOfTwo())
+		{
+			return (index_t)(idx - fromidx) & (maxsize - 1);
+		}
+		return idx >= fromidx ? idx - fromidx : maxsize - (fromidx - idx);
 	}
+};
 
-	// iteration from head to tail (H2T)
-	uint8_t H2TInit() const					{ return  _empty ? 255 : _head; }
-	bool H2TTest(uint8_t idx) const			{ return  idx != 255; }
-	uint8_t H2TInc(uint8_t idx) const	{ idx = NextIndex(idx); return idx == _nexttail ? 255 : idx; }
+////////////////////////////////////////////////////////
 
-	// iteration from tail to head (T2H)
-	uint8_t T2HInit() const					{ return  _empty ? 255 : GetTailPos(); }
-	bool T2HTest(uint8_t idx) const			{ return  idx != 255; }
-	uint8_t T2HInc(uint8_t idx) const	{ return idx == _head ? 255 : PrevIndex(idx); }
+template <class T, const unsigned int maxsize>		// maxxsize should be 2^n (faster)
+class CRingBufferQueue : public CRingBufferQueueBase<T, maxsize>
+{
+	typedef CRingBufferQueueBase<T, maxsize> super;
 
-	void Clear()
+public:
+
+	typedef typename super::index_t index_t;
+
+	void Dequeue()
 	{
 		CCriticalRegion crit;
-		_head = 0;
-		_nexttail = 0;
-		_empty = true;
+		this->_head = super::IncCounter(this->_head, 1);
 	}
 
-private:
-	// often accessed members first => is faster
+	void Enqueue()
+	{
+		CCriticalRegion crit;
+		this->_nexttail = super::IncCounter(this->_nexttail, 1);
+	}
 
-	volatile uint8_t	_head;      // index of head of queue
-	volatile uint8_t	_nexttail;  // index of next free tail (NOT tail position)
-	volatile bool			_empty;		// distinguish between full and empty
+	void Enqueue(T value)
+	{
+		this->Buffer[this->GetNextTailPos()] = value;
+		Enqueue();
+	}
 
-public:
+	void EnqueueCount(index_t cnt)
+	{
+		CCriticalRegion crit;
+		this->_nexttail = super::IncCounter(this->_nexttail, cnt);
+	}
 
-	T Buffer[maxsize];
+	T* InsertTail(index_t insertat)
+	{
+		insertat = this->ShiftTail(insertat);
+		Enqueue();
+		return &this->Buffer[insertat];
+	}
+};
 
-	////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////
+//
+// Lock free version for one producer and one consumer (SPSC)
+// e.g. FillStepBuffer/CalcNextSteps (producer) and StepOut in the timer ISR (consumer)
+//
+// The producer writes _nexttail only, the consumer writes _head only => no CCriticalRegion in Enqueue/Dequeue
+// InsertTail, RemoveTail and Clear modify both ends and still use a CCriticalRegion
+// On 8 bit cpus (AVR) use maxsize <= 128 (the uint16_t counters are not read atomic)
+
+template <class T, const unsigned int maxsize>		// maxxsize should be 2^n (faster)
+class CRingBufferQueueSPSC : public CRingBufferQueueBase<T, maxsize>
+{
+	typedef CRingBufferQueueBase<T, maxsize> super;
 
 public:
 
-	uint8_t NextIndex(uint8_t idx) const
+	typedef typename super::index_t index_t;
+
+	void Dequeue()
 	{
-		return (uint8_t)((idx + 1)) % (maxsize);
+		index_t head = super::IncCounter(this->_head, 1);
+		CHAL::MemoryFence();		// finish reading Buffer[_head] before it is released to the producer
+		this->_head = head;
 	}
 
-	uint8_t NextIndex(uint8_t idx, uint8_t count) const
+	void Enqueue()
 	{
-		return (uint8_t)((idx + count)) % (maxsize);
+		index_t nexttail = super::IncCounter(this->_nexttail, 1);
+		CHAL::MemoryFence();		// Buffer[_nexttail] must be written before it is visible to the consumer
+		this->_nexttail = nexttail;
 	}
 
-	uint8_t PrevIndex(uint8_t idx) const
+	void Enqueue(T value)
 	{
-		return idx == 0 ? (maxsize - 1) : (idx - 1);
+		this->Buffer[this->GetNextTailPos()] = value;
+		Enqueue();
 	}
 
-	uint8_t PrevIndex(uint8_t idx, uint8_t count) const
+	void EnqueueCount(index_t cnt)
 	{
-		return (idx >= count) ? idx - count : (maxsize)-(count - idx);
+		index_t nexttail = super::IncCounter(this->_nexttail, cnt);
+		CHAL::MemoryFence();
+		this->_nexttail = nexttail;
+	}
+
+	T* InsertTail(index_t insertat)
+	{
+		insertat = this->ShiftTail(insertat);
+		Enqueue();
+		return &this->Buffer[insertat];
 	}
 };
@@ -72,6 +72,8 @@ void CStepper::InitMemVar()
 	_pod._idleLevel = LevelOff;
 
 	_pod._speedoverride = SpeedOverride100P;
+	_pod._rampType = RampTrapezoid;
+	_pod._planMaxCount = MOVEMENTPLANMAXCOUNT;
 
 //	SetUsual(28000);	=> reduce size => hard coded
 	SetDefaultMaxSpeed(28000, 350, 380);
@@ -79,7 +81,7 @@ void CStepper::InitMemVar()
 
 	for (i = 0; i<MOVEMENTBUFFERSIZE; i++) _movements._queue.Buffer[i]._state= SMovement::StateDone;
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	MSCInfo = "";
 #endif
 
@@ -219,6 +221,7 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 
 				_movements._queue.NextTail().InitMove(this, GetPrevMovement(_movements._queue.GetNextTailPos()), backlashsteps, backlashdist, directionUp, _pod._timerbacklash);
 				_movements._queue.NextTail().SetBacklash();
+				NoMergeMove();
 			
 				EnqueuAndStartTimer(false);
 			}
@@ -229,6 +232,18 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 	_pod._lastdirection &= ~directionmask;
 	_pod._lastdirection += direction;
 
+#ifdef USE_MERGEMOVE
+	if (stepmult == 1 && MergeMove(dist, directionUp, timerMax))
+		return;
+
+	memcpy(_pod._mergeDist, dist, sizeof(_pod._mergeDist));
+	_pod._mergeTimerMax = timerMax;
+	_pod._mergeDeviation = 0;
+
+	if (stepmult != 1)
+		NoMergeMove();			// timerMax is for steps*stepmult => a following move with stepmult 1 would be stepmult times faster
+#endif
+
 	// wait until free movement buffer
 
 	WaitUntilCanQueue();
@@ -240,10 +255,90 @@ void CStepper::QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NU
 
 ////////////////////////////////////////////////////////
 
+#ifdef USE_MERGEMOVE
+
+bool CStepper::MergeMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax)
+{
+	// fold the new move into the tail of the queue if it is (nearly) co-linear and not started yet
+	// the tail must be the last move queued by QueueMove (not backlash, not arc, same speed, no stepmultiplier) => _mergeDist is the distance of the tail
+	// deviation: distance of the junction point to the merged line, the deviation of already merged points is added (upper limit)
+
+	if (_pod._mergeTolerance == 0 || _movements._queue.IsEmpty() || _pod._mergeTimerMax == (timer_t)-1 || timerMax != _pod._mergeTimerMax)
+		return false;
+
+	uint8_t idx = _movements._queue.GetTailPos();
+	SMovement& mv = _movements._queue.Buffer[idx];
+
+	if (!mv.IsReadyForMove() || mv._backlash || mv.IsArc())
+		return false;
+
+	mdist_t mergeDist[NUM_AXIS];
+	mdist_t mergeSteps = 0;
+	axis_t i;
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		if (dist[i] && _pod._mergeDist[i] && directionUp[i] != mv.GetDirectionUp(i))
+			return false;
+
+		if ((unsigned long)dist[i] + (unsigned long)_pod._mergeDist[i] > (unsigned long)MAXSTEPSPERMOVE)
+			return false;
+
+		mergeDist[i] = dist[i] + _pod._mergeDist[i];
+		if (mergeDist[i] > mergeSteps)
+			mergeSteps = mergeDist[i];
+	}
+
+	// |junction x merged|^2 / |merged|^2 => square of the distance of the junction point to the merged line
+
+	float cross2 = 0.0;
+	float length2 = 0.0;
+
+	for (i = 0; i < NUM_AXIS; i++)
+	{
+		length2 += float(mergeDist[i]) * float(mergeDist[i]);
+		for (axis_t j = i + 1; j < NUM_AXIS; j++)
+		{
+			float cross = float(_pod._mergeDist[i]) * float(mergeDist[j]) - float(_pod._mergeDist[j]) * float(mergeDist[i]);
+			cross2 += cross * cross;
+		}
+	}
+
+	float deviation = _pod._mergeDeviation + sqrt(cross2 / length2);
+	if (deviation > _pod._mergeTolerance)
+		return false;
+
+	bool mergeDirectionUp[NUM_AXIS];
+	for (i = 0; i < NUM_AXIS; i++)
+		mergeDirectionUp[i] = dist[i] ? directionUp[i] : mv.GetDirectionUp(i);
+
+	SMovement mvMerge;
+	mvMerge.InitMove(this, GetPrevMovement(idx), mergeSteps, mergeDist, mergeDirectionUp, timerMax);
+
+	{
+		CCriticalRegion crit;
+		if (!mv.IsReadyForMove())
+			return false;									// started in the meantime
+		mv = mvMerge;
+	}
+
+	memcpy(_pod._mergeDist, mergeDist, sizeof(_pod._mergeDist));
+	_pod._mergeDeviation = deviation;
+
+	OptimizeMovementQueue(false);
+
+	return true;
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 void CStepper::QueueWait(const mdist_t dist, timer_t timerMax, bool checkWaitConditional)
 {
 	WaitUntilCanQueue();
 	_movements._queue.NextTail().InitWait(this, dist, timerMax, checkWaitConditional);
+	NoMergeMove();
 
 	EnqueuAndStartTimer(true);
 }
@@ -331,11 +426,15 @@ void CStepper::SMovement::InitMove(CStepper*pStepper, SMovement* mvPrev, mdist_t
 	_pod._move._timerMax = timerMax;
 
 	_backlash = false;
+	_planned = false;
+#ifdef USE_ARCMOVE
+	_isArc = false;
+#endif
 
 	_steps = steps;
 	memcpy(_distance_, dist, sizeof(_distance_));
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	strcpy_s(_mvMSCInfo, _pStepper->MSCInfo);
 #endif
 
@@ -356,6 +455,8 @@ void CStepper::SMovement::InitMove(CStepper*pStepper, SMovement* mvPrev, mdist_t
 	}
 
 	// and acc/dec values
+	// axis moves d/steps of the "main" axis => a(axis) = a(move) * d/steps
+	// timer ~ 1/sqrt(a) => timer(move) >= timer(axis) * sqrt(d/steps)
 
 	_pod._move._timerAcc = 0;
 	_pod._move._timerDec = 0;
@@ -365,19 +466,43 @@ void CStepper::SMovement::InitMove(CStepper*pStepper, SMovement* mvPrev, mdist_t
 		mdist_t d = dist[i];
 		if (d)
 		{
-			timer_t accdec = (timer_t) MulDivU32(pStepper->_pod._timerAcc[i], d, _steps);
+			mdist_t s = _steps;
+#ifndef use16bit
+			while (s > 0xffff)		// d*65536 must not overrun
+			{
+				s /= 2;
+				d /= 2;
+			}
+#endif
+			unsigned long sqrtratio = _ulsqrt(MulDivU32(d, 65536, s));	// sqrt(d/steps) * 256
+
+			timer_t accdec = (timer_t) RoundMulDivU32(pStepper->_pod._timerAcc[i], sqrtratio, 256);
 			if (accdec > _pod._move._timerAcc)
 				_pod._move._timerAcc = accdec;
 
-			accdec = (timer_t) MulDivU32(pStepper->_pod._timerDec[i], d, _steps);
+			accdec = (timer_t) RoundMulDivU32(pStepper->_pod._timerDec[i], sqrtratio, 256);
 			if (accdec > _pod._move._timerDec)
 				_pod._move._timerDec = accdec;
 		}
 	}
 
+#ifndef REDUCED_SIZE
+	if (pStepper->_pod._rampType == RampSCurve)
+	{
+		// s-curve: peak acceleration is 1.5 * a of the ramp => plan with 2/3 a (timer * sqrt(3/2))
+		// peak is the configured acc, the ramps are 1.5 * longer as the trapezoid
+		_pod._move._timerAcc = (timer_t) RoundMulDivU32(_pod._move._timerAcc, 1254, 1024);
+		_pod._move._timerDec = (timer_t) RoundMulDivU32(_pod._move._timerDec, 1254, 1024);
+	}
+#endif
+
 	// calculate StepMultiplier and adjust distance
 
+#ifdef USE_DYNAMICSTEPMULTIPLIER
+	uint8_t maxMultiplier = 1;		// multiplier is calculated for each step in CalcNextSteps
+#else
 	uint8_t maxMultiplier = CStepper::GetStepMultiplier(_pod._move._timerMax);
+#endif
 	_lastStepDirCount = 0;
 	_dirCount = 0;
 
@@ -492,6 +617,34 @@ void CStepper::SMovement::InitMove(CStepper*pStepper, SMovement* mvPrev, mdist_t
 
 ////////////////////////////////////////////////////////
 
+#ifdef USE_ARCMOVE
+
+void CStepper::SMovement::InitArc(CStepper*pStepper, SMovement* mvPrev, mdist_t steps, const SArc& arc, timer_t timerMax)
+{
+	// speed and ramp as a move with "steps" on both axes (timer is for one step of the axis moving in direction of the tangent)
+	// the junction depends on the tangent at the start => calculate again
+
+	mdist_t dist[NUM_AXIS] = { 0 };
+	bool directionUp[NUM_AXIS] = { false };
+
+	dist[arc._axis[0]] = steps;
+	dist[arc._axis[1]] = steps;
+
+	InitMove(pStepper, mvPrev, steps, dist, directionUp, timerMax);
+
+	_arc = arc;
+	_isArc = true;
+
+	if (mvPrev && mvPrev->IsActiveMove())
+	{
+		CalcMaxJunktionSpeed(mvPrev);
+	}
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 void CStepper::SMovement::InitStop(SMovement* mvPrev, timer_t timer, timer_t dectimer)
 {
 	// must be a copy off current (executing) move
@@ -499,6 +652,11 @@ void CStepper::SMovement::InitStop(SMovement* mvPrev, timer_t timer, timer_t dec
 
 	mvPrev->_steps = _pStepper->_movementstate._n;		// stop now
 
+#ifdef USE_ARCMOVE
+	mvPrev->_arc._stop = true;							// arc: end with _steps (not at end position)
+	_arc._stop = true;									// arc: continue with current position
+#endif
+
 	_pod._move._timerDec = dectimer;
 
 	mdist_t downstpes = CStepper::GetDecSteps(timer, dectimer);
@@ -509,6 +667,7 @@ void CStepper::SMovement::InitStop(SMovement* mvPrev, timer_t timer, timer_t dec
 	}
 
 	_state = SMovement::StateReadyMove;
+	_planned = false;
 
 	_steps = downstpes;
 
@@ -562,6 +721,56 @@ mdist_t CStepper::SMovement::GetDistance(axis_t axis)
 
 ////////////////////////////////////////////////////////
 
+#ifdef USE_ARCMOVE
+
+void CStepper::SMovement::GetArcTangent(sdist_t tangent[2], bool atEnd) const
+{
+	// counterclockwise: (-y, x)
+
+	const sdist_t* pos = atEnd ? _arc._end : _arc._start;
+
+	tangent[0] = _arc._clockwise ? pos[1] : -pos[1];
+	tangent[1] = _arc._clockwise ? -pos[0] : pos[0];
+}
+
+////////////////////////////////////////////////////////
+
+mdist_t CStepper::SMovement::GetJunctionDistance(axis_t axis, bool atEnd)
+{
+	// arc: distance of a line with the direction of the tangent (and _steps)
+
+	if (!IsArc())
+		return GetDistance(axis);
+
+	if (axis != _arc._axis[0] && axis != _arc._axis[1])
+		return 0;
+
+	sdist_t tangent[2];
+	GetArcTangent(tangent, atEnd);
+
+	udist_t t0 = abs(tangent[0]);
+	udist_t t1 = abs(tangent[1]);
+
+	return (mdist_t)(((uint64_t)(axis == _arc._axis[0] ? t0 : t1)) * _steps / max(t0, t1));
+}
+
+////////////////////////////////////////////////////////
+
+bool CStepper::SMovement::GetJunctionDirectionUp(axis_t axis, bool atEnd)
+{
+	if (!IsArc())
+		return GetDirectionUp(axis);
+
+	sdist_t tangent[2];
+	GetArcTangent(tangent, atEnd);
+
+	return (axis == _arc._axis[0] ? tangent[0] : tangent[1]) > 0;
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
 uint8_t CStepper::SMovement::GetMaxStepMultiplier()
 {
 	register DirCount_t count = _dirCount;
@@ -705,7 +914,7 @@ void CStepper::SMovement::SRamp::RampRun(SMovement* pMovement)
 
 bool CStepper::SMovement::Ramp(SMovement*mvNext)
 {
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	assert(IsActiveMove());
 	assert(mvNext == NULL || mvNext->IsActiveMove());
 #endif
@@ -768,7 +977,7 @@ void CStepper::SMovement::AdjustJunktionSpeedH2T(SMovement*mvPrev, SMovement*mvN
 
 	if (mvNext != NULL)
 	{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 		assert(mvNext->IsActiveMove());
 #endif
 		// next element available, calculate junction speed
@@ -782,6 +991,13 @@ void CStepper::SMovement::AdjustJunktionSpeedH2T(SMovement*mvPrev, SMovement*mvN
 		_pod._move._timerEndPossible = _pod._move._ramp._timerStop;
 		if (mvNext != NULL) mvNext->_pod._move._timerJunctionToPrev = _pod._move._ramp._timerStop;
 	}
+
+	if (mvNext != NULL && mvNext->_pod._move._timerJunctionToPrev == mvNext->_pod._move._timerMaxJunction)
+	{
+		// junction is at max speed, a move added at the tail can only make _timerStartPossible faster 
+		// => the junction will not change anymore, set the watermark
+		mvNext->_planned = true;
+	}
 }
 
 ////////////////////////////////////////////////////////
@@ -829,7 +1045,7 @@ bool CStepper::SMovement::AdjustJunktionSpeedT2H(SMovement*mvPrev, SMovement*mvN
 void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 {
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	assert(IsActiveMove());
 	assert(mvPrev==NULL || mvPrev->IsActiveMove());
 #endif
@@ -840,7 +1056,7 @@ void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 	// default => fastest move (no jerk)
 	_pod._move._timerMaxJunction = min(mvPrev->_pod._move._timerMax, _pod._move._timerMax);
 	timer_t timerMaxJunction;
-	timer_t timerMaxJunctionAcc = mvPrev->GetUpTimerAcc();
+	timer_t timerMaxJunctionAcc = max(mvPrev->GetUpTimerAcc(), GetUpTimerAcc());	// stop and go => start of both moves must be possible
 
 	mdist_t s1 = mvPrev->_steps;
 	mdist_t s2 = _steps;
@@ -849,7 +1065,7 @@ void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 
 	for (mainaxis = 0; mainaxis < NUM_AXIS; mainaxis++)
 	{
-		if (s1 == mvPrev->GetDistance(mainaxis) && s2 == GetDistance(mainaxis) && mvPrev->GetDirectionUp(mainaxis) == GetDirectionUp(mainaxis))
+		if (s1 == mvPrev->GetJunctionDistance(mainaxis, true) && s2 == GetJunctionDistance(mainaxis, false) && mvPrev->GetJunctionDirectionUp(mainaxis, true) == GetJunctionDirectionUp(mainaxis, false))
 		{
 			_pod._move._timerMaxJunction = (long(mvPrev->_pod._move._timerMax) + long(_pod._move._timerMax)) / 2;
 			break;
@@ -875,8 +1091,8 @@ void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 	{
 		if (i != mainaxis)
 		{
-			mdist_t d1 = mvPrev->GetDistance(i);
-			mdist_t d2 = GetDistance(i);
+			mdist_t d1 = mvPrev->GetJunctionDistance(i, true);
+			mdist_t d2 = GetJunctionDistance(i, false);
 
 			steprate_t v1 = _pStepper->TimerToSpeed(mvPrev->_pod._move._timerMax);
 			steprate_t v2 = _pStepper->TimerToSpeed(_pod._move._timerMax);
@@ -887,7 +1103,7 @@ void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 
 			long vdiff;
 
-			if (v1 == 0 || v2 == 0 || mvPrev->GetDirectionUp(i) == GetDirectionUp(i))
+			if (v1 == 0 || v2 == 0 || mvPrev->GetJunctionDirectionUp(i, true) == GetJunctionDirectionUp(i, false))
 			{
 				// same direction (v1 and v2 not 0)
 				vdiff = v1 > v2 ? v1 - v2 : v2 - v1;
@@ -920,8 +1136,63 @@ void CStepper::SMovement::CalcMaxJunktionSpeed(SMovement*mvPrev)
 			}
 		}
 	}
+
+#ifndef REDUCED_SIZE
+	if (_pStepper->_pod._junctionDeviation != 0)
+	{
+		// use the corner tolerance if faster than the jerk limit
+		timer_t timerDeviation = max(GetJunctionDeviationTimer(mvPrev, timerMaxJunctionAcc), timerMaxJunction_);
+		_pod._move._timerMaxJunction = min(_pod._move._timerMaxJunction, timerDeviation);
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+#ifndef REDUCED_SIZE
+
+timer_t CStepper::SMovement::GetJunctionDeviationTimer(SMovement*mvPrev, timer_t timerAcc)
+{
+	// junction deviation: the corner is passed like an arc touching both moves with the distance "deviation" to the corner
+	// theta: angle between the moves at the corner (180 => straight)
+	// r = deviation * sin(theta/2) / (1 - sin(theta/2))
+	// centripetal acceleration v*v/r must not exceed acc (see MoveArc): timer >= timerAcc / sqrt(2 * r)
+
+	float dot = 0.0f;
+	float len1 = 0.0f;
+	float len2 = 0.0f;
+
+	for (axis_t i = 0; i < NUM_AXIS; i++)
+	{
+		float d1 = (float)mvPrev->GetJunctionDistance(i, true);
+		float d2 = (float)GetJunctionDistance(i, false);
+		if (mvPrev->GetJunctionDirectionUp(i, true) != GetJunctionDirectionUp(i, false))
+			d2 = -d2;
+
+		dot += d1 * d2;
+		len1 += d1 * d1;
+		len2 += d2 * d2;
+	}
+
+	if (len1 == 0.0f || len2 == 0.0f)
+		return (timer_t)-1;
+
+	float cos_theta = -dot / sqrt(len1 * len2);
+	float sin_theta_d2 = sqrt(max(0.0f, 0.5f * (1.0f - cos_theta)));
+
+	if (sin_theta_d2 < 0.01f)
+		return (timer_t)-1;										// reverse => stop
+
+	if (sin_theta_d2 > 0.999f)
+		return 0;												// straight => no limit
+
+	float radius = _pStepper->_pod._junctionDeviation * sin_theta_d2 / (1.0f - sin_theta_d2);
+
+	return (timer_t)min(float((timer_t)-1), timerAcc / sqrt(2.0f * radius));
 }
 
+#endif
+
 ////////////////////////////////////////////////////////
 
 CStepper::SMovement* CStepper::GetNextMovement(uint8_t idx)
@@ -968,13 +1239,17 @@ void CStepper::OptimizeMovementQueue(bool /* force */)
 
 	uint8_t idx;
 	uint8_t idxnochange = _movements._queue.H2TInit();
+	uint8_t count = 0;
 
 	////////////////////////////////////
 	// calculate junction (max) speed!
+	// stop at the "planned" watermark (junction is at max) and after _planMaxCount (MOVEMENTPLANMAXCOUNT) moves
+	// => older moves keep their (slower) junction speed, the time for a QueueMove does not depend on the queue length
 
 	for (idx = _movements._queue.T2HInit(); _movements._queue.T2HTest(idx); idx = _movements._queue.T2HInc(idx))
 	{
-		if (_movements._queue.Buffer[idx].AdjustJunktionSpeedT2H(GetPrevMovement(idx), GetNextMovement(idx)))
+		SMovement& mv = _movements._queue.Buffer[idx];
+		if (mv._planned || count++ >= _pod._planMaxCount || mv.AdjustJunktionSpeedT2H(GetPrevMovement(idx), GetNextMovement(idx)))
 		{
 			idxnochange = idx;
 			break;
@@ -1215,6 +1490,123 @@ mdist_t CStepper::GetSteps(timer_t timer1, timer_t timer2, timer_t timerstart, t
 	return GetDecSteps(timer1, timer2, timerstop);
 }
 
+////////////////////////////////////////////////////////
+// timer of a ramp (from v=0) after n steps: C0 * g(n)
+// g(n) = g(n-1) * (4n-1)/(4n+1), g(0) = 1 => same as the recurrence in CalcTimerAcc (without integer rest)
+// ramptab: g(n) * 2^(16 + octave/2), octave = log2(n) (0 for n=0)
+//          one value for each n < 64, 32 values for each octave above => linear interpolation, no division
+//          the interpolation error is the same in each octave (g is ~1/sqrt(n)) => 32 values: max 1 tick to the recurrence (16 bit timer)
+// g(4n) = g(n)/2 for big n => n >= 2^16 is scaled down (32 bit only)
+
+static const unsigned short ramptab[] PROGMEM =
+{
+	65535, 39322, 30583, 25878, 45668, 41318, 38013, 35391, 33246, 31449, 29915, 28586, 27419, 26384, 25458, 24624,	// 0..
+	47732, 46349, 45079, 43908, 42824, 41816, 40876, 39997, 39173, 38397, 37666, 36974, 36320, 35699, 35109, 34547,	// 16..
+	34012, 33500, 33011, 32543, 32094, 31663, 31249, 30851, 30468, 30099, 29743, 29399, 29067, 28745, 28435, 28134,	// 32..
+	27842, 27560, 27285, 27019, 26761, 26509, 26265, 26027, 25796, 25571, 25351, 25137, 24929, 24725, 24526, 24333,	// 48..
+	48286, 47555, 46855, 46186, 45545, 44929, 44338, 43769, 43222, 42695, 42187, 41696, 41223, 40764, 40321, 39892,	// 64..
+	39477, 39074, 38683, 38304, 37936, 37578, 37230, 36891, 36562, 36241, 35929, 35624, 35328, 35038, 34755, 34480,	// 96..
+	34210, 33690, 33193, 32717, 32261, 31823, 31403, 30999, 30610, 30236, 29875, 29527, 29190, 28865, 28550, 28246,	// 128..
+	27951, 27665, 27387, 27118, 26857, 26603, 26356, 26116, 25882, 25655, 25433, 25217, 25006, 24801, 24600, 24405,	// 192..
+	48428, 47690, 46984, 46310, 45663, 45043, 44447, 43874, 43323, 42793, 42281, 41787, 41310, 40849, 40403, 39972,	// 256..
+	39554, 39149, 38756, 38374, 38004, 37644, 37294, 36954, 36623, 36301, 35987, 35681, 35383, 35092, 34808, 34531,	// 384..
+	34260, 33738, 33238, 32760, 32303, 31863, 31442, 31036, 30646, 30271, 29908, 29559, 29221, 28895, 28579, 28274,	// 512..
+	27978, 27691, 27413, 27143, 26881, 26626, 26379, 26138, 25904, 25676, 25453, 25237, 25026, 24820, 24619, 24423,	// 768..
+	48463, 47724, 47017, 46341, 45693, 45071, 44475, 43901, 43349, 42817, 42305, 41810, 41332, 40871, 40424, 39992,	// 1024..
+	39573, 39167, 38774, 38392, 38021, 37661, 37311, 36970, 36638, 36316, 36001, 35695, 35396, 35105, 34821, 34544,	// 1536..
+	34273, 33750, 33250, 32771, 32313, 31874, 31451, 31046, 30655, 30279, 29917, 29567, 29229, 28902, 28587, 28281,	// 2048..
+	27985, 27698, 27419, 27149, 26887, 26632, 26385, 26144, 25909, 25681, 25459, 25242, 25031, 24825, 24624, 24428,	// 3072..
+	48472, 47732, 47025, 46348, 45700, 45078, 44481, 43907, 43355, 42823, 42310, 41816, 41338, 40876, 40429, 39997,	// 4096..
+	39578, 39172, 38778, 38396, 38025, 37665, 37315, 36974, 36642, 36320, 36005, 35699, 35400, 35109, 34824, 34547,	// 6144..
+	34276, 33753, 33253, 32774, 32316, 31876, 31454, 31048, 30657, 30281, 29919, 29569, 29231, 28904, 28588, 28283,	// 8192..
+	27986, 27699, 27421, 27151, 26889, 26634, 26386, 26145, 25910, 25682, 25460, 25243, 25032, 24826, 24625, 24429,	// 12288..
+	48474, 47734, 47027, 46350, 45702, 45080, 44483, 43909, 43357, 42825, 42312, 41817, 41339, 40877, 40430, 39998,	// 16384..
+	39579, 39173, 38780, 38398, 38027, 37666, 37316, 36975, 36643, 36320, 36006, 35700, 35401, 35109, 34825, 34548,	// 24576..
+	34277, 33753, 33253, 32775, 32316, 31877, 31454, 31049, 30658, 30282, 29919, 29569, 29231, 28905, 28589, 28283,	// 32768..
+	27987, 27700, 27421, 27151, 26889, 26634, 26386, 26145, 25911, 25683, 25460, 25243, 25032, 24826, 24625, 24429,	// 49152..
+	48475			// 65536
+};
+
+timer_t CStepper::GetRampTimer(timer_t timer0, mdist_t n)
+{
+	uint8_t shift = 16;
+
+#if !defined(use16bit)
+	while (n >= 0x10000)
+	{
+		n /= 4;
+		shift++;
+	}
+#endif
+
+	unsigned short m = (unsigned short) n;
+	uint8_t octave = 0;
+
+	if (m >= 256) { m >>= 8; octave = 8; }
+	if (m >= 16)  { m >>= 4; octave += 4; }
+	if (m >= 4)   { m >>= 2; octave += 2; }
+	if (m >= 2)   { octave++; }
+
+	unsigned short g;
+
+	if (n < 64)
+	{
+		g = pgm_read_word(&ramptab[n]);
+	}
+	else
+	{
+		uint8_t segshift = octave - 5;
+		uint8_t seg = (uint8_t)(n >> segshift);			// 32..63
+		unsigned short idx = 64 + (octave - 6) * 32 + (seg - 32);
+
+		unsigned short ga = pgm_read_word(&ramptab[idx]);
+		unsigned short gb = pgm_read_word(&ramptab[idx + 1]);
+
+		if (seg == 63 && (octave & 1))
+			gb /= 2;									// next octave uses one more shift
+
+		unsigned short frac = (unsigned short) n & ((1 << segshift) - 1);
+		g = ga - (unsigned short)(((unsigned long)(ga - gb) * frac) >> segshift);
+	}
+
+	shift += octave / 2;
+
+#if defined(use16bit)
+	unsigned long timer = (unsigned long) timer0 * g;
+#else
+	uint64_t timer = (uint64_t) timer0 * g;
+#endif
+
+	return (timer_t)((timer + (1ul << (shift - 1))) >> shift);
+}
+
+////////////////////////////////////////////////////////
+// s-curve: step n of a ramp with "steps" is mapped to the index of the ramp with constant a
+// index = steps * s(n/steps), s(p) = 3p^2 - 2p^3 
+// => same steps and same start/end speed as the trapezoid (no change of the planner)
+// => acceleration 0 at start and end of the ramp, max 1.5 * a in the middle (the movement uses 2/3 a, see InitMove)
+
+mdist_t CStepper::GetSCurveSteps(mdist_t n, mdist_t steps)
+{
+	if (n >= steps)
+		return steps;
+
+#if defined(use16bit)
+	unsigned long p = (((unsigned long)n) << 16) / steps;				// 0..65535
+#else
+	unsigned long p = (unsigned long)((((uint64_t)n) << 16) / steps);
+#endif
+
+	unsigned long p2 = (p * p) >> 16;
+	unsigned long s = (p2 * ((3 * 65536ul - 2 * p) >> 2)) >> 14;		// 0..65536
+
+#if defined(use16bit)
+	return (mdist_t)((s * steps) >> 16);
+#else
+	return (mdist_t)((((uint64_t)s) * steps) >> 16);
+#endif
+}
+
 ////////////////////////////////////////////////////////
 
 void CStepper::StopMove(steprate_t v0Dec)
@@ -1394,7 +1786,7 @@ inline void CStepper::StepOut()
 		dir_count = stepbuffer->DirStepCount;
 	}
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	StepBegin(&_steps.Head());
 #endif
 	// AVR: div with 256 is faster than 16 (loop shift)
@@ -1623,7 +2015,7 @@ void CStepper::StepRequest(bool isr)
 #if defined (stepperstatic_)
 
 CStepper::SMovementState CStepper::_movementstate;
-CRingBufferQueue<CStepper::SStepBuffer, STEPBUFFERSIZE> CStepper::_steps;
+CStepper::StepBufferQueue_t CStepper::_steps;
 CStepper::SMovements CStepper::_movements;
 CStepper* CStepper::SMovement::_pStepper;
 
@@ -1646,31 +2038,184 @@ void CStepper::SMovementState::Init(SMovement* pMovement)
 		_timer = pMovement->_pod._wait._timer;
 	}
 	
-	steps = (steps / _count) >> 1;
-	for (axis_t i = 0; i < NUM_AXIS; i++)
-		_add[i] = steps;
+	// wait/io: _distance_ is 0 => no moving axis
+#ifdef USE_DYNAMICSTEPMULTIPLIER
+	_bresenham.Init(pMovement->_distance_, steps, pMovement->_dirCount, (steps / _count) >> 1, false);
+#else
+	_bresenham.Init(pMovement->_distance_, steps, pMovement->_dirCount, (steps / _count) >> 1, true);
+#endif
 	_n = 0;
 	_rest = 0;
 #ifndef REDUCED_SIZE
 	_sumTimer = 0;
 #endif
+
+#ifdef USE_ARCMOVE
+	if (pMovement->IsArc() && !pMovement->_arc._stop)
+	{
+		_arc.Init(pMovement);
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////
+
+#ifdef USE_ARCMOVE
+
+void CStepper::SMovementState::SArcState::Init(const SMovement* pMovement)
+{
+	_pos[0] = pMovement->_arc._start[0];
+	_pos[1] = pMovement->_arc._start[1];
+	_f = 0;
+	_octant = GetOctant(_pos[0], _pos[1]);
+	_transitions = pMovement->_arc._transitions;
+	_toEnd = false;
+	_diagonal = false;
+}
+
+////////////////////////////////////////////////////////
+
+uint8_t CStepper::SMovementState::SArcState::GetOctant(sdist_t x, sdist_t y)
+{
+	if (y > 0 || (y == 0 && x > 0))
+	{
+		if (x > 0)
+			return y < x ? 0 : 1;
+		return y > -x ? 2 : 3;
+	}
+
+	if (x < 0)
+		return -y < -x ? 4 : 5;
+	return -y > x ? 6 : 7;
 }
 
 ////////////////////////////////////////////////////////
+// called in interrupt => must be "fast"
 
-bool CStepper::SMovementState::CalcTimerAcc(timer_t maxtimer, mdist_t n, uint8_t cnt)
+DirCount_t CStepper::SMovementState::SArcState::Step(const SMovement* pMovement)
+{
+	// midpoint circle: the axis with the smaller coordinate (abs) steps in direction of the tangent,
+	// the other axis steps if this is nearer to the circle (f = x*x + y*y - r*r)
+	// the end octant is found by counting the octant boundaries, then the arc ends if the next step passes the end
+
+	const SMovement::SArc& arc = pMovement->_arc;
+
+	sdist_t pos[2] = { _pos[0], _pos[1] };
+
+	if (!_toEnd)
+	{
+		bool ccw = !arc._clockwise;
+
+		uint8_t major = abs(pos[0]) > abs(pos[1]) ? 1 : 0;
+		uint8_t minor = 1 - major;
+
+		// tangent counterclockwise: (-y, x)
+		signed char d = (major == 1 ? pos[0] > 0 : pos[1] < 0) == ccw ? 1 : -1;
+
+		long f = _f + 2 * pos[major] * d + 1;
+		pos[major] += d;
+
+		sdist_t m = abs(pos[minor]);
+		if (f >= m)
+		{
+			f += 1 - 2 * m;													// inside
+			pos[minor] += pos[minor] > 0 ? -1 : 1;
+		}
+		else if (f < -m)
+		{
+			f += 1 + 2 * m;													// outside
+			pos[minor] += pos[minor] > 0 ? 1 : -1;
+		}
+
+		uint8_t transitions = _transitions;
+		uint8_t octant = _octant;
+
+		if (transitions != 0)
+		{
+			octant = GetOctant(pos[0], pos[1]);
+			if (octant != _octant)
+			{
+				if (octant == ((_octant + (ccw ? 1 : 7)) & 7))
+					transitions--;
+				else
+					transitions++;
+			}
+		}
+
+		if (transitions == 0)
+		{
+			int64_t cross = (int64_t)pos[0] * arc._end[1] - (int64_t)pos[1] * arc._end[0];
+			_toEnd = ccw ? cross <= 0 : cross >= 0;						// end is not ahead
+		}
+
+		if (!_toEnd)
+		{
+			_f = f;
+			_octant = octant;
+			_transitions = transitions;
+		}
+		else
+		{
+			pos[0] = _pos[0];
+			pos[1] = _pos[1];
+		}
+	}
+
+	if (_toEnd)
+	{
+		// from the last position on the circle (max ARCMOVE_MAXRADIUSDIFF) to the end
+
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			if (arc._end[i] > pos[i])		pos[i]++;
+			else if (arc._end[i] < pos[i])	pos[i]--;
+		}
+	}
+
+	DirCount_t dirCount = 0;
+	uint8_t axescount = 0;
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		if (pos[i] != _pos[i])
+		{
+			dirCount += ((DirCount_t)(pos[i] > _pos[i] ? 9 : 1)) << (arc._axis[i] * 4);		// count 1 + direction (8)
+			_pos[i] = pos[i];
+			axescount++;
+		}
+	}
+
+	_diagonal = axescount == 2;
+
+	return dirCount;
+}
+
+#endif
+
+////////////////////////////////////////////////////////
+
+bool CStepper::SMovementState::CalcTimerAcc(timer_t maxtimer, timer_t timer0, mdist_t n, uint8_t cnt)
 {
 	// use for float: Cn = Cn-1 - 2*Cn-1 / (4*N + 1)
 	// use for INTEGER:
 	// In = ((2*In-1)+Rn-1) / (4*N + 1)		=> quot
 	// Rn = ((2*In-1)+Rn-1) % (4*N + 1)		=> remainer of division
 	// Cn = Cn-1 - In
+	// USE_RAMPTABLE: Cn = C0 * g(N), see GetRampTimer
 
 	if (maxtimer < _timer)
 	{
+#ifdef USE_RAMPTABLE
+		(void) cnt;
+		timer_t timer = GetRampTimer(timer0, n);
+		if (timer < _timer)
+			_timer = timer;
+#else
+		(void) timer0;
 		mudiv_t udivremainer = mudiv(_timer*(2 * cnt) + _rest, n * 4 + 2 - cnt);
 		_rest = udivremainer.rem;
 		_timer = _timer - udivremainer.quot;
+#endif
 		if (maxtimer >= _timer)
 		{
 			_timer = maxtimer;
@@ -1682,13 +2227,14 @@ bool CStepper::SMovementState::CalcTimerAcc(timer_t maxtimer, mdist_t n, uint8_t
 
 ////////////////////////////////////////////////////////
 
-bool CStepper::SMovementState::CalcTimerDec(timer_t mintimer, mdist_t n, uint8_t cnt)
+bool CStepper::SMovementState::CalcTimerDec(timer_t mintimer, timer_t timer0, mdist_t n, uint8_t cnt)
 {
 	// use for float: Cn = Cn-1 + 2*Cn-1 / (4*N - 1)
 	// use for INTEGER:
 	// In = ((2*In-1)+Rn-1) / (4*N - 1)		=> quot
 	// Rn = ((2*In-1)+Rn-1) % (4*N - 1)		=> remainer of division
 	// Cn = Cn-1 - In
+	// USE_RAMPTABLE: Cn = C0 * g(N-cnt), see GetRampTimer
 
 	if (mintimer > _timer)
 	{
@@ -1697,9 +2243,16 @@ bool CStepper::SMovementState::CalcTimerDec(timer_t mintimer, mdist_t n, uint8_t
 			_timer = mintimer;
 			return true;
 		}
+#ifdef USE_RAMPTABLE
+		timer_t timer = GetRampTimer(timer0, n > cnt ? n - cnt : 0);
+		if (timer > _timer)
+			_timer = timer;
+#else
+		(void) timer0;
 		mudiv_t udivremainer = mudiv(_timer*(2 * cnt) + _rest, n * 4 - 1 - cnt);
 		_rest = udivremainer.rem;
 		_timer = _timer + udivremainer.quot;
+#endif
 		if (mintimer <= _timer)
 		{
 			_timer = mintimer;
@@ -1711,6 +2264,38 @@ bool CStepper::SMovementState::CalcTimerDec(timer_t mintimer, mdist_t n, uint8_t
 
 ////////////////////////////////////////////////////////
 
+bool CStepper::SMovementState::CalcTimerSCurve(timer_t endtimer, timer_t timer0, mdist_t n, bool acc)
+{
+	// no recurrence: the s-curve jumps on the ramp of constant a => use ramptab 
+	// timer changes only in direction of the ramp
+
+	timer_t timer = GetRampTimer(timer0, n);
+
+	if (acc)
+	{
+		if (timer < _timer)
+			_timer = timer;
+		if (endtimer >= _timer)
+		{
+			_timer = endtimer;
+			return true;
+		}
+	}
+	else
+	{
+		if (timer > _timer)
+			_timer = timer;
+		if (endtimer <= _timer)
+		{
+			_timer = endtimer;
+			return true;
+		}
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////
+
 bool CStepper::SMovement::IsEndWait() const
 {
 	if (_pod._wait._checkWaitConditional)
@@ -1782,6 +2367,19 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 		register mdist_t n = pState->_n;
 		register uint8_t count = pState->_count;
 
+#ifdef USE_ARCMOVE
+		if (IsArc())
+		{
+			// _steps of arc is estimated => end at end position or finish with timer of last step
+			// stopped arc (StopMove) => end with _steps
+
+			if (pState->_arc.IsDone(this))
+				n = _steps;
+			else if (_steps <= n && !_arc._stop)
+				n = _steps - 1;
+		}
+#endif
+
 		if (_steps <= n)
 		{
 			// End of move/wait/io
@@ -1796,6 +2394,64 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 			return true;
 		}
 		
+#ifndef USE_DYNAMICSTEPMULTIPLIER
+		if (_state == StateRun && !IsArc() && CalcNextStepsRun())
+		{
+			continue;
+		}
+#endif
+
+#ifdef USE_ARCMOVE
+		if (IsArc())
+		{
+			// circular interpolation, count is 1
+			pStepper->_steps.NextTail().Init(pState->_arc.Step(this));
+		}
+		else
+#endif
+#ifdef USE_DYNAMICSTEPMULTIPLIER
+		if (_state != StateWait)
+		{
+			// calculate f for step-buffer
+			// multiplier depends on the current speed => add "count" single steps (bresenham) to one step-buffer entry
+			// the rate does not change with the multiplier (timer*count)
+
+			count = CStepper::GetStepMultiplier(pState->_timer);
+			if (_steps - n < count)
+				count = (uint8_t)(_steps - n);	// must fit in unsinged char
+			pState->_count = count;
+
+			register DirCount_t stepcount = 0;
+
+			if (_backlash)
+			{
+				DirCountByte_t x = DirCountByte_t(); //POD
+				x.byte.byteInfo.nocount = 1;
+				stepcount += x.all;
+			}
+
+			for (i = 0; i < pState->_bresenham._axisCount; i++)
+			{
+				uint8_t axiscount = 0;
+				for (uint8_t j = 0; j < count; j++)
+				{
+					if (pState->_bresenham.Step(i, _steps))
+						axiscount++;
+				}
+				if (axiscount)
+				{
+					// _dirCount[i] is count 1 + direction, lowest bit is the "one" of the axis
+					register DirCount_t dirCount = pState->_bresenham._dirCount[i];
+					stepcount += dirCount + (dirCount & (0 - dirCount)) * (axiscount - 1);
+				}
+			}
+			pStepper->_steps.NextTail().Init(stepcount);
+		}
+		else
+		{
+			pStepper->_steps.NextTail().Init(0);
+		}
+#else
 		{
 			// calculate f for step-buffer
 
@@ -1808,7 +2464,6 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 			else
 			{
 				register DirCount_t stepcount = 0;
-				register DirCount_t mask = 15;
 
 				if (_backlash)
 				{
@@ -1818,23 +2473,11 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 					stepcount += x.all; 
 				}
 
-				for (i = 0;; i++)
-				{
-					// Check overflow!
-					mdist_t oldadd = pState->_add[i];
-					pState->_add[i] += _distance_[i];
-					if (pState->_add[i] >= _steps || pState->_add[i] < oldadd)
-					{
-						pState->_add[i] -= _steps;
-						stepcount += mask&_dirCount;
-					}
-					if (i == NUM_AXIS - 1)
-						break;
-					mask *= 16;
-				}
+				stepcount += pState->_bresenham.Step(_steps);
 				pStepper->_steps.NextTail().Init(stepcount);
 			}
 		}
+#endif
 
 		////////////////////////////////////
 		// calc new timer
@@ -1885,11 +2528,49 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 				}
 			}
 
+#ifndef REDUCED_SIZE
+			if (pStepper->_pod._rampType == RampSCurve)
+			{
+				mdist_t downSteps = _steps - _pod._move._ramp._downStartAt;
+
+				switch (_state)
+				{
+					case StateUpAcc:
+
+						if (pState->CalcTimerSCurve(_pod._move._ramp._timerRun, GetUpTimerAcc(), _pod._move._ramp._nUpOffset + GetSCurveSteps(n, _pod._move._ramp._upSteps), true))
+						{
+							_state = StateRun;
+						}
+						break;
+
+					case StateUpDec:
+
+						if (pState->CalcTimerSCurve(_pod._move._ramp._timerRun, GetUpTimerDec(), _pod._move._ramp._nUpOffset - GetSCurveSteps(n, _pod._move._ramp._upSteps), false))
+						{
+							_state = StateRun;
+						}
+						break;
+
+					case StateDownDec:
+
+						pState->CalcTimerSCurve(_pod._move._ramp._timerStop, GetDownTimerDec(), downSteps + _pod._move._ramp._nDownOffset - GetSCurveSteps(n - _pod._move._ramp._downStartAt, downSteps), false);
+						break;
+
+					case StateDownAcc:
+
+						pState->CalcTimerSCurve(_pod._move._ramp._timerStop, GetDownTimerAcc(), _pod._move._ramp._nDownOffset + 1 + GetSCurveSteps(n - _pod._move._ramp._downStartAt, downSteps) - downSteps, true);
+						break;
+
+					default: break;
+				}
+			}
+			else
+#endif
 			switch (_state)
 			{
 				case StateUpAcc:
 
-					if (pState->CalcTimerAcc(_pod._move._ramp._timerRun, n + _pod._move._ramp._nUpOffset, count))
+					if (pState->CalcTimerAcc(_pod._move._ramp._timerRun, GetUpTimerAcc(), n + _pod._move._ramp._nUpOffset, count))
 					{
 						_state = StateRun;
 					}
@@ -1897,7 +2578,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 				case StateUpDec:
 
-					if (pState->CalcTimerDec(_pod._move._ramp._timerRun,_pod._move._ramp._nUpOffset - n,count))
+					if (pState->CalcTimerDec(_pod._move._ramp._timerRun, GetUpTimerDec(), _pod._move._ramp._nUpOffset - n, count))
 					{
 						_state = StateRun;
 					}
@@ -1905,29 +2586,32 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 				case StateDownDec:
 
-					pState->CalcTimerDec(_pod._move._ramp._timerStop, _steps - n + _pod._move._ramp._nDownOffset, count);
+					pState->CalcTimerDec(_pod._move._ramp._timerStop, GetDownTimerDec(), _steps - n + _pod._move._ramp._nDownOffset, count);
 					break;
 
 				case StateDownAcc:
 
-					pState->CalcTimerAcc(_pod._move._ramp._timerStop, _pod._move._ramp._nDownOffset - (_steps - n - 1), count);
+					pState->CalcTimerAcc(_pod._move._ramp._timerStop, GetDownTimerAcc(), _pod._move._ramp._nDownOffset - (_steps - n - 1), count);
 					break;
 
 			}
 		}
 		
-		timer_t t = pState->_timer*count;
+#ifdef USE_DYNAMICSTEPMULTIPLIER
+		// count is from the timer before the step => accelerating, timer*count may be below the ISR limit
+		timer_t t = CalcStepTimer(pState->_timer*count < TIMER1VALUE(MAXINTERRUPTSPEED) ? timer_t(TIMER1VALUE(MAXINTERRUPTSPEED)) : timer_t(pState->_timer*count));
+#else
+		timer_t t = CalcStepTimer(pState->_timer*count);
+#endif
 
-#ifndef REDUCED_SIZE
-		if (pStepper->GetSpeedOverride()!=CStepper::SpeedOverride100P)
+#ifdef USE_ARCMOVE
+		if (IsArc() && pState->_arc._diagonal)
 		{
-			// slower => increase timer
-			unsigned long tl = RoundMulDivU32(t, CStepper::SpeedOverride100P, pStepper->GetSpeedOverride());
-			if (tl >= TIMER1MAX)	    t = TIMER1MAX;		// to slow
-			else if (tl < TIMER1MIN)    t = TIMER1MIN;		// to fast
-			else						t = (timer_t) tl;
+			t = (timer_t)RoundMulDivU32(t, 181, 128);		// both axes => distance is sqrt(2)
 		}
+#endif
 
+#ifndef REDUCED_SIZE
 		pState->_sumTimer += t;
 #endif
 
@@ -1941,7 +2625,7 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 		}
 		pState->_n = n;
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 		{
 			SStepBuffer& stepbuffer = pStepper->_steps.NextTail();
 			memcpy(stepbuffer._distance, _distance_, sizeof(stepbuffer._distance));
@@ -1961,6 +2645,97 @@ bool CStepper::SMovement::CalcNextSteps(bool continues)
 
 ////////////////////////////////////////////////////////
 
+timer_t CStepper::SMovement::CalcStepTimer(timer_t timer) const
+{
+#ifndef REDUCED_SIZE
+	if (_pStepper->GetSpeedOverride() != CStepper::SpeedOverride100P)
+	{
+		// slower => increase timer
+		unsigned long tl = RoundMulDivU32(timer, CStepper::SpeedOverride100P, _pStepper->GetSpeedOverride());
+		if (tl >= TIMER1MAX)	    return TIMER1MAX;		// to slow
+		else if (tl < TIMER1MIN)    return TIMER1MIN;		// to fast
+		return (timer_t) tl;
+	}
+#endif
+	return timer;
+}
+
+////////////////////////////////////////////////////////
+
+bool CStepper::SMovement::CalcNextStepsRun()
+{
+	// constant speed: timer, state and count do not change until _downStartAt
+	// => calculate all possible entries of the step buffer in one loop and enqueue them at once
+	// return false if nothing calculated (use CalcNextSteps for single step)
+
+	CStepper* pStepper = _pStepper;
+	SMovementState* pState = &pStepper->_movementstate;
+
+	register mdist_t n = pState->_n;
+	register uint8_t count = pState->_count;
+
+	if (_steps <= count)
+		return false;
+
+	// last step (with multiplier) and ramp down are calculated by CalcNextSteps
+	mdist_t endAt = _pod._move._ramp._downStartAt;
+	if (_steps - count < endAt)
+		endAt = _steps - count;
+
+	if (n >= endAt)
+		return false;
+
+	mdist_t stepcount = (endAt - n + count - 1) / count;
+
+	// do not calculate more entries than already in the buffer (the ISR must not run dry while calculating)
+	StepBufferQueue_t::index_t cnt = pStepper->_steps.Count();
+	if (pStepper->_steps.FreeCount() < cnt)
+		cnt = pStepper->_steps.FreeCount();
+	if (stepcount < cnt)
+		cnt = (StepBufferQueue_t::index_t) stepcount;
+
+	if (cnt <= 1)
+		return false;
+
+	register DirCount_t dirCount = 0;
+	if (_backlash)
+	{
+		DirCountByte_t x = DirCountByte_t(); //POD
+		x.byte.byteInfo.nocount = 1;
+		dirCount += x.all;
+	}
+
+	timer_t t = CalcStepTimer(pState->_timer*count);
+
+	for (StepBufferQueue_t::index_t i = 0; i < cnt; i++)
+	{
+		SStepBuffer& stepbuffer = pStepper->_steps.NextTail(i);
+		stepbuffer.Init(dirCount + pState->_bresenham.Step(_steps));
+		stepbuffer.Timer = t;
+		n += count;
+
+#ifdef STEPPER_SIMULATION
+		memcpy(stepbuffer._distance, _distance_, sizeof(stepbuffer._distance));
+		stepbuffer._steps = _steps;
+		stepbuffer._state = _state;
+		stepbuffer._n = n;
+		stepbuffer._count = count;
+		strcpy_s(stepbuffer._spMSCInfo, _mvMSCInfo);
+#endif
+	}
+
+#ifndef REDUCED_SIZE
+	pState->_sumTimer += (unsigned long)t * cnt;
+#endif
+	pState->_n = n;
+
+	pStepper->_steps.EnqueueCount(cnt);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////
+
 void  CStepper::SetEnableAll(uint8_t level)
 {
 	for (register axis_t i = 0; i < NUM_AXIS; ++i)
@@ -2240,6 +3015,7 @@ void CStepper::IoControl(uint8_t tool, unsigned short level)
 {
 	WaitUntilCanQueue();
 	_movements._queue.NextTail().InitIoControl(this, tool,level);
+	NoMergeMove();
 
 	EnqueuAndStartTimer(true);
 }
@@ -2298,6 +3074,141 @@ void CStepper::MoveRel(axis_t axis, sdist_t d, steprate_t vMax)
 	QueueAndSplitStep(dist, directionUp, vMax);
 }
 
+////////////////////////////////////////////////////////
+
+#ifdef USE_ARCMOVE
+
+static float GetArcMajor(uint8_t octant, float x, float y)
+{
+	// coordinate of the axis moving each step (see SArcState::Step): y for octant 0,3,4,7 (abs(x) > abs(y))
+	return ((octant + 1) & 2) == 0 ? y : x;
+}
+
+static float GetArcMajorAtBoundary(uint8_t octant, uint8_t boundary, float radius)
+{
+	float angle = float(boundary) * float(M_PI / 4.0);
+	return GetArcMajor(octant, radius * cos(angle), radius * sin(angle));
+}
+
+////////////////////////////////////////////////////////
+
+bool CStepper::MoveArc(const udist_t to[NUM_AXIS], sdist_t center_0, sdist_t center_1, axis_t axis_0, axis_t axis_1, bool isclockwise, steprate_t vMax)
+{
+	// circular interpolation in the step generator (SArcState) => one movement for the whole arc
+	// return false if the arc cannot be one movement, nothing is queued => use MoveAbs (line segments)
+
+	for (axis_t i = 0; i < NUM_AXIS; i++)
+	{
+		if (i != axis_0 && i != axis_1 && to[i] != _pod._calculatedpos[i])
+			return false;								// helix
+	}
+
+	if (IsSetBacklash() && (_pod._backlash[axis_0] != 0 || _pod._backlash[axis_1] != 0))
+		return false;									// direction changes within the movement
+
+	SMovement::SArc arc;
+
+	arc._axis[0] = axis_0;
+	arc._axis[1] = axis_1;
+	arc._clockwise = isclockwise;
+	arc._stop = false;
+
+	arc._start[0] = (sdist_t)_pod._calculatedpos[axis_0] - center_0;
+	arc._start[1] = (sdist_t)_pod._calculatedpos[axis_1] - center_1;
+	arc._end[0] = (sdist_t)to[axis_0] - center_0;
+	arc._end[1] = (sdist_t)to[axis_1] - center_1;
+
+	float radius = hypot(float(arc._start[0]), float(arc._start[1]));
+
+	if (radius < ARCMOVE_MINRADIUS || fabs(radius - hypot(float(arc._end[0]), float(arc._end[1]))) > ARCMOVE_MAXRADIUSDIFF)
+		return false;
+
+	if (_pod._limitCheck)
+	{
+		// full circle must be within the limits, otherwise line segments check it
+		sdist_t r = (sdist_t)radius + ARCMOVE_MAXRADIUSDIFF;
+		if (center_0 - r < (sdist_t)GetLimitMin(axis_0) || center_0 + r > (sdist_t)GetLimitMax(axis_0) ||
+			center_1 - r < (sdist_t)GetLimitMin(axis_1) || center_1 + r > (sdist_t)GetLimitMax(axis_1))
+			return false;
+	}
+
+	timer_t timerMax = vMax == 0 ? _pod._timerMaxDefault : SpeedToTimer(vMax);
+	if (timerMax == (timer_t)-1)
+		return false;									// to slow => stepmultiplier of QueueAndSplitStep
+
+	if (timerMax < _pod._timerMaxDefault)
+		timerMax = _pod._timerMaxDefault;
+
+	// centripetal acceleration v*v/r must not exceed acc of axis: a = 2 * (f/timerAcc)^2 => timer >= timerAcc / sqrt(2 * r)
+	timer_t timerCentripetal = (timer_t)(max(_pod._timerAcc[axis_0], _pod._timerAcc[axis_1]) / sqrt(2.0f * radius));
+	if (timerMax < timerCentripetal)
+		timerMax = timerCentripetal;
+
+	if (GetStepMultiplier(timerMax) > 1)
+		return false;									// SArcState does one step for each interrupt
+
+	// octant boundaries to pass, start == end => full circle
+
+	uint8_t octantStart = SMovementState::SArcState::GetOctant(arc._start[0], arc._start[1]);
+	uint8_t octantEnd = SMovementState::SArcState::GetOctant(arc._end[0], arc._end[1]);
+
+	arc._transitions = (isclockwise ? octantStart - octantEnd : octantEnd - octantStart) & 7;
+
+	if (arc._transitions == 0)
+	{
+		int64_t cross = (int64_t)arc._start[0] * arc._end[1] - (int64_t)arc._start[1] * arc._end[0];
+		if (isclockwise ? cross >= 0 : cross <= 0)
+			arc._transitions = 8;						// end is behind start
+	}
+
+	// steps of movement: the major axis steps each time => sum of difference of major axis in each octant
+
+	float steps;
+	float startMajor = GetArcMajor(octantStart, float(arc._start[0]), float(arc._start[1]));
+	float endMajor = GetArcMajor(octantEnd, float(arc._end[0]), float(arc._end[1]));
+
+	if (arc._transitions == 0)
+	{
+		steps = fabs(endMajor - startMajor);
+	}
+	else
+	{
+		uint8_t exitBoundary = isclockwise ? octantStart : octantStart + 1;
+		uint8_t entryBoundary = isclockwise ? octantEnd + 1 : octantEnd;
+
+		steps = fabs(GetArcMajorAtBoundary(octantStart, exitBoundary, radius) - startMajor) +
+				float(arc._transitions - 1) * radius / sqrt(2.0f) +
+				fabs(endMajor - GetArcMajorAtBoundary(octantEnd, entryBoundary, radius));
+	}
+
+	if (steps < 1.0f || steps >= float(MAXSTEPSPERMOVE))
+		return false;
+
+	mdist_t movesteps = (mdist_t)lround(steps);
+
+	// now move must not fail
+
+	_pod._error = 0;
+
+	_pod._calculatedpos[axis_0] = to[axis_0];
+	_pod._calculatedpos[axis_1] = to[axis_1];
+
+#ifndef REDUCED_SIZE
+	_pod._totalSteps += movesteps;
+#endif
+
+	WaitUntilCanQueue();
+
+	_movements._queue.NextTail().InitArc(this, GetPrevMovement(_movements._queue.GetNextTailPos()), movesteps, arc, timerMax);
+	NoMergeMove();
+
+	EnqueuAndStartTimer(true);
+
+	return true;
+}
+
+#endif
+
 ////////////////////////////////////////////////////////
 // repeat axis and d until axis not in 0 .. NUM_AXIS
 
@@ -2313,8 +3224,8 @@ void CStepper::MoveAbsEx(steprate_t vMax, unsigned short axis, udist_t d, ...)
 	{
 		D[axis] = d;
 
-#ifdef _MSC_VER
-		axis = va_arg(arglist, unsigned short);
+#ifdef STEPPER_SIMULATION
+		axis = (unsigned short) va_arg(arglist, int);	// unsigned short is promoted to int
 		d = va_arg(arglist, udist_t);
 #else
 		axis = va_arg(arglist, unsigned int);		// only "int" supported on arduino
@@ -2341,8 +3252,8 @@ void CStepper::MoveRelEx(steprate_t vMax, unsigned short axis, sdist_t d, ...)
 	{
 		dist[axis] = d;
 
-#ifdef _MSC_VER
-		axis = va_arg(arglist, unsigned short);
+#ifdef STEPPER_SIMULATION
+		axis = (unsigned short) va_arg(arglist, int);	// unsigned short is promoted to int
 		d = va_arg(arglist, sdist_t);
 #else
 		axis = va_arg(arglist, unsigned int);		// only "int" supported on arduino
@@ -2528,6 +3439,6 @@ void CStepper::SMovementState::Dump(uint8_t /* options */)
 	DumpType<timer_t>(F("t"), _timer, false);
 	DumpType<timer_t>(F("r"), _rest, false);
 	DumpType<unsigned long>(F("sum"), _sumTimer, false);
-	DumpArray<mdist_t, NUM_AXIS>(F("a"), _add, false);
+	DumpArray<mdist_t, NUM_AXIS>(F("a"), _bresenham._add, false);
 #endif
 }
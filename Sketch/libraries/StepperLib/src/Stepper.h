@@ -84,6 +84,12 @@ public:
 		SpeedOverrideMin = 1
 	};
 
+	enum ERampType
+	{
+		RampTrapezoid = 0,										// constant acceleration
+		RampSCurve = 1											// jerk limited, acceleration is 0 at start and end of the ramp
+	};
+
 	enum EDumpOptions		// use bit
 	{
 		DumpAll			= 0xff,
@@ -143,12 +149,26 @@ public:
 	void SetSpeedOverride(EnumAsByte(ESpeedOverride) speed)		{ _pod._speedoverride = speed; }
 	EnumAsByte(ESpeedOverride) GetSpeedOverride()				{ return _pod._speedoverride; }
 
+	void SetRampType(EnumAsByte(ERampType) ramptype)			{ _pod._rampType = ramptype; }	// set if idle, queued movements are planned for the ramp type
+	EnumAsByte(ERampType) GetRampType() const					{ return _pod._rampType; }
+
 	static uint8_t SpeedOverrideToP(EnumAsByte(ESpeedOverride) speed)	  {	return RoundMulDivU8((uint8_t) speed, 100, SpeedOverride100P);	}
 	static  EnumAsByte(ESpeedOverride) PToSpeedOverride(uint8_t speedP) { return (EnumAsByte(ESpeedOverride)) RoundMulDivU8(speedP, SpeedOverride100P, 100); }
 
 	void SetUsual(steprate_t vMax);
 
 	void SetJerkSpeed(axis_t axis, steprate_t vMaxJerk)			{ _pod._maxJerkSpeed[axis] = vMaxJerk; }
+#ifndef REDUCED_SIZE
+	void SetJunctionDeviation(mdist_t steps)					{ _pod._junctionDeviation = steps; }	// G64 P: corner tolerance, 0 => jerk only
+	mdist_t GetJunctionDeviation() const						{ return _pod._junctionDeviation; }
+#endif
+#ifdef USE_MERGEMOVE
+	void SetMergeTolerance(mdist_t steps)						{ _pod._mergeTolerance = steps; }		// merge co-linear moves, 0 => off
+	mdist_t GetMergeTolerance() const							{ return _pod._mergeTolerance; }
+#endif
+
+	void SetPlanMaxCount(uint8_t count)							{ _pod._planMaxCount = count; }		// max movements re-planned per QueueMove (default MOVEMENTPLANMAXCOUNT)
+	uint8_t GetPlanMaxCount() const								{ return _pod._planMaxCount; }
 	
 	void SetWaitFinishMove(bool wait)                           { _pod._waitFinishMove = wait; };
 	bool IsWaitFinishMove() const								{ return _pod._waitFinishMove; }
@@ -213,6 +233,9 @@ public:
 
 	void MoveAbsEx(steprate_t vMax, unsigned short axis, udist_t d, ...);	// repeat axis and d until axis not in 0 .. NUM_AXIS-1
 	void MoveRelEx(steprate_t vMax, unsigned short axis, sdist_t d, ...);	// repeat axis and d until axis not in 0 .. NUM_AXIS-1
+#ifdef USE_ARCMOVE
+	bool MoveArc(const udist_t to[NUM_AXIS], sdist_t center_0, sdist_t center_1, axis_t axis_0, axis_t axis_1, bool isclockwise, steprate_t vMax);	// false => not queued, use MoveAbs (line segments)
+#endif
 	void Wait(unsigned int sec100);							// unconditional wait
 	void WaitConditional(unsigned int sec100);				// conditional wait 
 	void IoControl(uint8_t tool, unsigned short level);
@@ -274,6 +297,12 @@ private:
 
 	void QueueMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax, uint8_t stepmult);
 	void QueueWait(const mdist_t dist, timer_t timerMax, bool checkCondition);
+#ifdef USE_MERGEMOVE
+	bool MergeMove(const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax);
+	void NoMergeMove()											{ _pod._mergeTimerMax = (timer_t)-1; }	// the tail is not a plain move (stepmultiplier, backlash, arc, wait, io)
+#else
+	void NoMergeMove()											{ }
+#endif
 
 	void EnqueuAndStartTimer(bool waitfinish);
 	void WaitUntilCanQueue();
@@ -328,6 +357,72 @@ protected:
 
 	static uint8_t GetStepMultiplier(timer_t timermax);
 
+	static timer_t GetRampTimer(timer_t timer0, mdist_t n);									// timer after n steps of a ramp from v=0 (table, no division)
+	static mdist_t GetSCurveSteps(mdist_t n, mdist_t steps);								// s-curve: ramp index (of constant a) after n of steps
+
+	template<class TDirCount, uint8_t numaxis>
+	struct SBresenham
+	{
+		// bresenham of one movement, only moving axes are calculated
+		// axes with distance == steps step with every call (without add) => _dirCountAlways
+
+		TDirCount _dirCountAlways;		// DirCount of all axes with distance == steps
+		uint8_t _axisCount;				// moving axes in _add, _distance, _dirCount
+		mdist_t _add[numaxis];
+		mdist_t _distance[numaxis];
+		TDirCount _dirCount[numaxis];	// DirCount of axis (at position of axis)
+
+		void Init(const mdist_t distance[], mdist_t steps, TDirCount dirCount, mdist_t add, bool always)
+		{
+			TDirCount mask = 15;
+			_dirCountAlways = 0;
+			_axisCount = 0;
+
+			for (uint8_t i = 0; i < numaxis; i++)
+			{
+				if (distance[i] != 0)
+				{
+					if (always && distance[i] == steps)
+					{
+						_dirCountAlways += mask & dirCount;
+					}
+					else
+					{
+						_add[_axisCount] = add;
+						_distance[_axisCount] = distance[i];
+						_dirCount[_axisCount] = mask & dirCount;
+						_axisCount++;
+					}
+				}
+				mask <<= 4;
+			}
+		}
+
+		bool Step(uint8_t idx, mdist_t steps)
+		{
+			// Check overflow!
+			mdist_t oldadd = _add[idx];
+			_add[idx] += _distance[idx];
+			if (_add[idx] >= steps || _add[idx] < oldadd)
+			{
+				_add[idx] -= steps;
+				return true;
+			}
+			return false;
+		}
+
+		TDirCount Step(mdist_t steps)
+		{
+			TDirCount stepcount = _dirCountAlways;
+			for (uint8_t i = 0; i < _axisCount; i++)
+			{
+				if (Step(i, steps))
+					stepcount += _dirCount[i];
+			}
+			return stepcount;
+		}
+	};
+
 protected:
 
 	//////////////////////////////////////////
@@ -360,6 +455,15 @@ protected:
 		uint8_t			_referenceHitValue[NUM_REFERENCE];			// each axis min and max - used in ISR LOW,HIGH, 255(not used)
 
 		steprate_t		_maxJerkSpeed[NUM_AXIS];					// immediate change of speed without ramp (in junction)
+#ifndef REDUCED_SIZE
+		mdist_t			_junctionDeviation;							// corner tolerance (steps) for the junction speed, 0 => jerk only
+#endif
+#ifdef USE_MERGEMOVE
+		mdist_t			_mergeTolerance;							// max deviation (steps) of a merged co-linear move, 0 => no merge
+		mdist_t			_mergeDist[NUM_AXIS];						// distance of the last queued move (without stepmultiplier)
+		timer_t			_mergeTimerMax;								// timerMax of the last queued move (as requested), -1 => no merge
+		float			_mergeDeviation;							// sum of the deviations of the merged junction points
+#endif
 
 		timer_t			_timerMax[NUM_AXIS];						// maximum speed of axis
 		timer_t			_timerAcc[NUM_AXIS];						// acc timer start
@@ -377,6 +481,8 @@ protected:
 
 		uint8_t	_idleLevel;											// level if idle (0..100)
 		volatile EnumAsByte(ESpeedOverride)	_speedoverride;			// Speed override, 128 => 100% (change in irq possible)
+		EnumAsByte(ERampType)	_rampType;							// trapezoid or s-curve
+		uint8_t			_planMaxCount;								// max movements (from tail) to re-plan in OptimizeMovementQueue
 
 		axisArray_t		_lastdirection;								// for backlash
 		axisArray_t		_invertdirection;							// invert direction
@@ -431,6 +537,10 @@ protected:
 
 		EnumAsByte(EMovementState) _state;						// emums are 16 bit in gcc => force byte
 		bool		_backlash;									// move is backlash
+		bool		_planned;									// "planned up to" watermark: junction to prev is at max => T2H optimization stops here
+#ifdef USE_ARCMOVE
+		bool		_isArc;										// circular interpolation (see SArc), else bresenham
+#endif
 
 		DirCount_t	_dirCount;
 		DirCount_t	_lastStepDirCount;
@@ -482,6 +592,18 @@ protected:
 
 		} _pod;
 
+#ifdef USE_ARCMOVE
+		struct SArc												// arc move (in addition to _pod._move)
+		{
+			sdist_t _start[2];									// start relative to center (steps)
+			sdist_t _end[2];									// end relative to center (steps)
+			axis_t	_axis[2];
+			bool	_clockwise;
+			bool	_stop;										// stop ramp (StopMove) of an arc => continue arc and end with _steps
+			uint8_t	_transitions;								// octant boundaries to pass from start to end
+		} _arc;
+#endif
+
 		stepperstatic CStepper* _pStepper;						// give access to stepper (not static if multiinstance)  
 
 		timer_t GetUpTimerAcc()									{ return _pod._move._timerAcc; }
@@ -498,9 +620,23 @@ protected:
 		bool GetDirectionUp(axis_t axis)						{ return ((_dirCount >> (axis * 4)) & 8) != 0; }
 		uint8_t GetMaxStepMultiplier();
 
+#ifdef USE_ARCMOVE
+		bool IsArc() const										{ return _isArc; }
+		mdist_t GetJunctionDistance(axis_t axis, bool atEnd);	// arc: tangent at start or end
+		bool GetJunctionDirectionUp(axis_t axis, bool atEnd);
+		void GetArcTangent(sdist_t tangent[2], bool atEnd) const;
+#else
+		bool IsArc() const										{ return false; }
+		mdist_t GetJunctionDistance(axis_t axis, bool)			{ return GetDistance(axis); }
+		bool GetJunctionDirectionUp(axis_t axis, bool)			{ return GetDirectionUp(axis); }
+#endif
+
 		bool Ramp(SMovement*mvNext);
 
 		void CalcMaxJunktionSpeed(SMovement*mvNext);
+#ifndef REDUCED_SIZE
+		timer_t GetJunctionDeviationTimer(SMovement*mvPrev, timer_t timerAcc);
+#endif
 
 		bool AdjustJunktionSpeedT2H(SMovement*mvPrev, SMovement*mvNext);
 		void AdjustJunktionSpeedH2T(SMovement*mvPrev, SMovement*mvNext);
@@ -510,6 +646,8 @@ protected:
 	private:
 
 		bool IsEndWait() const;									// immediately end wait 
+		bool CalcNextStepsRun();								// batch of steps with constant speed (StateRun)
+		timer_t CalcStepTimer(timer_t timer) const;				// apply speed override
 
 	public:
 
@@ -530,6 +668,9 @@ protected:
 		bool IsSkipForOptimizing() const						{ return IsActiveIo();  }									// skip the entry when optimizing queue
 
 		void InitMove(CStepper*pStepper, SMovement* mvPrev, mdist_t steps, const mdist_t dist[NUM_AXIS], const bool directionUp[NUM_AXIS], timer_t timerMax);
+#ifdef USE_ARCMOVE
+		void InitArc(CStepper*pStepper, SMovement* mvPrev, mdist_t steps, const SArc& arc, timer_t timerMax);
+#endif
 		void InitWait(CStepper*pStepper, mdist_t steps, timer_t timer, bool checkWaitConditional);
 		void InitIoControl(CStepper*pStepper, uint8_t tool, unsigned short level);
 
@@ -539,16 +680,22 @@ protected:
 
 		void Dump(uint8_t queueidx, uint8_t options);
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 		char _mvMSCInfo[MOVEMENTINFOSIZE];
+		timer_t GetTimerJunctionToPrev() const					{ return _pod._move._timerJunctionToPrev; }	// test: planned junction speed
 #endif
 
 	};
 
+	// QueueMove re-plans and inserts queued movements => CRingBufferQueue (with CCriticalRegion)
+	typedef CRingBufferQueue<SMovement, MOVEMENTBUFFERSIZE> MovementQueue_t;
+
+	static_assert(sizeof(MovementQueue_t::index_t) == 1, "MOVEMENTBUFFERSIZE must be <= 128 (uint8_t is used as index)");
+
 	struct SMovements
 	{
 		timer_t _timerStartPossible;							// timer for fastest possible start (break at the end)
-		CRingBufferQueue<SMovement, MOVEMENTBUFFERSIZE>	_queue;
+		MovementQueue_t	_queue;
 	};
 
 	stepperstatic struct SMovements _movements;
@@ -575,12 +722,31 @@ protected:
 		unsigned long _sumTimer;	// for debug
 #endif
 
-		mdist_t _add[NUM_AXIS];
+		SBresenham<DirCount_t, NUM_AXIS> _bresenham;
+
+#ifdef USE_ARCMOVE
+		struct SArcState										// midpoint circle algorithm
+		{
+			sdist_t _pos[2];									// current position relative to center
+			long	_f;											// x*x + y*y - r*r
+			uint8_t	_octant;
+			uint8_t	_transitions;								// octant boundaries still to pass
+			bool	_toEnd;										// on the end octant and passed the end => correction steps to the end position
+			bool	_diagonal;									// last step moved both axes
+
+			void Init(const SMovement* pMovement);
+			DirCount_t Step(const SMovement* pMovement);		// next step (one or both axes)
+			bool IsDone(const SMovement* pMovement) const		{ return _toEnd && _pos[0] == pMovement->_arc._end[0] && _pos[1] == pMovement->_arc._end[1]; }
+
+			static uint8_t GetOctant(sdist_t x, sdist_t y);		// 0..7 counterclockwise, [k*45, (k+1)*45)
+		} _arc;
+#endif
 
 		void Init(SMovement* pMovement);
 
-		bool CalcTimerAcc(timer_t maxtimer, mdist_t n, uint8_t cnt);
-		bool CalcTimerDec(timer_t mintimer, mdist_t n, uint8_t cnt);
+		bool CalcTimerAcc(timer_t maxtimer, timer_t timer0, mdist_t n, uint8_t cnt);		// timer0 = timer at v=0 (only USE_RAMPTABLE)
+		bool CalcTimerDec(timer_t mintimer, timer_t timer0, mdist_t n, uint8_t cnt);
+		bool CalcTimerSCurve(timer_t endtimer, timer_t timer0, mdist_t n, bool acc);			// n = ramp index, see GetSCurveSteps
 
 	public:
 
@@ -597,7 +763,7 @@ protected:
 	public:
 		DirCount_t		DirStepCount;								// direction and count
 		timer_t			Timer;
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 		mdist_t			_distance[NUM_AXIS];						// to calculate relative speed
 		mdist_t			_steps;
 		SMovement::EMovementState  _state;
@@ -612,11 +778,18 @@ protected:
 		};
 	};
 
-	stepperstatic CRingBufferQueue<SStepBuffer, STEPBUFFERSIZE>	_steps;
+	// one producer (CalcNextSteps) and one consumer (StepOut in the timer ISR) => lock free
+	typedef CRingBufferQueueSPSC<SStepBuffer, STEPBUFFERSIZE> StepBufferQueue_t;
+
+#if defined(__AVR_ARCH__)
+	static_assert(sizeof(StepBufferQueue_t::index_t) == 1, "STEPBUFFERSIZE must be <= 128 (CRingBufferQueueSPSC, counters must be read atomic)");
+#endif
+
+	stepperstatic StepBufferQueue_t	_steps;
 
 public:
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	const char* MSCInfo;
 #endif
 
@@ -651,7 +824,7 @@ protected:
 	bool  MoveAwayFromReference(axis_t axis, uint8_t referenceid, sdist_t dist, steprate_t vMax);
 	virtual void MoveAwayFromReference(axis_t axis, sdist_t dist, steprate_t vMax)							{ MoveRel(axis, dist, vMax); };
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 	virtual void  StepBegin(const SStepBuffer* /* step */) {  };
 	virtual void  StepEnd() {};
 #endif
@@ -102,7 +102,7 @@ protected:
 #else
 #undef USE_A4998
 #endif
-#include "StepperA4998_DRV8825.h"
+#include "StepperA4998_drv8825.h"
 
 	////////////////////////////////////////////////////////
 
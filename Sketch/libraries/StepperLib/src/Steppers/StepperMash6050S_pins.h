@@ -69,7 +69,7 @@
 #else
 #define MASH6050S_SDSS_PIN			53
 #endif
-#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER)
+#elif defined(__AVR_ATmega328P__) || defined (STEPPER_SIMULATION)
 
 #define MASH6050S_INPUTPINMODE		INPUT_PULLUP		
 
@@ -25,7 +25,7 @@
 
 ////////////////////////////////////////////////////////
 
-#if defined(__AVR_ATmega2560__) || defined(_MSC_VER) || defined(__SAM3X8E__)
+#if defined(__AVR_ATmega2560__) || defined(STEPPER_SIMULATION) || defined(__SAM3X8E__)
 
 // only available on Arduino Mega or due
 
@@ -62,7 +62,7 @@ public:
 	{
 		super::Init();
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 
@@ -103,7 +103,7 @@ public:
 #endif
 
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 
@@ -122,7 +122,7 @@ protected:
 	{
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  if (level != LevelOff)	HALFastdigitalWrite(RAMPS14_X_ENABLE_PIN, RAMPS14_PIN_ENABLE_ON);	else	HALFastdigitalWrite(RAMPS14_X_ENABLE_PIN, RAMPS14_PIN_ENABLE_OFF); break;
@@ -135,7 +135,7 @@ protected:
 #endif
 #endif
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
@@ -147,7 +147,7 @@ protected:
 	{
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  return ConvertLevel(HALFastdigitalRead(RAMPS14_X_ENABLE_PIN) == RAMPS14_PIN_ENABLE_ON);
@@ -160,7 +160,7 @@ protected:
 #endif
 #endif
 
-			#ifdef _MSC_VER
+			#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
@@ -174,7 +174,7 @@ protected:
 	#else
 		#undef USE_A4998
 	#endif
-	#include "StepperA4998_DRV8825.h"
+	#include "StepperA4998_drv8825.h"
 
 	////////////////////////////////////////////////////////
 	
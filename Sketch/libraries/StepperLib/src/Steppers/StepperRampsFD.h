@@ -25,7 +25,7 @@
 
 ////////////////////////////////////////////////////////
 
-#if defined(__AVR_ATmega2560__) || defined(_MSC_VER) || defined(__SAM3X8E__)
+#if defined(__AVR_ATmega2560__) || defined(STEPPER_SIMULATION) || defined(__SAM3X8E__)
 
 // only available on Arduino Mega or due
 
@@ -61,7 +61,7 @@ public:
 	{
 		super::Init();
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 
@@ -109,7 +109,7 @@ public:
 		//  CHAL::pinModeInputPullUp(E2_MAX_PIN);         
 		HALFastdigitalWrite(RAMPSFD_E2_STEP_PIN, RAMPSFD_PIN_STEP_ON);
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 
@@ -135,7 +135,7 @@ protected:
 	{
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  if (level != LevelOff)	HALFastdigitalWrite(RAMPSFD_X_ENABLE_PIN,  RAMPSFD_PIN_ENABLE_ON);	else	HALFastdigitalWrite(RAMPSFD_X_ENABLE_PIN,  RAMPSFD_PIN_ENABLE_OFF); break;
@@ -147,7 +147,7 @@ protected:
 #endif
 			case E2_AXIS: if (level != LevelOff)	HALFastdigitalWrite(RAMPSFD_E2_ENABLE_PIN, RAMPSFD_PIN_ENABLE_ON);	else	HALFastdigitalWrite(RAMPSFD_E2_ENABLE_PIN, RAMPSFD_PIN_ENABLE_OFF); break;
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
@@ -159,7 +159,7 @@ protected:
 	{
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  return ConvertLevel(HALFastdigitalRead(RAMPSFD_X_ENABLE_PIN) == RAMPSFD_PIN_ENABLE_ON);
@@ -170,7 +170,7 @@ protected:
 			case E1_AXIS: return ConvertLevel(HALFastdigitalRead(RAMPSFD_E1_ENABLE_PIN) == RAMPSFD_PIN_ENABLE_ON);
 #endif
 			case E2_AXIS: return ConvertLevel(HALFastdigitalRead(RAMPSFD_E2_ENABLE_PIN) == RAMPSFD_PIN_ENABLE_ON);
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
@@ -184,7 +184,7 @@ protected:
 	#else
 		#undef USE_A4998
 	#endif
-	#include "StepperA4998_DRV8825.h"
+	#include "StepperA4998_drv8825.h"
 
 	////////////////////////////////////////////////////////
 	
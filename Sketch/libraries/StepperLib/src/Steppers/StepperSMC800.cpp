@@ -32,7 +32,7 @@
 #define SMC800_REFININ 40
 #define SMC800_STROBEPIN 41
 
-#elif defined(__AVR_ATmega328P__) || defined (_MSC_VER)
+#elif defined(__AVR_ATmega328P__) || defined (STEPPER_SIMULATION)
 
 #define SMC800_REFININ 11
 #define SMC800_STROBEPIN 10
@@ -86,7 +86,7 @@ void CStepperSMC800::OutSMC800Cmd(const uint8_t val)
 	PORTD = (PORTD & 3) + (val << 2);
 	PORTB = (PORTB & 0b11111100) + (val >> 6);
 
-#elif defined(_MSC_VER)
+#elif defined(STEPPER_SIMULATION)
 	val;
 #else
 	ToDo
@@ -125,7 +125,7 @@ void CStepperSMC800::Init()
 	DDRD = (DDRD & 3) + 0b11111100;
 	DDRB = (DDRB & 0b11111100) + 3;
 
-#elif defined(_MSC_VER)
+#elif defined(STEPPER_SIMULATION)
 
 #else
 	ToDo
@@ -150,7 +150,7 @@ void CStepperSMC800::Remove()
 	DDRD = DDRD & 3;
 	DDRB = DDRB & 0b11111100;
 
-#elif defined(_MSC_VER)
+#elif defined(STEPPER_SIMULATION)
 
 #else
 	ToDo
@@ -69,7 +69,7 @@ public:
 		CHAL::pinModeOutput(TB6560_B_DIR_PIN);
 		CHAL::pinModeOutput(TB6560_B_ENABLE_PIN);
 		*/
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 
@@ -79,7 +79,7 @@ public:
 		//	HALFastdigitalWrite(TB6560_A_STEP_PIN, TB6560_PIN_STEP_ON);
 		//	HALFastdigitalWrite(TB6560_B_STEP_PIN, TB6560_PIN_STEP_ON);
 
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 
@@ -95,7 +95,7 @@ protected:
 #define SETLEVEL(pin) if (level != LevelOff)	HALFastdigitalWrite(pin,TB6560_PIN_ENABLE_ON);	else	HALFastdigitalWrite(pin,TB6560_PIN_ENABLE_OFF);
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  SETLEVEL(TB6560_X_ENABLE_PIN); break;
@@ -103,7 +103,7 @@ protected:
 			case Z_AXIS:  SETLEVEL(TB6560_Z_ENABLE_PIN); break;
 				//		case A_AXIS: SETLEVEL(TB6560_A_ENABLE_PIN); break;
 				//		case B_AXIS: SETLEVEL(TB6560_B_ENABLE_PIN); break;
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
@@ -117,7 +117,7 @@ protected:
 	{
 		switch (axis)
 		{
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( disable : 4127 )
 #endif
 			case X_AXIS:  return ConvertLevel(HALFastdigitalRead(TB6560_X_ENABLE_PIN) == TB6560_PIN_ENABLE_ON);
@@ -125,7 +125,7 @@ protected:
 			case Z_AXIS:  return ConvertLevel(HALFastdigitalRead(TB6560_Z_ENABLE_PIN) == TB6560_PIN_ENABLE_ON);
 				//		case A_AXIS: return ConvertLevel(HALFastdigitalRead(TB6560_A_ENABLE_PIN) == TB6560_PIN_ENABLE_ON);
 				//		case B_AXIS: return ConvertLevel(HALFastdigitalRead(TB6560_B_ENABLE_PIN) == TB6560_PIN_ENABLE_ON);
-#ifdef _MSC_VER
+#ifdef STEPPER_SIMULATION
 #pragma warning( default : 4127 )
 #endif
 		}
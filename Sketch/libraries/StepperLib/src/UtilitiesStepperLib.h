@@ -77,6 +77,12 @@ inline long MulDivI32(long v, long m, long d)
 	return (v * m) / d;
 }
 
+inline unsigned long MulShr16U32(unsigned long v, unsigned long m)
+{
+	// (v * m) >> 16 without 64 bit, m <= 65536
+	return (v >> 16) * m + (((v & 0xffff) * m) >> 16);
+}
+
 ////////////////////////////////////////////////////////
 
 unsigned long _ulsqrt_round(unsigned long val);
@@ -84,7 +90,7 @@ unsigned long _ulsqrt(unsigned long val);
 
 ////////////////////////////////////////////////////////
 
-#if defined(_MSC_VER) || defined(__SAM3X8E__) || defined(__SAMD21G18A__)
+#if defined(STEPPER_SIMULATION) || defined(__SAM3X8E__) || defined(__SAMD21G18A__)
 
 typedef struct _udiv_t {
 	unsigned short quot;
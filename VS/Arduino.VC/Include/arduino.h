@@ -21,6 +21,8 @@
 
 #pragma comment (lib, "StepperSystem.lib")
 
+#define STEPPER_SIMULATION		// libraries: simulation target (HAL_Msvc.h, CMsvcStepper)
+
 #include <stdio.h>
 #include <ctype.h>
 #define _USE_MATH_DEFINES
@@ -250,28 +252,33 @@ public:
 
 	void SetIdle(void(*pIdle)())	{ _pIdle = pIdle;  }
 
-	void print(char c)				{ printf("%c", c); };
-	void print(unsigned int ui)		{ printf("%u", ui); };
-	void print(int i)				{ printf("%i", i); };
-	void print(long l)				{ printf("%li", l); };
-	void print(unsigned long ul)	{ printf("%lu", ul); };
+	// all output is written with write(const char*) => override to capture the output (e.g. unit test)
+
+	virtual void write(const char* s)	{ printf("%s", s); };
+
+	void print(char c)				{ char s[2] = { c, 0 }; write(s); };
+	void print(unsigned int ui)		{ char s[16]; sprintf_s(s, "%u", ui); write(s); };
+	void print(int i)				{ char s[16]; sprintf_s(s, "%i", i); write(s); };
+	void print(long l)				{ char s[16]; sprintf_s(s, "%li", l); write(s); };
+	void print(unsigned long ul)	{ char s[16]; sprintf_s(s, "%lu", ul); write(s); };
 	void print(unsigned long ul, uint8_t base)
 	{
-		if (base == 10) printf("%lu", ul);
-		if (base == 16) printf("%x", ul);
+		char s[16];
+		if (base == 10) { sprintf_s(s, "%lu", ul); write(s); }
+		if (base == 16) { sprintf_s(s, "%lx", ul); write(s); }
 	}
-	void print(const char*s)		{ printf("%s", s); };
-	void print(float f)				{ printf("%f", f); };
-
-	void println()					{ printf("\n"); };
-	void println(unsigned int ui)	{ printf("%u\n", ui); };
-	void println(char c)			{ printf("%c\n", c); };
-	void println(int i)				{ printf("%i\n", i); };
-	void println(long l)			{ printf("%li\n", l); };
-	void println(unsigned long ul)	{ printf("%lu\n", ul); };
+	void print(const char*s)		{ write(s); };
+	void print(float f)				{ char s[64]; sprintf_s(s, "%f", f); write(s); };
+
+	void println()					{ write("\n"); };
+	void println(unsigned int ui)	{ print(ui); println(); };
+	void println(char c)			{ print(c); println(); };
+	void println(int i)				{ print(i); println(); };
+	void println(long l)			{ print(l); println(); };
+	void println(unsigned long ul)	{ print(ul); println(); };
 	void println(unsigned long ul, uint8_t base) { print(ul, base); println(); };
-	void println(const char*s)		{ printf("%s\n", s); };
-	void println(float f)			{ printf("%f\n", f); };
+	void println(const char*s)		{ print(s); println(); };
+	void println(float f)			{ print(f); println(); };
 
 	void begin(int )				{ };
 	virtual int available()	 		{
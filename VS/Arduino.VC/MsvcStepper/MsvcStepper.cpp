@@ -19,8 +19,8 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
-#include <Stdio.h>
-#include <StdLib.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include <Arduino.h>
 #include <avr/interrupt.h>
@@ -43,14 +43,14 @@ CMsvcStepper::CMsvcStepper()
 
 void CMsvcStepper::Init()
 {
-	__super::Init();
+	super::Init();
 }
 
 ////////////////////////////////////////////////////////////
 
 void CMsvcStepper::OnWait(EnumAsByte(EWaitType) wait)
 {
-	__super::OnWait(wait);
+	super::OnWait(wait);
 	DoISR();
 
 	if (wait == MovementQueueFull && CanQueueMovement())	// doISR has finsihed move
@@ -101,14 +101,14 @@ void CMsvcStepper::HandleIdle()
 void CMsvcStepper::OnStart()
 {
 	_refMovestart = 0;
-	__super::OnStart();
+	super::OnStart();
 }
 
 ////////////////////////////////////////////////////////////
 
 void CMsvcStepper::OnIdle(unsigned long idletime)
 {
-	__super::OnIdle(idletime);
+	super::OnIdle(idletime);
 }
 
 ////////////////////////////////////////////////////////////
@@ -135,7 +135,7 @@ bool CMsvcStepper::MoveReference(axis_t axis, uint8_t referenceid, bool toMin, s
 	_referenceMoveSteps = 15;
 	_isReferenceMove = true;
 	_isReferenceId = referenceid;
-	bool ret = __super::MoveReference(axis, referenceid, toMin, vMax, maxdist, distToRef, distIfRefIsOn);
+	bool ret = super::MoveReference(axis, referenceid, toMin, vMax, maxdist, distToRef, distIfRefIsOn);
 	_isReferenceMove = false;
 	return ret;
 }
@@ -146,7 +146,7 @@ void CMsvcStepper::StartTimer(timer_t timerB)
 {
 	timerB += TIMEROVERHEAD;
 	_TimerEvents[_eventIdx].TimerValues = timerB;
-	__super::StartTimer(timerB);
+	super::StartTimer(timerB);
 
 };
 
@@ -154,7 +154,7 @@ void CMsvcStepper::StartTimer(timer_t timerB)
 
 void CMsvcStepper::SetIdleTimer()
 {
-	__super::SetIdleTimer();
+	super::SetIdleTimer();
 }
 
 ////////////////////////////////////////////////////////////
@@ -162,7 +162,7 @@ void CMsvcStepper::SetIdleTimer()
 void CMsvcStepper::StepRequest(bool isr)
 {
 	_refMovestart++;
-	__super::StepRequest(isr);
+	super::StepRequest(isr);
 }
 
 ////////////////////////////////////////////////////////////
@@ -171,6 +171,7 @@ void CMsvcStepper::StepBegin(const SStepBuffer* stepbuffer)
 {
 	_TimerEvents[_eventIdx].Steps = stepbuffer->_steps;
 	_TimerEvents[_eventIdx].Count = stepbuffer->_count;
+	_TimerEvents[_eventIdx].N = stepbuffer->_n;
 	int multiplier = stepbuffer->DirStepCount;
 	for (int i = 0; i < NUM_AXIS; i++)
 	{
@@ -216,7 +217,7 @@ void CMsvcStepper::Step(const uint8_t steps[NUM_AXIS], axisArray_t directionUp,
 void CMsvcStepper::OptimizeMovementQueue(bool force)
 {
 	if (!DelayOptimization || force || _movements._queue.IsFull())
-		__super::OptimizeMovementQueue(force);
+		super::OptimizeMovementQueue(force);
 }
 
 ////////////////////////////////////////////////////////////
@@ -269,6 +270,19 @@ void CMsvcStepper::InitTest(const char* filename)
 
 ////////////////////////////////////////////////////////////
 
+int CMsvcStepper::GetEventSteps(int idx) const
+{
+	int steps = 0;
+	for (int i = 0; i < NUM_AXIS_MVC; i++)
+	{
+		if (abs(_TimerEvents[idx].Axis[i].MoveAxis) > steps)
+			steps = abs(_TimerEvents[idx].Axis[i].MoveAxis);
+	}
+	return steps;
+}
+
+////////////////////////////////////////////////////////////
+
 void CMsvcStepper::EndTest(const char* filename)
 {
 	_filename = filename ? filename : _filename;
@@ -361,7 +375,7 @@ void CMsvcStepper::WriteTestResults(const char* filename)
 
 		fprintf(f, "%i;%i;%i;%i;%s;%s;%s;%s;%s;%i;%i;%i;%i;%i;%i;%i;%i;%i;%i;%s\n",
 			_exportIdx++,
-			_TimerEvents[i].TimerValues,
+			(int) _TimerEvents[i].TimerValues,
 			outtotaltime,
 			sysspeed,
 			_speed[0],
@@ -24,16 +24,19 @@
 #include <stdio.h>
 #include <memory.h>
 
-#include "..\..\..\sketch\libraries\StepperLib\src\StepperLib.h"
-#include "..\..\..\sketch\libraries\CNCLib\src\MessageCNCLib.h"
-#include "..\..\..\sketch\libraries\CNCLib\src\GCodeParserBase.h"
-#include "..\..\..\sketch\libraries\CNCLib\src\DecimalAsInt.h"
+#include "../../../Sketch/libraries/StepperLib/src/StepperLib.h"
+#include "../../../Sketch/libraries/CNCLib/src/MessageCNCLib.h"
+#include "../../../Sketch/libraries/CNCLib/src/GCodeParserBase.h"
+#include "../../../Sketch/libraries/CNCLib/src/DecimalAsInt.h"
 
 #define _STORETIMEVALUES	100000
 #define NUM_AXIS_MVC		5
 
 class CMsvcStepper : public CStepper
 {
+private:
+
+	typedef CStepper super;
 
 public:
 
@@ -81,6 +84,10 @@ public:
 		return _movements._queue.Count();
 	}
 
+	using CStepper::GetRampTimer;
+	using CStepper::GetSCurveSteps;
+	using CStepper::SBresenham;
+
 private:
 
 	uint8_t _level[NUM_AXIS];
@@ -98,6 +105,12 @@ public:
 	void InitTest(const char* filename=NULL);
 	void EndTest(const char* filename=NULL);
 
+	long long GetTotalTime() const { return _totaltime; }		// sum of timer values written by EndTest
+	int GetEventCount() const { return _eventIdx; }				// events in the cache (since the last flush)
+	timer_t GetEventTimer(int idx) const { return _TimerEvents[idx].TimerValues; }
+	int GetEventSteps(int idx) const;							// steps of the main axis of the event (step multiplier)
+	int GetEventN(int idx) const { return _TimerEvents[idx].N; }				// step of the movement after the event, restarts with each movement
+
 	bool DelayOptimization;
 	bool SplitFile;
 	bool UseSpeedSign;
@@ -115,6 +128,7 @@ private:
 		timer_t TimerValues;
 		int Steps;
 		int Count;
+		int N;
 		struct SAxis
 		{
 			int Multiplier;
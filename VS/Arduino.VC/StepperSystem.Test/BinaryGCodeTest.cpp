@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////
+/*
+This file is part of CNCLib - A library for stepper motors.
+
+Copyright (c) 2013-2018 Herbert Aitenbichler
+
+CNCLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+CNCLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <BinaryGCode.h>
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	TEST_CLASS(CBinaryGCodeTest)
+	{
+	public:
+
+		TEST_METHOD(BinaryGCodeEncodeDecodeTest)
+		{
+			CBinaryGCode::SMove move = { 0 };
+			move.header = CBinaryGCode::CutMove | CBinaryGCode::FeedRate | 1 | 2 | 4;
+			move.distance[0] = 123;
+			move.distance[1] = -64;
+			move.distance[2] = -2147483647l;
+			move.feedrate = 500000;
+
+			uint8_t frame[CBinaryGCode::MaxFrameSize];
+			uint8_t size = CBinaryGCode::Encode(move, frame);
+
+			// header + 2 + 1 + 5 + 3 + crc
+			Assert::AreEqual((uint8_t)13, size);
+			Assert::AreEqual(size, CBinaryGCode::FrameSize(frame, size));
+			Assert::AreEqual(size, CBinaryGCode::FrameSize(frame, sizeof(frame)));
+
+			for (uint8_t count = 0; count < size; count++)
+			{
+				Assert::AreEqual((uint8_t)0, CBinaryGCode::FrameSize(frame, count));
+			}
+
+			CBinaryGCode::SMove decoded;
+			Assert::IsTrue(CBinaryGCode::Decode(frame, size, decoded));
+
+			Assert::AreEqual(move.header, decoded.header);
+			Assert::AreEqual(move.distance[0], decoded.distance[0]);
+			Assert::AreEqual(move.distance[1], decoded.distance[1]);
+			Assert::AreEqual(move.distance[2], decoded.distance[2]);
+			Assert::AreEqual((mm1000_t)0, decoded.distance[3]);
+			Assert::AreEqual(move.feedrate, decoded.feedrate);
+		}
+
+		TEST_METHOD(BinaryGCodeCrcTest)
+		{
+			CBinaryGCode::SMove move = { 0 };
+			move.header = 1 | 2;
+			move.distance[0] = 10000;
+			move.distance[1] = -5000;
+
+			uint8_t frame[CBinaryGCode::MaxFrameSize];
+			uint8_t size = CBinaryGCode::Encode(move, frame);
+
+			CBinaryGCode::SMove decoded;
+			Assert::IsTrue(CBinaryGCode::Decode(frame, size, decoded));
+
+			for (uint8_t idx = 0; idx < size; idx++)
+			{
+				frame[idx] ^= 0x10;
+				Assert::IsFalse(CBinaryGCode::Decode(frame, size, decoded));
+				frame[idx] ^= 0x10;
+			}
+
+			// end of binary mode: header 0 and crc
+
+			move.header = CBinaryGCode::EndBinary;
+			Assert::AreEqual((uint8_t)2, CBinaryGCode::Encode(move, frame));
+			Assert::AreEqual((uint8_t)2, CBinaryGCode::FrameSize(frame, 2));
+			Assert::IsTrue(CBinaryGCode::Decode(frame, 2, decoded));
+			Assert::AreEqual((uint8_t)CBinaryGCode::EndBinary, decoded.header);
+		}
+	};
+}
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////
+/*
+This file is part of CNCLib - A library for stepper motors.
+
+Copyright (c) 2013-2018 Herbert Aitenbichler
+
+CNCLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+CNCLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include <string>
+#include <vector>
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <Control.h>
+#include <BinaryGCode.h>
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	// input: all chars are available at once (e.g. more lines in one read), output is captured
+
+	class CTestStream : public Stream
+	{
+	public:
+
+		const char*	_input = "";
+		const char*	_inputEnd = NULL;						// binary input (with '\0'), NULL => strlen
+		std::string	_output;
+
+		virtual int available() override				{ return (int) (_inputEnd ? _inputEnd - _input : strlen(_input)); }
+		virtual char read() override					{ return *_input++; }
+		virtual void write(const char* s) override		{ _output += s; }
+
+		int Count(const char* text)
+		{
+			int count = 0;
+			for (size_t pos = _output.find(text); pos != std::string::npos; pos = _output.find(text, pos + 1))
+				count++;
+			return count;
+		}
+	};
+
+	class CTestControl : public CControl
+	{
+	public:
+
+		std::vector<std::string>	_commands;
+		uint8_t						_bufferFree = 0;
+		CTestStream*				_waitStream = NULL;			// received while "CLEAR" is executing (see OnWaitEvent)
+
+		void ReadAndExecute(CTestStream& stream)		{ ReadAndExecuteCommand(&stream, &stream, false); }
+		void FileReadAndExecute(CTestStream& stream)	{ ReadAndExecuteCommand(&stream, &stream, true); }
+
+	protected:
+
+		virtual bool IsKill() override					{ return false; }
+
+		virtual bool Command(char* buffer, Stream* output) override
+		{
+			// no parser: record the line and answer "ok", M130 see CGCodeParser
+			if (strcmp(buffer, "CLEAR") == 0)
+			{
+				ClearBuffer();
+				Receive(_waitStream, output, false);
+			}
+
+			_commands.push_back(buffer);
+			_bufferFree = GetBufferFree();
+
+			if (strcmp(buffer, "M130") == 0 && !SetBinaryMode())
+			{
+				output->println(MESSAGE_GCODE_BinaryModeSerialOnly);
+				return false;
+			}
+
+			output->println(MESSAGE_OK);
+			return true;
+		}
+	};
+
+	TEST_CLASS(CControlTest)
+	{
+	public:
+
+		TEST_METHOD(ControlReceiveTwoLinesTest)
+		{
+			CTestControl control;
+			CTestStream stream;
+
+			// both lines are received with the first read, one line is executed per call
+
+			stream._input = "G1 X1\nG1 X2\n";
+			control.ReadAndExecute(stream);
+
+			Assert::AreEqual((size_t)1, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[0].c_str());
+			Assert::AreEqual((uint8_t)6, control.GetBufferCount());
+			Assert::AreEqual((uint8_t)(SERIALBUFFERSIZE - 12 + 6), control._bufferFree);	// executing line is not counted
+
+			control.ReadAndExecute(stream);
+
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("G1 X2", control._commands[1].c_str());
+			Assert::AreEqual((uint8_t)0, control.GetBufferCount());
+			Assert::AreEqual((uint8_t)SERIALBUFFERSIZE, control._bufferFree);
+			Assert::AreEqual(2, stream.Count(MESSAGE_OK));
+		}
+
+		TEST_METHOD(ControlReceiveOverlongLineTest)
+		{
+			CTestControl control;
+			CTestStream stream;
+
+			// the line does not fit in the buffer => one "Flush Buffer" as response of the line, the rest of the line is skipped
+
+			std::string input(SERIALBUFFERSIZE + 20, 'X');
+			input += "\nG1 X1\n";
+			stream._input = input.c_str();
+
+			control.ReadAndExecute(stream);
+			control.ReadAndExecute(stream);
+			control.ReadAndExecute(stream);
+
+			Assert::AreEqual((size_t)1, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[0].c_str());
+			Assert::AreEqual(1, stream.Count(MESSAGE_CONTROL_FLUSHBUFFER));
+			Assert::AreEqual(1, stream.Count(MESSAGE_OK));
+			Assert::AreEqual((uint8_t)0, control.GetBufferCount());
+		}
+
+		TEST_METHOD(ControlReceiveOverlongFileLineTest)
+		{
+			CTestControl control;
+			CTestStream file;
+			CTestStream serial;
+
+			// the rest of an overlong file line is skipped with the file => the next serial command is not skipped
+
+			std::string input(SERIALBUFFERSIZE + 20, 'X');
+			input += "\nG1 X1\n";
+			file._input = input.c_str();
+
+			control.FileReadAndExecute(file);
+			Assert::AreEqual((size_t)0, control._commands.size());
+			Assert::AreEqual(1, file.Count(MESSAGE_CONTROL_FLUSHBUFFER));
+
+			serial._input = "G1 X2\n";
+			control.ReadAndExecute(serial);
+			Assert::AreEqual((size_t)1, control._commands.size());
+			Assert::AreEqual("G1 X2", control._commands[0].c_str());
+			Assert::AreEqual(1, serial.Count(MESSAGE_OK));
+
+			control.FileReadAndExecute(file);
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[1].c_str());
+		}
+
+		TEST_METHOD(ControlClearBufferWhileExecutingTest)
+		{
+			CTestControl control;
+			CTestStream stream;
+			CTestStream wait;
+
+			// ClearBuffer while a line is executing (e.g. Resurrect) => the line received while executing does not overwrite it
+
+			control._waitStream = &wait;
+			wait._input = "G1 X1\n";
+			stream._input = "CLEAR\n";
+
+			control.ReadAndExecute(stream);
+			Assert::AreEqual((size_t)1, control._commands.size());
+			Assert::AreEqual("CLEAR", control._commands[0].c_str());
+			Assert::AreEqual((uint8_t)6, control.GetBufferCount());
+
+			control.ReadAndExecute(stream);
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[1].c_str());
+		}
+
+		TEST_METHOD(ControlPostCommandTest)
+		{
+			CTestControl control;
+			CTestStream stream;
+
+			// PostCommand uses the free part of the buffer => the pending line is not modified
+
+			stream._input = "G1 X1\nG1 X2\n";
+			control.ReadAndExecute(stream);
+
+			Assert::IsTrue(control.PostCommand(F("M114"), &stream));
+
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("M114", control._commands[1].c_str());
+			Assert::AreEqual((uint8_t)6, control.GetBufferCount());
+
+			control.ReadAndExecute(stream);
+
+			Assert::AreEqual((size_t)3, control._commands.size());
+			Assert::AreEqual("G1 X2", control._commands[2].c_str());
+			Assert::AreEqual(3, stream.Count(MESSAGE_OK));
+		}
+
+		TEST_METHOD(ControlBinaryResyncTest)
+		{
+			CTestControl control;
+			CTestStream stream;
+
+			// crc error => Nak, the following (valid) frame is discarded with Nak, the bytes of a broken frame are skipped
+			// until EndBinary (the zero bytes complete the broken frame) => no binary byte is a text command
+
+			uint8_t frame[CBinaryGCode::MaxFrameSize];
+			CBinaryGCode::SMove move = { 0 };
+			move.header = CBinaryGCode::CutMove | 1 | 2;
+			move.distance[0] = 1000;
+			move.distance[1] = -2000;
+
+			std::string input;
+			uint8_t size = CBinaryGCode::Encode(move, frame);
+			frame[size - 1] ^= 0x55;
+			input.append((const char*) frame, size);
+
+			size = CBinaryGCode::Encode(move, frame);
+			input.append((const char*) frame, size);
+
+			input += (char) (CBinaryGCode::AxisMask | CBinaryGCode::FeedRate);		// broken frame: header of 7 varints
+
+			move = { 0 };
+			size = CBinaryGCode::Encode(move, frame);
+			Assert::AreEqual((uint8_t)2, size);
+			for (int i = 0; i < 4; i++)
+				input.append((const char*) frame, size);
+
+			input += "G1 X1\n";
+
+			stream._input = "M130\n";
+			control.ReadAndExecute(stream);
+			Assert::IsTrue(control.IsBinaryMode());
+
+			stream._input = input.c_str();
+			stream._inputEnd = stream._input + input.size();
+
+			for (int i = 0; i < 20; i++)
+				control.ReadAndExecute(stream);
+
+			Assert::IsFalse(control.IsBinaryMode());
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[1].c_str());
+			Assert::AreEqual(2, stream.Count(std::string(1, char(CBinaryGCode::Nak)).c_str()));
+			Assert::AreEqual(1, stream.Count(std::string(1, char(CBinaryGCode::Ack)).c_str()));
+			Assert::AreEqual(2, stream.Count(MESSAGE_OK));
+			Assert::AreEqual((uint8_t)0, control.GetBufferCount());
+		}
+
+		TEST_METHOD(ControlBinaryModeFileTest)
+		{
+			CTestControl control;
+			CTestStream file;
+			CTestStream serial;
+
+			// M130 from a file => error, the next line of the file is text
+
+			file._input = "M130\nG1 X1\n";
+			control.FileReadAndExecute(file);
+			Assert::IsFalse(control.IsBinaryMode());
+			Assert::AreEqual(1, file.Count(MESSAGE_GCODE_BinaryModeSerialOnly));
+
+			control.FileReadAndExecute(file);
+			Assert::AreEqual((size_t)2, control._commands.size());
+			Assert::AreEqual("G1 X1", control._commands[1].c_str());
+
+			// M130 from serial while a file is executing => error
+
+			control.StartPrintFromSD();
+			serial._input = "M130\n";
+			control.ReadAndExecute(serial);
+			Assert::IsFalse(control.IsBinaryMode());
+			Assert::AreEqual(1, serial.Count(MESSAGE_GCODE_BinaryModeSerialOnly));
+
+			control.ClearPrintFromSD();
+			serial._input = "M130\n";
+			control.ReadAndExecute(serial);
+			Assert::IsTrue(control.IsBinaryMode());
+
+			// a file line is text in binary mode (of serial)
+
+			file._input = "G1 X2\n";
+			control.FileReadAndExecute(file);
+			Assert::IsTrue(control.IsBinaryMode());
+			Assert::AreEqual((size_t)5, control._commands.size());
+			Assert::AreEqual("G1 X2", control._commands[4].c_str());
+		}
+	};
+}
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////
+/*
+This file is part of CNCLib - A library for stepper motors.
+
+Copyright (c) 2013-2018 Herbert Aitenbichler
+
+CNCLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+CNCLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <ExpressionParser.h>
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	TEST_CLASS(CExpressionParserTest)
+	{
+	public:
+
+		static expr_t Parse(const char* expression, uint8_t* code, uint8_t& codesize)
+		{
+			char buffer[128];
+			strcpy(buffer, expression);
+
+			CStreamReader reader;
+			reader.Init(buffer);
+
+			CExpressionParser parser(&reader, &Serial);
+			parser.SetCodeBuffer(code, codesize);
+			parser.Parse();
+			Assert::IsFalse(parser.IsError());
+
+			codesize = parser.GetCodeSize();
+			return parser.Answer;
+		}
+
+		static expr_t Execute(const uint8_t* code, uint8_t codesize)
+		{
+			CStreamReader reader;
+			reader.Init((char*) "");
+
+			CExpressionParser parser(&reader, &Serial);
+			expr_t answer = parser.Execute(code, codesize);
+			Assert::IsFalse(parser.IsError());
+			return answer;
+		}
+
+		TEST_METHOD(ExpressionParserByteCodeTest)
+		{
+			const char* expressions[] =
+			{
+				"1+2*3",
+				"-(4-6)^2",
+				"2*sin(PI/4)*sqrt(2)",
+				"(1<2)+(3>=4)+(5==5)",
+				"3!+7%4",
+				"abs(-3.5)*-2",
+				"((((((1+2)*3)+4)*5)+6)*7)"
+			};
+
+			for (const char* expression : expressions)
+			{
+				uint8_t code[64];
+				uint8_t codesize = sizeof(code);
+				expr_t answer = Parse(expression, code, codesize);
+
+				Assert::AreNotEqual((uint8_t)0, codesize);
+				Assert::AreEqual(answer, Execute(code, codesize));
+			}
+		}
+
+		TEST_METHOD(ExpressionParserByteCodeOverflowTest)
+		{
+			// code buffer too small => not compiled, but parsed
+
+			uint8_t code[8];
+			uint8_t codesize = sizeof(code);
+			Assert::AreEqual((expr_t)6.0, Parse("1+2+3", code, codesize));
+			Assert::AreEqual((uint8_t)0, codesize);
+
+			// stack too deep
+
+			uint8_t code2[128];
+			codesize = sizeof(code2);
+			Assert::AreEqual((expr_t)9.0, Parse("1+(1+(1+(1+(1+(1+(1+(1+(1))))))))", code2, codesize));
+			Assert::AreEqual((uint8_t)0, codesize);
+		}
+	};
+}
@@ -0,0 +1,369 @@
+////////////////////////////////////////////////////////
+/*
+This file is part of CNCLib - A library for stepper motors.
+
+Copyright (c) 2013-2018 Herbert Aitenbichler
+
+CNCLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+CNCLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <GCodeParser.h>
+#include <Control.h>
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	class CTestParser : public CGCodeParser
+	{
+	private:
+
+		typedef CGCodeParser super;
+
+	public:
+
+		CTestParser() : super(&_streamreader, &Serial) { }
+
+		mm1000_t _linePreset[NUM_AXIS];				// preset while parsing the line (e.g. modeless G53)
+
+		void ParseLine(const char* line, bool expectError = false)
+		{
+			char buffer[128];
+			strcpy(buffer, line);
+			_streamreader.Init(buffer);
+			_error = 0;								// CControl uses a new parser for each line
+
+			ParseCommand();
+			Assert::AreEqual(expectError, IsError());
+
+			CheckPreset();
+		}
+
+		void CheckPreset()
+		{
+			for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+			{
+				Assert::AreEqual(CalcAllPreset(axis), GetAllPresetCached(axis));
+			}
+		}
+
+		mm1000_t GetPreset(axis_t axis) { return GetAllPresetCached(axis); }
+		mm1000_t GetParam(param_t paramNo) { return GetParamValue(paramNo, false); }
+
+	protected:
+
+		virtual void CleanupParse() override
+		{
+			CheckPreset();
+			for (axis_t axis = 0; axis < NUM_AXIS; axis++)
+			{
+				_linePreset[axis] = GetAllPresetCached(axis);
+			}
+			super::CleanupParse();
+		}
+
+	private:
+
+		CStreamReader _streamreader;
+	};
+
+	class CG5TestControl : public CControl
+	{
+	protected:
+
+		virtual bool IsKill() override { return false; }		// G5 calls CControl (OnStartCut)
+	};
+
+	class CG5MotionControl : public CMotionControlBase
+	{
+	public:
+
+		unsigned short	_segments = 0;
+		mm1000_t		_points[1024][2];
+
+		virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t) override
+		{
+			if (_segments < 1024)
+			{
+				_points[_segments][0] = to[X_AXIS];
+				_points[_segments][1] = to[Y_AXIS];
+			}
+			_segments++;
+			memcpy(_current, to, sizeof(_current));
+		}
+
+		void Start()
+		{
+			memset(_current, 0, sizeof(_current));
+			_segments = 0;
+		}
+	};
+
+	TEST_CLASS(CGCodeParserTest)
+	{
+	public:
+
+		CMsvcStepper Stepper;
+
+		TEST_METHOD(GCodeParserPresetCacheTest)
+		{
+			Stepper.Init();
+
+			CMotionControlBase mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			CGCodeParser::Init();
+
+			CTestParser parser;
+			parser.CheckPreset();
+			Assert::AreEqual((mm1000_t)0, parser.GetPreset(X_AXIS));
+
+			// G92: current position (0) is X10
+
+			parser.ParseLine("G92 X10");
+			Assert::AreEqual((mm1000_t)10000, parser.GetPreset(X_AXIS));
+
+			// G10 L2: offset of the current (G54) and another (G55) coordinate system
+
+			parser.ParseLine("G10 L2 P1 X1 Y2");
+			Assert::AreEqual((mm1000_t)(1000 + 10000), parser.GetPreset(X_AXIS));
+			Assert::AreEqual((mm1000_t)2000, parser.GetPreset(Y_AXIS));
+
+			parser.ParseLine("G10 L2 P2 X3 Y4");
+			Assert::AreEqual((mm1000_t)(1000 + 10000), parser.GetPreset(X_AXIS));
+
+			// #5221: G54 X offset
+
+			parser.ParseLine("#5221=5");
+			Assert::AreEqual((mm1000_t)(5000 + 10000), parser.GetPreset(X_AXIS));
+
+			// G54..G59
+
+			parser.ParseLine("G55");
+			Assert::AreEqual((mm1000_t)(3000 + 10000), parser.GetPreset(X_AXIS));
+			Assert::AreEqual((mm1000_t)4000, parser.GetPreset(Y_AXIS));
+
+			parser.ParseLine("G59");
+			Assert::AreEqual((mm1000_t)10000, parser.GetPreset(X_AXIS));
+			Assert::AreEqual((mm1000_t)0, parser.GetPreset(Y_AXIS));
+
+			parser.ParseLine("G54");
+			Assert::AreEqual((mm1000_t)(5000 + 10000), parser.GetPreset(X_AXIS));
+
+			// G43: tool height (tool 1 => 20mm) on the plane axis (G17 => Z), G43 without H => no tool height
+
+			parser.ParseLine("G43 H1");
+			Assert::AreEqual((mm1000_t)20000, parser.GetPreset(Z_AXIS));
+
+			parser.ParseLine("G18");
+			Assert::AreEqual((mm1000_t)0, parser.GetPreset(Z_AXIS));
+			Assert::AreEqual((mm1000_t)(2000 + 20000), parser.GetPreset(Y_AXIS));
+
+			parser.ParseLine("G17");
+			Assert::AreEqual((mm1000_t)20000, parser.GetPreset(Z_AXIS));
+
+			parser.ParseLine("G43");
+			Assert::AreEqual((mm1000_t)0, parser.GetPreset(Z_AXIS));
+
+			// G53 is modeless: machine coordinates for this line only
+
+			parser.ParseLine("G43 H1 G53");
+			Assert::AreEqual((mm1000_t)0, parser._linePreset[X_AXIS]);
+			Assert::AreEqual((mm1000_t)0, parser._linePreset[Z_AXIS]);
+			Assert::AreEqual((mm1000_t)(5000 + 10000), parser.GetPreset(X_AXIS));
+			Assert::AreEqual((mm1000_t)20000, parser.GetPreset(Z_AXIS));
+
+			// G92 without axis: clear G92
+
+			parser.ParseLine("G92");
+			Assert::AreEqual((mm1000_t)5000, parser.GetPreset(X_AXIS));
+		}
+
+		TEST_METHOD(GCodeParserJunctionDeviationTest)
+		{
+			Stepper.Init();
+
+			// x: 2 steps/mm1000, y: 1 step/mm1000, z: 4 steps/mm1000
+
+			CMotionControlBase mc;
+			mc.InitConversion(
+				[](axis_t axis, sdist_t val) { return (mm1000_t)(axis == Y_AXIS ? val : axis == Z_AXIS ? val / 4 : val / 2); },
+				[](axis_t axis, mm1000_t val) { return (sdist_t)(axis == Y_AXIS ? val : axis == Z_AXIS ? val * 4 : val * 2); }
+			);
+
+			CGCodeParser::Init();
+
+			CTestParser parser;
+
+			// smallest steps/mm1000 of xyz => y
+
+			parser.ParseLine("G64 P0.05");
+			Assert::AreEqual((mdist_t)50, Stepper.GetJunctionDeviation());
+
+			parser.ParseLine("G61");
+			Assert::AreEqual((mdist_t)0, Stepper.GetJunctionDeviation());
+
+			parser.ParseLine("G64 P0.05");
+			parser.ParseLine("G64");
+			Assert::AreEqual((mdist_t)0, Stepper.GetJunctionDeviation());
+
+			// next program
+
+			parser.ParseLine("G64 P0.05");
+			CGCodeParser::Init();
+			Assert::AreEqual((mdist_t)0, Stepper.GetJunctionDeviation());
+		}
+
+		TEST_METHOD(GCodeParserG5Test)
+		{
+			Stepper.Init();
+
+			CG5TestControl control;
+			CG5MotionControl mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			CGCodeParser::Init();
+
+			CTestParser parser;
+
+			// P Q are required, I J are required for the first G5
+
+			mc.Start();
+			parser.ParseLine("G5 X10 Y10 I5 J0", true);
+			parser.ParseLine("G5 X10 Y10 P0 Q-5", true);
+			Assert::AreEqual((unsigned short)0, mc._segments);
+
+			// I J omitted after a G5 => mirror of P Q of the previous G5
+
+			parser.ParseLine("G5 X10 Y10 I5 J0 P0 Q-5");
+			mc.Start();
+			parser.ParseLine("G5 X20 Y20 P0 Q-5");
+
+			unsigned short segments = mc._segments;
+			mm1000_t mirrored[1024][2];
+			memcpy(mirrored, mc._points, sizeof(mirrored));
+
+			parser.ParseLine("G5 X10 Y10 I5 J0 P0 Q-5");
+			mc.Start();
+			parser.ParseLine("G5 X20 Y20 I0 J5 P0 Q-5");
+
+			Assert::IsTrue(segments > 1);
+			Assert::AreEqual(segments, mc._segments);
+			Assert::AreEqual(0, memcmp(mirrored, mc._points, sizeof(mirrored[0]) * segments));
+			Assert::AreEqual((mm1000_t)20000, mc._points[segments - 1][0]);
+			Assert::AreEqual((mm1000_t)20000, mc._points[segments - 1][1]);
+
+			// G5.1 requires I and J
+
+			mc.Start();
+			parser.ParseLine("G5.1 X10 Y10 I5", true);
+			parser.ParseLine("G5.1 X10 Y10 J5", true);
+			Assert::AreEqual((unsigned short)0, mc._segments);
+			parser.ParseLine("G5.1 X10 Y10 I5 J0");
+			Assert::AreEqual((mm1000_t)10000, mc._points[mc._segments - 1][0]);
+		}
+
+		TEST_METHOD(GCodeParserOWordTest)
+		{
+			Stepper.Init();
+
+			CMotionControlBase mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			CGCodeParser::Init();
+
+			CTestParser parser;
+
+			// keywords are case insensitive
+
+			parser.ParseLine("#1=0");
+			parser.ParseLine("O1 REPEAT [3]");
+			parser.ParseLine("#1=[#1+1]");
+			parser.ParseLine("o1 endrepeat");
+			Assert::AreEqual((mm1000_t)3000, parser.GetParam(1));
+
+			parser.ParseLine("#2=0");
+			parser.ParseLine("O2 WHILE [#2 < 2]");
+			parser.ParseLine("#2=[#2+1]");
+			parser.ParseLine("O2 ENDWHILE");
+			Assert::AreEqual((mm1000_t)2000, parser.GetParam(2));
+
+			parser.ParseLine("O3 Sub");
+			parser.ParseLine("#3=[#3+5]");
+			parser.ParseLine("O3 RETURN");
+			parser.ParseLine("#3=100");
+			parser.ParseLine("O3 ENDSUB");
+			parser.ParseLine("#3=0");
+			parser.ParseLine("O3 CALL");
+			parser.ParseLine("O3 call");
+			Assert::AreEqual((mm1000_t)10000, parser.GetParam(3));
+		}
+
+		TEST_METHOD(GCodeParserOWordBufferFullTest)
+		{
+			Stepper.Init();
+
+			CMotionControlBase mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			CGCodeParser::Init();
+
+			CTestParser parser;
+
+			// the block does not fit in the buffer => error, the rest of the block (with a nested block) is discarded, not executed
+
+			parser.ParseLine("#4=0");
+			parser.ParseLine("O4 REPEAT [2]");
+
+			// recorded without spaces: "O4REPEAT[2]" and "#4=[#4+1]" with '\0'
+
+			for (int i = 0; i < (OWORD_BUFFERSIZE - 12) / 10; i++)
+				parser.ParseLine("#4=[#4+1]");
+
+			parser.ParseLine("#4=[#4+1]", true);
+			parser.ParseLine("N10 O5 REPEAT [3]");
+			parser.ParseLine("#4=[#4+100]");
+			parser.ParseLine("O5 ENDREPEAT");
+			parser.ParseLine("#4=[#4+1000]");
+			parser.ParseLine("O4 ENDREPEAT");
+			Assert::AreEqual((mm1000_t)0, parser.GetParam(4));
+
+			// next lines are executed and recorded again
+
+			parser.ParseLine("#4=[#4+1]");
+			parser.ParseLine("O6 REPEAT [2]");
+			parser.ParseLine("#4=[#4+1]");
+			parser.ParseLine("O6 ENDREPEAT");
+			Assert::AreEqual((mm1000_t)3000, parser.GetParam(4));
+		}
+	};
+}
@@ -1,4 +1,4 @@
-////////////////////////////////////////////////////////
+﻿////////////////////////////////////////////////////////
 /*
 This file is part of CNCLib - A library for stepper motors.
 
@@ -22,6 +22,8 @@ http://www.gnu.org/licenses/
 #include "CppUnitTest.h"
 
 #include "..\MsvcStepper\MsvcStepper.h"
+#include <MotionControl.h>
+#include <MotionControlT.h>
 
 ////////////////////////////////////////////////////////
 
@@ -29,6 +31,172 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace StepperSystemTest
 {
+	class CArcMotionControl : public CMotionControlBase
+	{
+	public:
+
+		unsigned short	_segments = 0;
+		mm1000_t		_maxDeviation = 0;
+		mm1000_t		_center[2] = { 0, 0 };
+		mm1000_t		_radius = 0;
+
+		virtual bool CanMoveArc() override { return false; }		// count segments
+
+		virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t) override
+		{
+			// deviation of the chord (midpoint) to the arc
+			float mid0 = (_current[X_AXIS] + to[X_AXIS]) / 2.0f - _center[0];
+			float mid1 = (_current[Y_AXIS] + to[Y_AXIS]) / 2.0f - _center[1];
+			mm1000_t deviation = (mm1000_t)(_radius - hypot(mid0, mid1));
+
+			_maxDeviation = max(_maxDeviation, deviation);
+			_segments++;
+			memcpy(_current, to, sizeof(_current));
+		}
+
+		void Circle(mm1000_t radius, feedrate_t feedrate)
+		{
+			mm1000_t to[NUM_AXIS] = { 0 };
+			memset(_current, 0, sizeof(_current));
+			_center[0] = radius;
+			_radius = radius;
+			_segments = 0;
+			_maxDeviation = 0;
+			Arc(to, radius, 0, X_AXIS, Y_AXIS, false, feedrate);
+		}
+	};
+
+	class CBezierMotionControl : public CMotionControlBase
+	{
+	public:
+
+		unsigned short	_segments = 0;
+		mm1000_t		_points[1024][2];
+
+		virtual void MoveAbs(const mm1000_t to[NUM_AXIS], feedrate_t) override
+		{
+			if (_segments < 1024)
+			{
+				_points[_segments][0] = to[X_AXIS];
+				_points[_segments][1] = to[Y_AXIS];
+			}
+			_segments++;
+			memcpy(_current, to, sizeof(_current));
+		}
+
+		float MaxDeviation(const float p[4][2])
+		{
+			// distance of the exact curve to the nearest line segment
+			float maxdist = 0;
+			for (int n = 0; n <= 2000; n++)
+			{
+				float t = n / 2000.0f;
+				float u = 1.0f - t;
+				float x = u*u*u*p[0][0] + 3 * u*u*t*p[1][0] + 3 * u*t*t*p[2][0] + t*t*t*p[3][0];
+				float y = u*u*u*p[0][1] + 3 * u*u*t*p[1][1] + 3 * u*t*t*p[2][1] + t*t*t*p[3][1];
+
+				float mindist = 1e10f;
+				float x0 = p[0][0];
+				float y0 = p[0][1];
+				for (unsigned short i = 0; i < _segments; i++)
+				{
+					float x1 = (float)_points[i][0];
+					float y1 = (float)_points[i][1];
+					float dx = x1 - x0;
+					float dy = y1 - y0;
+					float len2 = dx*dx + dy*dy;
+					float s = len2 > 0 ? ((x - x0)*dx + (y - y0)*dy) / len2 : 0;
+					s = s < 0 ? 0 : (s > 1 ? 1 : s);
+					mindist = min(mindist, hypot(x - (x0 + s*dx), y - (y0 + s*dy)));
+					x0 = x1;
+					y0 = y1;
+				}
+				maxdist = max(maxdist, mindist);
+			}
+			return maxdist;
+		}
+
+		bool IsEndPoint(const mm1000_t to[NUM_AXIS])
+		{
+			return _segments > 0 && _segments <= 1024 && _points[_segments - 1][0] == to[X_AXIS] && _points[_segments - 1][1] == to[Y_AXIS];
+		}
+
+		float MinSegmentLength()
+		{
+			// shortest segment, without the last (rest up to the end point)
+			float minlength = 1e10f;
+			for (unsigned short i = 1; i + 1 < _segments && i < 1024; i++)
+			{
+				minlength = min(minlength, (float) hypot(_points[i][0] - _points[i - 1][0], _points[i][1] - _points[i - 1][1]));
+			}
+			return minlength;
+		}
+
+		void Start()
+		{
+			memset(_current, 0, sizeof(_current));
+			_segments = 0;
+		}
+	};
+
+
+	class CKinematicsMotionControl : public CMotionControlBase
+	{
+	public:
+
+		unsigned short	_segments = 0;
+		mm1000_t		_maxDeviation = 0;
+
+
+		virtual mm1000_t GetMaxSegmentLength() override			{ return 10000; }
+		virtual mm1000_t GetSegmentTolerance() override			{ return 20; }
+
+		virtual bool TransformPosition(const mm1000_t src[NUM_AXIS], mm1000_t dest[NUM_AXIS]) override
+		{
+			// X is bent by Y: x + y*y/100000 => deviation of a segment (Y) with length l is l*l/400000
+			memcpy(dest, src, sizeof(_current));
+			dest[X_AXIS] += src[Y_AXIS] * src[Y_AXIS] / 100000;
+			return true;
+		}
+
+		virtual void MoveAbsTransformed(const mm1000_t to[NUM_AXIS], const mm1000_t to_proj[NUM_AXIS], feedrate_t) override
+		{
+			// deviation of the exact (bent) midpoint to the transformed line
+			mm1000_t mid[NUM_AXIS];
+			mm1000_t mid_proj[NUM_AXIS];
+			mm1000_t from_proj[NUM_AXIS];
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+				mid[x] = (_current[x] + to[x]) / 2;
+			TransformPosition(mid, mid_proj);
+			TransformPosition(_current, from_proj);
+
+			_maxDeviation = max(_maxDeviation, abs(mid_proj[X_AXIS] - (from_proj[X_AXIS] + to_proj[X_AXIS]) / 2));
+			_segments++;
+			memcpy(_current, to, sizeof(_current));
+		}
+
+		void Start()
+		{
+			memset(_current, 0, sizeof(_current));
+			_segments = 0;
+			_maxDeviation = 0;
+		}
+	};
+
+	class CSegmentMotionControlT : public CMotionControlT<200 * 16, 1000>
+	{
+	public:
+
+		unsigned short	_segments = 0;
+
+		virtual mm1000_t GetMaxSegmentLength() override			{ return 10000; }
+
+		virtual void MoveAbsTransformed(const mm1000_t to[NUM_AXIS], const mm1000_t[NUM_AXIS], feedrate_t) override
+		{
+			_segments++;
+			memcpy(_current, to, sizeof(_current));
+		}
+	};
 
 	TEST_CLASS(CMotionControlTest)
 	{
@@ -87,7 +255,7 @@ namespace StepperSystemTest
 
 			Assert::AreEqual((long)1209, (long)mc.GetFeedRate(to2, 1234 * 60));
 
-			Assert::AreEqual((long)1159, (long)mc.GetFeedRate(to3, 1234 * 60));
+			Assert::AreEqual((long)1160, (long)mc.GetFeedRate(to3, 1234 * 60));		// 1160.86
 		}
 
 		TEST_METHOD(FeedRateOverrun16BitTest)
@@ -105,9 +273,175 @@ namespace StepperSystemTest
 
 			Assert::AreEqual((long)12345, (long)mc.GetFeedRate(to1, 123456 * 60));
 
-			Assert::AreEqual((long)11022, (long)mc.GetFeedRate(to2, 123456 * 60));
+			Assert::AreEqual((long)11042, (long)mc.GetFeedRate(to2, 123456 * 60));	// 11042.2
+
+			Assert::AreEqual((long)9898, (long)mc.GetFeedRate(to3, 123456 * 60));		// 9898.4
+		}
+
+		TEST_METHOD(MotionControlTTest)
+		{
+			// compile time conversion: 200*16 steps per 1mm (=> 16/5) is the same as ToMachine_1_3200
+
+			CMotionControlT<200 * 16, 1000> mc;
+			mc.UnitTest();
+
+			Assert::IsTrue(mc.IsConversionFixed());
+
+			for (mm1000_t mm1000 = 0; mm1000 < 1000000; mm1000 += 777)
+			{
+				Assert::AreEqual(CMotionControlBase::ToMachine_1_3200(X_AXIS, mm1000), CMotionControlBase::ToMachine(X_AXIS, mm1000));
+				Assert::AreEqual(CMotionControlBase::ToMm1000_1_3200(X_AXIS, mm1000), CMotionControlBase::ToMm1000(X_AXIS, mm1000));
+			}
+
+			Assert::AreEqual((long)3200, (long)mc.FeedRateToStepRate(X_AXIS, 60000));
+			Assert::AreEqual((long)3200, (long)CMotionControlBase::FeedRateToStepRate(X_AXIS, 60000));
+
+			// 4mm screw, 1/32 => reduced to 8/5
+
+			CMotionControlT<200 * 32, 4000> mc4;
+			Assert::AreEqual((sdist_t)16000, CMotionControlBase::ToMachine(Y_AXIS, 10000));
+			Assert::AreEqual((mm1000_t)10000, CMotionControlBase::ToMm1000(Y_AXIS, 16000));
+		}
+
+		TEST_METHOD(ArcChordToleranceTest)
+		{
+			CArcMotionControl mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			// segments from radius (SEGMENTS_K/SEGMENTS_D)
+
+			mc.Circle(50000, 100000);
+			Assert::AreEqual((unsigned short)1268, mc._segments);
+
+			// segments from chord deviation: theta = sqrt(8*5/50000)
+
+			mc.SetArcChordTolerance(5);
+			mc.Circle(50000, 100000);
+			Assert::AreEqual((unsigned short)223, mc._segments);
+			Assert::IsTrue(mc._maxDeviation <= 5 + 1);		// +1: segment end points are mm1000
+
+			mc.Circle(1000, 100000);
+			Assert::AreEqual((unsigned short)32, mc._segments);
+			Assert::IsTrue(mc._maxDeviation <= 5 + 1);		// +1: segment end points are mm1000
+
+			// limited by feedrate: ARC_MINSEGMENTTIME (1.8ms with MOVEMENTBUFFERSIZE 8) => 900 mm1000 at 30m/min
+
+			mc.SetArcChordTolerance(1);
+			mc.Circle(50000, 30000000);
+			Assert::AreEqual((unsigned short)350, mc._segments);
+		}
+
+		TEST_METHOD(BezierTest)
+		{
+			CBezierMotionControl mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			// cubic (s-curve), default tolerance BEZIER_CHORDTOLERANCE
+
+			const float s[4][2] = { { 0, 0 }, { 100000, 0 }, { 0, 100000 }, { 100000, 100000 } };
+			mm1000_t to[NUM_AXIS] = { 100000, 100000, 5000 };
+			mm1000_t c1[2] = { 100000, 0 };
+			mm1000_t c2[2] = { 0, 100000 };
+
+			mc.Start();
+			mc.CubicBezier(to, c1, c2, X_AXIS, Y_AXIS, 1000);
+			unsigned short segments = mc._segments;
+			Assert::IsTrue(mc.MaxDeviation(s) <= BEZIER_CHORDTOLERANCE + 1);	// +1: segment end points are mm1000
+			Assert::IsTrue(mc.IsEndPoint(to));
+			Assert::AreEqual((mm1000_t)5000, mc.GetPosition(Z_AXIS));
+
+			// smaller tolerance => more segments
+
+			mc.SetArcChordTolerance(1);
+			mc.Start();
+			mc.CubicBezier(to, c1, c2, X_AXIS, Y_AXIS, 1000);
+			Assert::IsTrue(mc._segments > segments);
+			Assert::IsTrue(mc.MaxDeviation(s) <= 1 + 1);
+			Assert::IsTrue(mc.IsEndPoint(to));
+
+			// limited by feedrate: the planner must keep up => no segment is shorter than ARC_MINSEGMENTTIME at this feedrate
+
+			float minlength = 30000000 * (ARC_MINSEGMENTTIME / 60000000.0f);
+			mc.Start();
+			mc.CubicBezier(to, c1, c2, X_AXIS, Y_AXIS, 30000000);
+			Assert::IsTrue(mc.MinSegmentLength() >= minlength * 0.99f);	// the step of t is scaled linear (the curve is not)
+			Assert::IsTrue(mc.IsEndPoint(to));
+
+			// straight line => one segment
+
+			mm1000_t l1[2] = { 20000, 20000 };
+			mm1000_t l2[2] = { 80000, 80000 };
+			mc.Start();
+			mc.CubicBezier(to, l1, l2, X_AXIS, Y_AXIS, 1000);
+			Assert::AreEqual((unsigned short)1, mc._segments);
+			Assert::IsTrue(mc.IsEndPoint(to));
+
+			// quadratic => same as the elevated cubic
+
+			const float q[4][2] = { { 0, 0 }, { 0, 100000 * 2.0f / 3.0f }, { 100000 / 3.0f, 100000 }, { 100000, 100000 } };
+			mm1000_t qc[2] = { 0, 100000 };
+			mc.SetArcChordTolerance(5);
+			mc.Start();
+			mc.QuadraticBezier(to, qc, X_AXIS, Y_AXIS, 1000);
+			Assert::IsTrue(mc.MaxDeviation(q) <= 5 + 1);
+			Assert::IsTrue(mc.IsEndPoint(to));
+		}
+
+		TEST_METHOD(KinematicsSegmentTest)
+		{
+			CKinematicsMotionControl mc;
+			mc.InitConversion(
+				[](axis_t, sdist_t val) { return (mm1000_t)val; },
+				[](axis_t, mm1000_t val) { return (sdist_t)val; }
+			);
+
+			// linear (X only) => split by the max length
+
+			mc.Start();
+			mc.MoveAbsEx(1000, X_AXIS, 20000, -1);
+			Assert::AreEqual((unsigned short)2, mc._segments);
+			Assert::AreEqual((mm1000_t)0, mc._maxDeviation);
+
+			// bent by Y => 2500 (deviation 16), the same length for a twice as long line (parabola)
+
+			mc.Start();
+			mc.MoveAbsEx(1000, Y_AXIS, 10000, -1);
+			Assert::AreEqual((unsigned short)4, mc._segments);
+			Assert::IsTrue(mc._maxDeviation <= 20);
+
+			mc.Start();
+			mc.MoveAbsEx(1000, Y_AXIS, 20000, -1);
+			Assert::AreEqual((unsigned short)8, mc._segments);
+			Assert::IsTrue(mc._maxDeviation <= 20);
+			Assert::AreEqual((mm1000_t)20000, mc.GetPosition(Y_AXIS));
+		}
+
+		TEST_METHOD(KinematicsSegmentTTest)
+		{
+			// CMotionControlT must not bypass the segments of MoveAbs
+
+			CSegmentMotionControlT mc;
+
+			mc.MoveAbsEx(1000, X_AXIS, 20000, -1);
+			Assert::AreEqual((unsigned short)2, mc._segments);
+			Assert::AreEqual((mm1000_t)20000, mc.GetPosition(X_AXIS));
+		}
+
+		TEST_METHOD(MotionControlRotateFixedPointTest)
+		{
+			CMotionControl mc;
+
+			// fixed point (Q30) rotation against float rotation (float path truncates each step)
+			Assert::IsTrue(mc.TestFixedPoint(false) <= 2);
 
-			Assert::AreEqual((long)9902, (long)mc.GetFeedRate(to3, 123456 * 60));
+			// 16x16 multiplies (AVR) against int64_t
+			Assert::IsTrue(CMotionControl::TestMulShift());
 		}
 	};
 }
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////
+/*
+This file is part of CNCLib - A library for stepper motors.
+
+Copyright (c) 2013-2018 Herbert Aitenbichler
+
+CNCLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+CNCLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+http://www.gnu.org/licenses/
+*/
+////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+
+#include "CppUnitTest.h"
+
+#include <string>
+
+#include "..\MsvcStepper\MsvcStepper.h"
+#include <Parser.h>
+
+////////////////////////////////////////////////////////
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StepperSystemTest
+{
+	// HPGL like parser (see Sketch/Plotter/HPGLParser.cpp): dispatch the two letter commands, record command and parameters
+
+	class CMnemonicParser : public CParser
+	{
+	private:
+
+		typedef CParser super;
+
+	public:
+
+		CMnemonicParser() : super(&_streamreader, &Serial) { }
+
+		using super::mnemonic_t;
+		using super::Mnemonic;
+
+		std::string _commands;
+
+		void ParseLine(const char* line)
+		{
+			strcpy(_buffer, line);
+			_streamreader.Init(_buffer);
+			_commands.clear();
+
+			while (_reader->GetChar() && !IsError())
+			{
+				Parse();
+			}
+		}
+
+		mnemonic_t TryMnemonicAt(const char* line, bool ignorecase)	{ return TryMnemonic(line, ignorecase); }
+
+	protected:
+
+		virtual void Parse() override
+		{
+			_reader->SkipSpaces();
+			switch (GetMnemonic(false))
+			{
+				case Mnemonic('S', 'P'): Command("SP");	return;
+				case Mnemonic('I', 'N'): Command("IN");	return;
+				case Mnemonic('P', 'D'): PenMoveCommand("PD");	return;
+				case Mnemonic('P', 'U'): PenMoveCommand("PU");	return;
+				case Mnemonic('P', 'A'): PenMoveCommand("PA");	return;
+				case Mnemonic('P', 'R'): PenMoveCommand("PR");	return;
+				case Mnemonic('L', 'T'): _commands += "LT "; _reader->MoveToEnd(); return;	// ignore rest of line
+			}
+
+			Error(MESSAGE_PARSER_EndOfCommandExpected);
+		}
+
+	private:
+
+		void Command(const char* name)
+		{
+			_commands += name;
+			while (IsInt(_reader->GetChar()))
+			{
+				_commands += std::to_string(GetInt32());
+				if (_reader->SkipSpaces() == ',')
+				{
+					_commands += ',';
+					_reader->GetNextChar();
+					_reader->SkipSpaces();
+				}
+			}
+			if (_reader->SkipSpaces() == ';')
+				_reader->GetNextChar();
+			_commands += ' ';
+		}
+
+		void PenMoveCommand(const char* name)
+		{
+			// PD and PA without ';' (e.g. "PDPA10,20;")
+
+			switch (TryMnemonic(false))
+			{
+				case Mnemonic('P', 'D'):
+				case Mnemonic('P', 'U'):
+				case Mnemonic('P', 'A'):
+				case Mnemonic('P', 'R'): _commands += name; _commands += ' '; return;
+			}
+			Command(name);
+		}
+
+		CStreamReader _streamreader;
+		char _buffer[128];
+	};
+
+	TEST_CLASS(CParserTest)
+	{
+	public:
+
+		TEST_METHOD(ParserMnemonicTest)
+		{
+			CMnemonicParser parser;
+
+			Assert::AreEqual((uint16_t)(('P' << 8) + 'A'), (uint16_t)parser.Mnemonic('P', 'A'));
+
+			parser.ParseLine("IN;SP1;PU10,20;PD30,40;");
+			Assert::IsFalse(parser.IsError());
+			Assert::AreEqual("IN SP1 PU10,20 PD30,40 ", parser._commands.c_str());
+
+			parser.ParseLine("PDPA10,20;PR 5 , -5;LT1,2;SP2");
+			Assert::IsFalse(parser.IsError());
+			Assert::AreEqual("PD PA10,20 PR5,-5 LT ", parser._commands.c_str());
+
+			// case sensitive
+
+			parser.ParseLine("pa10,20;");
+			Assert::IsTrue(parser.IsError());
+
+			// no two letters
+
+			parser.ParseLine("P10;");
+			Assert::IsTrue(parser.IsError());
+
+			parser.ParseLine("XY;");
+			Assert::IsTrue(parser.IsError());
+		}
+
+		TEST_METHOD(ParserTryMnemonicTest)
+		{
+			CMnemonicParser parser;
+
+			Assert::AreEqual((uint16_t)parser.Mnemonic('P', 'A'), (uint16_t)parser.TryMnemonicAt("PA10", false));
+			Assert::AreEqual((uint16_t)parser.Mnemonic('P', 'A'), (uint16_t)parser.TryMnemonicAt("pa10", true));
+			Assert::AreEqual((uint16_t)parser.Mnemonic('p', 'a'), (uint16_t)parser.TryMnemonicAt("pa10", false));
+			Assert::AreEqual((uint16_t)parser.Mnemonic('M', 'S'), (uint16_t)parser.TryMnemonicAt("(MSG,x)" + 1, true));
+
+			Assert::AreEqual((uint16_t)0, (uint16_t)parser.TryMnemonicAt("P1", false));
+			Assert::AreEqual((uint16_t)0, (uint16_t)parser.TryMnemonicAt("P", false));
+			Assert::AreEqual((uint16_t)0, (uint16_t)parser.TryMnemonicAt("", false));
+		}
+	};
+}
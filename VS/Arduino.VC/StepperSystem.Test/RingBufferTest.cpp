@@ -23,6 +23,8 @@ http://www.gnu.org/licenses/
 
 #include "CppUnitTest.h"
 
+#include <thread>
+
 ////////////////////////////////////////////////////////
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -66,34 +68,180 @@ namespace StepperSystemTest
 
 		TEST_METHOD(RingBufferInsertHeadTest)
 		{
-			TestRingBufferInsert(10, 60, 0);		// insert at head
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 128>>(10, 60, 0);		// insert at head
 		}
 
 		TEST_METHOD(RingBufferInsertTailTest)
 		{
-			TestRingBufferInsert(10, 60, 60);		// insert at tail (simple enqueue)
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 128>>(10, 60, 60);		// insert at tail (simple enqueue)
 		}
 
 		TEST_METHOD(RingBufferInsertTailM1Test)
 		{
-			TestRingBufferInsert(10, 60, 59);		// insert at tail-1
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 128>>(10, 60, 59);		// insert at tail-1
 		}
 
 		TEST_METHOD(RingBufferInsertTail2Test)
 		{
-			TestRingBufferInsert(0, 60, 30);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 128>>(0, 60, 30);
 		}
 
 		TEST_METHOD(RingBufferOverrunTest)
 		{
-			TestRingBufferInsert(128 - 10, 60, 30);	// buffer overrun
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 128>>(128 - 10, 60, 30);	// buffer overrun
 		}
 
-		void TestRingBufferInsert(uint8_t startidx, uint8_t buffersize, uint8_t insertoffset)
+		TEST_METHOD(RingBufferFullTest)
 		{
-			CRingBufferQueue<SRingbuffer, 128> buffer;
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 128>>(10);
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 128>>(200);
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 100>>(10);		// not 2^n
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 100>>(150);
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 512>>(10);		// > 254, index is uint16_t
+			TestRingBufferFull<CRingBufferQueue<SRingbuffer, 512>>(1000);
+			TestRingBufferFull<CRingBufferQueueSPSC<SRingbuffer, 128>>(10);
+			TestRingBufferFull<CRingBufferQueueSPSC<SRingbuffer, 100>>(150);
+		}
+
+		TEST_METHOD(RingBufferNotPow2InsertTest)
+		{
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 100>>(10, 60, 0);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 100>>(10, 60, 59);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 100>>(100 - 10, 60, 30);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 100>>(200 - 10, 60, 30);
+		}
+
+		TEST_METHOD(RingBufferLargeInsertTest)
+		{
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 512>>(10, 200, 0);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 512>>(512 - 10, 200, 199);
+			TestRingBufferInsert<CRingBufferQueue<SRingbuffer, 512>>(512 - 10, 200, 100);
+		}
+
+		TEST_METHOD(RingBufferSPSCTest)
+		{
+			CRingBufferQueueSPSC<SRingbuffer, 128> buffer;
+
+			Assert::AreEqual(true, buffer.IsEmpty());
+			Assert::AreEqual((uint8_t)128, buffer.FreeCount());
+
+			buffer.NextTail().i = 4711;
+			buffer.Enqueue();
+
+			Assert::AreEqual(false, buffer.IsEmpty());
+			Assert::AreEqual((uint8_t)1, buffer.Count());
+			Assert::AreEqual(4711, buffer.Head().i);
+
+			buffer.Dequeue();
+			Assert::AreEqual(true, buffer.IsEmpty());
+		}
+
+		TEST_METHOD(RingBufferSPSCInsertTest)
+		{
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingbuffer, 128>>(10, 60, 0);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingbuffer, 128>>(10, 60, 59);
+			TestRingBufferInsert<CRingBufferQueueSPSC<SRingbuffer, 128>>(128 - 10, 60, 30);
+		}
+
+		TEST_METHOD(RingBufferSPSCConcurrentTest)
+		{
+			// one producer and one consumer thread without any lock (like CalcNextSteps and StepOut)
+
+			static CRingBufferQueueSPSC<SRingbuffer, 16> buffer;
+			const int count = 1000000;
+			bool orderOK = true;
+			bool countOK = true;
+
+			std::thread producer([&]()
+			{
+				for (int i = 0; i < count; i++)
+				{
+					while (buffer.IsFull()) { std::this_thread::yield(); }
+					buffer.NextTail().i = i;
+					buffer.NextTail().d = i * 2.0;
+					buffer.Enqueue();
+				}
+			});
+
+			std::thread consumer([&]()
+			{
+				for (int i = 0; i < count; i++)
+				{
+					while (buffer.IsEmpty()) { std::this_thread::yield(); }
+					if (buffer.Count() > 16) countOK = false;
+					SRingbuffer& head = buffer.Head();
+					if (head.i != i || head.d != i * 2.0) orderOK = false;
+					buffer.Dequeue();
+				}
+			});
+
+			producer.join();
+			consumer.join();
+
+			Assert::AreEqual(true, orderOK);
+			Assert::AreEqual(true, countOK);
+			Assert::AreEqual(true, buffer.IsEmpty());
+		}
+
+		template <class TBuffer>
+		void TestRingBufferFull(int startidx)
+		{
+			TBuffer buffer;
+			typedef typename TBuffer::index_t index_t;
+			const int size = sizeof(buffer.Buffer) / sizeof(buffer.Buffer[0]);
+
+			for (int i = 0; i < startidx; i++)
+			{
+				buffer.Enqueue();
+				buffer.Dequeue();
+			}
+
+			Assert::AreEqual(true, buffer.IsEmpty());
+			Assert::AreEqual((index_t)(startidx % size), buffer.GetHeadPos());
+
+			for (int i = 0; i < size; i++)
+			{
+				Assert::AreEqual(false, buffer.IsFull());
+				Assert::AreEqual((index_t)(size - i), buffer.FreeCount());
+				buffer.NextTail().i = i;
+				buffer.Enqueue();
+				Assert::AreEqual((index_t)(i + 1), buffer.Count());
+				Assert::AreEqual(true, buffer.IsInQueue(buffer.GetTailPos()));
+			}
+
+			Assert::AreEqual(true, buffer.IsFull());
+			Assert::AreEqual(false, buffer.IsEmpty());
+
+			int expect = 0;
+			for (index_t idx = buffer.H2TInit(); buffer.H2TTest(idx); idx = buffer.H2TInc(idx))
+			{
+				Assert::AreEqual(true, buffer.IsInQueue(idx));
+				Assert::AreEqual(expect++, buffer.Buffer[idx].i);
+			}
+			Assert::AreEqual(size, expect);
+
+			for (index_t idx = buffer.T2HInit(); buffer.T2HTest(idx); idx = buffer.T2HInc(idx))
+			{
+				Assert::AreEqual(--expect, buffer.Buffer[idx].i);
+			}
+			Assert::AreEqual(0, expect);
+
+			buffer.RemoveTail(buffer.GetHeadPos());
+			Assert::AreEqual((index_t)1, buffer.Count());
+			Assert::AreEqual(false, buffer.IsInQueue(buffer.NextIndex(buffer.GetHeadPos())));
+
+			buffer.Dequeue();
+			Assert::AreEqual(true, buffer.IsEmpty());
+			Assert::AreEqual((index_t)0, buffer.Count());
+		}
+
+		template <class TBuffer>
+		void TestRingBufferInsert(int startidx, typename TBuffer::index_t buffersize, typename TBuffer::index_t insertoffset)
+		{
+			TBuffer buffer;
+			typedef typename TBuffer::index_t index_t;
 
-			uint8_t i;
+			int i;
 
 			for (i = 0; i < startidx; i++)
 			{
@@ -109,14 +257,14 @@ namespace StepperSystemTest
 
 			Assert::AreEqual(buffersize, buffer.Count());
 
-			uint8_t insertat = buffer.NextIndex(buffer.GetHeadPos(), insertoffset);
+			index_t insertat = buffer.NextIndex(buffer.GetHeadPos(), insertoffset);
 			buffer.InsertTail(insertat)->i = 2000;
 
-			Assert::AreEqual((uint8_t)(buffersize + 1), buffer.Count());
+			Assert::AreEqual((index_t)(buffersize + 1), buffer.Count());
 
 			int expect = 0;
 
-			for (uint8_t idx = buffer.H2TInit(); buffer.H2TTest(idx); idx = buffer.H2TInc(idx))
+			for (index_t idx = buffer.H2TInit(); buffer.H2TTest(idx); idx = buffer.H2TInc(idx))
 			{
 				if (idx != insertat)
 					Assert::AreEqual(expect++, buffer.Buffer[idx].i);
@@ -25,6 +25,8 @@ http://www.gnu.org/licenses/
 
 #include "CppUnitTest.h"
 
+#include <chrono>
+
 ////////////////////////////////////////////////////////
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -561,6 +563,220 @@ namespace StepperSystemTest
 			CreateTestFile("StopMove.csv");
 		}
 
+		unsigned long SquareTime(mdist_t junctionDeviation)
+		{
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			for (axis_t x = 0; x < NUM_AXIS; x++)
+				Stepper.SetJerkSpeed(x, 100);
+			Stepper.SetJunctionDeviation(junctionDeviation);
+
+			Stepper.MoveRel3(4000, 0, 0, 5000);
+			Stepper.MoveRel3(0, 4000, 0, 5000);
+			Stepper.MoveRel3(-4000, 0, 0, 5000);
+			Stepper.MoveRel3(0, -4000, 0, 5000);
+
+			CreateTestFile("JunctionDeviation.csv");
+
+			// total time is field 3 of the last line
+			FILE* f;
+			fopen_s(&f, GetResultFileName("JunctionDeviation.csv"), "rt");
+			Assert::IsTrue(f != NULL);
+
+			char line[512];
+			unsigned long time = 0;
+			while (fgets(line, sizeof(line), f))
+			{
+				time = atol(strchr(strchr(line, ';') + 1, ';') + 1);
+			}
+			fclose(f);
+
+			Stepper.SetJunctionDeviation(0);
+			return time;
+		}
+
+		TEST_METHOD(StepperJunctionDeviation)
+		{
+			// square: junction speed from jerk (almost stop) or from the corner tolerance (arc with r = 50 * 0.707 / (1 - 0.707) = 121 steps)
+
+			unsigned long timeJerk = SquareTime(0);
+			unsigned long timeDeviation = SquareTime(50);
+
+			Assert::IsTrue(timeDeviation < timeJerk * 9 / 10);
+			Assert::AreEqual((udist_t)0, Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((udist_t)0, Stepper.GetCurrentPosition(Y_AXIS));
+		}
+
+		long long QueuePlanMoves(uint8_t planMaxCount, uint8_t moves, timer_t timerStart[])
+		{
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 400, 100);
+			Stepper.SetPlanMaxCount(planMaxCount);
+			Stepper.DelayOptimization = false;				// plan for each QueueMove
+
+			// short moves (same direction), fast acc and slow dec => junction speed is limited by the stop at the tail, the whole queue is re-planned
+
+			for (uint8_t i = 0; i < moves; i++)
+				Stepper.MoveRel3(300, 100, 0, 5000);
+
+			for (uint8_t i = 0; i < Stepper.GetMovementCount() && timerStart != NULL; i++)
+				timerStart[i] = Stepper.GetMovement(i).mv.GetTimerJunctionToPrev();
+
+			CreateTestFile("PlanMaxCount.csv");
+
+			Stepper.DelayOptimization = true;
+			return Stepper.GetTotalTime();
+		}
+
+		TEST_METHOD(StepperPlanMaxCount)
+		{
+			// all moves in the queue (no step done): capped junction speed must be slower or equal to the uncapped planner
+
+			const uint8_t moves = MOVEMENTBUFFERSIZE - 1;
+			const uint8_t cap = 2;
+
+			timer_t timerUncapped[MOVEMENTBUFFERSIZE];
+			timer_t timerCapped[MOVEMENTBUFFERSIZE];
+			timer_t timerCapCount[MOVEMENTBUFFERSIZE];
+
+			QueuePlanMoves(255, moves, timerUncapped);
+			QueuePlanMoves(cap, moves, timerCapped);
+			QueuePlanMoves(moves, moves, timerCapCount);
+
+			bool slower = false;
+			for (uint8_t i = 1; i < moves; i++)
+			{
+				Assert::AreEqual(timerUncapped[i], timerCapCount[i]);	// cap >= queue => same result
+				Assert::IsTrue(timerCapped[i] >= timerUncapped[i]);
+				slower |= timerCapped[i] > timerUncapped[i];
+			}
+			Assert::IsTrue(slower);
+			Assert::AreEqual(timerUncapped[moves - 1], timerCapped[moves - 1]);		// tail is always planned
+
+			// more moves than the queue and the cap (steps while queueing)
+
+			long long timeUncapped = QueuePlanMoves(255, 3 * MOVEMENTPLANMAXCOUNT, NULL);
+			long long timeCapped = QueuePlanMoves(cap, 3 * MOVEMENTPLANMAXCOUNT, NULL);
+
+			Assert::AreEqual((udist_t)(3 * MOVEMENTPLANMAXCOUNT * 300), Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((udist_t)(3 * MOVEMENTPLANMAXCOUNT * 100), Stepper.GetCurrentPosition(Y_AXIS));
+			Assert::IsTrue(timeCapped >= timeUncapped);
+
+			char msg[128];
+			sprintf_s(msg, "time %u moves: uncapped=%lli, cap %u=%lli", (unsigned int) (3 * MOVEMENTPLANMAXCOUNT), timeUncapped, (unsigned int) cap, timeCapped);
+			Logger::WriteMessage(msg);
+		}
+
+		uint8_t QueueMergeMoves(mdist_t mergeTolerance)
+		{
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.SetMergeTolerance(mergeTolerance);
+
+			// (nearly) co-linear segments (rounded to steps) and a corner
+
+			for (udist_t i = 1; i <= 6; i++)
+				Stepper.MoveAbsEx(4000, X_AXIS, i * 1000, Y_AXIS, (i * 1000 + 1) / 3, -1);
+			Stepper.MoveAbsEx(4000, X_AXIS, 6000, Y_AXIS, 5000, -1);
+
+			uint8_t count = Stepper.GetMovementCount();
+
+			CreateTestFile("MergeMove.csv");
+
+			Stepper.SetMergeTolerance(0);
+			return count;
+		}
+
+		TEST_METHOD(StepperMergeMove)
+		{
+			Assert::AreEqual((uint8_t)7, QueueMergeMoves(0));
+			Assert::AreEqual((uint8_t)3, QueueMergeMoves(2));		// first move is started (not merged), 5 merged, corner
+
+			Assert::AreEqual((udist_t)6000, Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((udist_t)5000, Stepper.GetCurrentPosition(Y_AXIS));
+
+			// no merge into a wait or a move with stepmultiplier
+
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.SetMergeTolerance(2);
+
+			Stepper.CStepper::MoveRel(X_AXIS, 1000, 4000);		// started
+			Stepper.CStepper::MoveRel(X_AXIS, 1000, 4000);
+			Stepper.CStepper::MoveRel(X_AXIS, 1000, 4000);		// merged
+			Stepper.CStepper::Wait(1);
+			Stepper.CStepper::MoveRel(X_AXIS, 1000, 4000);
+			Stepper.CStepper::MoveRel(X_AXIS, 1000, 4000);		// merged
+			Assert::AreEqual((uint8_t)4, Stepper.GetMovementCount());
+
+			udist_t x = 5000;
+
+#if defined(use16bit)
+			// TIMER1FREQUENCE/20 does not fit in 16 bit => stepmultiplier 2 with the timer of 40 steps/sec
+
+			Stepper.CStepper::MoveRel(X_AXIS, 100, 20);
+			Stepper.CStepper::MoveRel(X_AXIS, 100, 40);			// same timerMax, merged => 2 times too fast
+			Assert::AreEqual((uint8_t)6, Stepper.GetMovementCount());
+			x += 200;
+#endif
+
+			CreateTestFile("MergeMoveWait.csv");
+			Stepper.SetMergeTolerance(0);
+
+			Assert::AreEqual(x, Stepper.GetCurrentPosition(X_AXIS));
+		}
+
+		TEST_METHOD(StepperArcMove)
+		{
+			// full circle and quarter (cw) as one movement each, all steps on the circle
+
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(5000, 100, 150);
+			Stepper.SetPosition(X_AXIS, 12000);
+			Stepper.SetPosition(Y_AXIS, 10000);
+
+			const udist_t circle[NUM_AXIS] = { 12000, 10000, 0 };
+			const udist_t quarter[NUM_AXIS] = { 10000, 8000, 0 };
+			const udist_t helix[NUM_AXIS] = { 10000, 12000, 100 };
+
+			Assert::IsTrue(Stepper.MoveArc(circle, 10000, 10000, X_AXIS, Y_AXIS, false, 4000));
+			Assert::IsTrue(Stepper.MoveArc(quarter, 10000, 10000, X_AXIS, Y_AXIS, true, 4000));
+			Assert::IsFalse(Stepper.MoveArc(helix, 10000, 10000, X_AXIS, Y_AXIS, true, 4000));
+
+			Assert::AreEqual((uint8_t)2, Stepper.GetMovementCount());
+
+			CreateTestFile("ArcMove.csv");
+
+			Assert::AreEqual((udist_t)10000, Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((udist_t)8000, Stepper.GetCurrentPosition(Y_AXIS));
+
+			FILE* f;
+			fopen_s(&f, GetResultFileName("ArcMove.csv"), "rt");
+			Assert::IsTrue(f != NULL);
+
+			char line[512];
+			int lines = 0;
+			double maxdiff = 0;
+
+			while (fgets(line, sizeof(line), f))
+			{
+				// total steps of x and y are field 15 and 16
+				const char* field = line;
+				for (int i = 0; i < 14; i++)
+					field = strchr(field, ';') + 1;
+
+				int x = 12000 + atoi(field) - 10000;
+				int y = 10000 + atoi(strchr(field, ';') + 1) - 10000;
+
+				maxdiff = max(maxdiff, fabs(hypot(x, y) - 2000.0));
+				lines++;
+			}
+			fclose(f);
+
+			Assert::IsTrue(lines > 8 * 1414);
+			Assert::IsTrue(maxdiff <= 1.0);
+		}
+
 		TEST_METHOD(StepperWaitHold)
 		{
 			Stepper.InitTest();
@@ -692,6 +908,298 @@ namespace StepperSystemTest
 			AssertFile("MergeRampWithIo.csv");
 		}
 
+		TEST_METHOD(StepperRampTableTest)
+		{
+			// compare ramptab (USE_RAMPTABLE) with the integer recurrence of CalcTimerAcc
+
+			const timer_t timer0s[] = { 1000, 10000, 40000, 65000 };
+			const unsigned long loops = 20;
+
+			for (timer_t timer0 : timer0s)
+			{
+				timer_t timer = timer0;
+				timer_t rest = 0;
+				mdist_t n;
+
+				for (n = 1; timer > 200; n++)
+				{
+					mudiv_t udivremainer = mudiv(timer * 2 + rest, n * 4 + 1);
+					rest = udivremainer.rem;
+					timer = timer - udivremainer.quot;
+
+					timer_t tabletimer = Stepper.GetRampTimer(timer0, n);
+					timer_t diff = tabletimer > timer ? tabletimer - timer : timer - tabletimer;
+					Assert::IsTrue(diff <= 1);
+				}
+
+				// speed of the ISR path: division (recurrence) vs. ramptab
+
+				mdist_t steps = n;
+				timer_t sum = 0;
+
+				auto start = std::chrono::high_resolution_clock::now();
+				for (unsigned long l = 0; l < loops; l++)
+				{
+					timer = timer0; rest = 0;
+					for (n = 1; n < steps; n++)
+					{
+						mudiv_t udivremainer = mudiv(timer * 2 + rest, n * 4 + 1);
+						rest = udivremainer.rem;
+						timer = timer - udivremainer.quot;
+					}
+					sum += timer;
+				}
+				auto recurrence = std::chrono::high_resolution_clock::now() - start;
+
+				start = std::chrono::high_resolution_clock::now();
+				for (unsigned long l = 0; l < loops; l++)
+				{
+					for (n = 1; n < steps; n++)
+					{
+						timer = Stepper.GetRampTimer(timer0, n);
+					}
+					sum += timer;
+				}
+				auto table = std::chrono::high_resolution_clock::now() - start;
+
+				char msg[128];
+				sprintf_s(msg, "timer0=%u steps=%u: recurrence %lli ns, ramptab %lli ns (%u)", (unsigned int) timer0, (unsigned int)steps,
+					(long long) std::chrono::duration_cast<std::chrono::nanoseconds>(recurrence).count(),
+					(long long) std::chrono::duration_cast<std::chrono::nanoseconds>(table).count(), (unsigned int) sum);
+				Logger::WriteMessage(msg);
+			}
+		}
+
+		long long PerAxisAccCycleTime(const char* filename, steprate_t accX, steprate_t accY, steprate_t accZ, EnumAsByte(CStepper::ERampType) ramptype = CStepper::RampTrapezoid)
+		{
+			Stepper.InitTest();
+			Stepper.SetRampType(ramptype);
+			Stepper.SetDefaultMaxSpeed(5000, 400, 400);
+			Stepper.SetAcc(X_AXIS, accX); Stepper.SetDec(X_AXIS, accX);
+			Stepper.SetAcc(Y_AXIS, accY); Stepper.SetDec(Y_AXIS, accY);
+			Stepper.SetAcc(Z_AXIS, accZ); Stepper.SetDec(Z_AXIS, accZ);
+
+			// X main axis, Y/Z less
+			Stepper.MoveRel3(4000, 1000, 0, 5000);
+			Stepper.MoveRel3(-4000, 2000, 0, 5000);
+			Stepper.MoveRel3(3000, 0, 1500, 5000);
+			Stepper.MoveRel3(-3000, -3000, -1500, 5000);
+			Stepper.MoveRel3(2000, 500, 200, 5000);
+			CreateTestFile(filename);
+
+			return Stepper.GetTotalTime();
+		}
+
+		TEST_METHOD(StepperPerAxisAcc)
+		{
+			// acc of a move is projected to the axis (timer * sqrt(d/steps)) => heavy Y must not limit the X moves
+
+			long long timeFast  = PerAxisAccCycleTime("PerAxisAccFast.csv", 400, 400, 400);
+			long long timeHeavy = PerAxisAccCycleTime("PerAxisAccHeavy.csv", 100, 100, 100);
+			long long timeMixed = PerAxisAccCycleTime("PerAxisAccMixed.csv", 400, 100, 800);
+
+			char msg[128];
+			sprintf_s(msg, "cycle time: all 400=%lli, all 100=%lli, X400 Y100 Z800=%lli", timeFast, timeHeavy, timeMixed);
+			Logger::WriteMessage(msg);
+
+			Assert::IsTrue(timeFast <= timeMixed);
+			Assert::IsTrue(timeMixed < timeHeavy);
+		}
+
+		double MaxEventAcc(int window)
+		{
+			// max acceleration (steps/timer^2) of the events in the cache, averaged over "window" events
+
+			double maxacc = 0;
+			for (int i = 0; i + window < Stepper.GetEventCount(); i++)
+			{
+				double time = 0;
+				for (int j = i + 1; j <= i + window; j++)
+					time += Stepper.GetEventTimer(j);
+
+				double v0 = double(Stepper.GetEventSteps(i)) / Stepper.GetEventTimer(i);
+				double v1 = double(Stepper.GetEventSteps(i + window)) / Stepper.GetEventTimer(i + window);
+				double acc = fabs(v1 - v0) / time;
+				if (acc > maxacc)
+					maxacc = acc;
+			}
+			return maxacc;
+		}
+
+		TEST_METHOD(StepperSCurve)
+		{
+			Assert::AreEqual((long) 0, (long) Stepper.GetSCurveSteps(0, 1000));
+			Assert::AreEqual((long) 500, (long) Stepper.GetSCurveSteps(500, 1000));
+			Assert::AreEqual((long) 1000, (long) Stepper.GetSCurveSteps(1000, 1000));
+			Assert::IsTrue(Stepper.GetSCurveSteps(100, 1000) < 100);
+			Assert::IsTrue(Stepper.GetSCurveSteps(900, 1000) > 900);
+
+			mdist_t last = 0;
+			for (mdist_t n = 1; n <= 1000; n++)
+			{
+				mdist_t idx = Stepper.GetSCurveSteps(n, 1000);
+				Assert::IsTrue(idx >= last);
+				Assert::IsTrue(idx - last <= 2);			// max 1.5 * a
+				last = idx;
+			}
+
+			long long timeTrapezoid = PerAxisAccCycleTime("SCurveTrapezoid.csv", 400, 400, 400);
+			double accTrapezoid = MaxEventAcc(8);
+
+			long long timeSCurve = PerAxisAccCycleTime("SCurve.csv", 400, 400, 400, CStepper::RampSCurve);
+			double accSCurve = MaxEventAcc(8);
+
+			Assert::AreEqual((long)(4000 - 4000 + 3000 - 3000 + 2000), (long) Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((long)(1000 + 2000 - 3000 + 500), (long) Stepper.GetCurrentPosition(Y_AXIS));
+			Assert::AreEqual((long)(1500 - 1500 + 200), (long) Stepper.GetCurrentPosition(Z_AXIS));
+
+			char msg[128];
+			sprintf_s(msg, "cycle time: trapezoid=%lli, s-curve=%lli, max acc: trapezoid=%g, s-curve=%g", timeTrapezoid, timeSCurve, accTrapezoid, accSCurve);
+			Logger::WriteMessage(msg);
+
+			// peak acceleration of the s-curve is the configured acc (as the trapezoid), the ramps are longer
+
+			Assert::IsTrue(accSCurve < accTrapezoid * 1.05);
+			Assert::IsTrue(accSCurve > accTrapezoid * 0.9);
+			Assert::IsTrue(timeSCurve > timeTrapezoid);
+		}
+
+		TEST_METHOD(StepperDynamicStepMultiplier)
+		{
+			Stepper.InitTest();
+			Stepper.SetDefaultMaxSpeed(30000, 400, 550);
+
+			// fast (multiplier > 1) and slow (multiplier 1) moves
+			Stepper.MoveRel3(40000, 20000, 1000, 30000);
+			Stepper.MoveRel3(-20000, 0, 0, 5000);
+			Stepper.MoveRel3(-20000, -20000, -1000, 20000);
+			CreateTestFile("DynamicStepMultiplier.csv");
+
+			Assert::AreEqual((udist_t)0, Stepper.GetCurrentPosition(X_AXIS));
+			Assert::AreEqual((udist_t)0, Stepper.GetCurrentPosition(Y_AXIS));
+			Assert::AreEqual((udist_t)0, Stepper.GetCurrentPosition(Z_AXIS));
+
+			int movements = 0;
+			int maxSteps = 0;
+			int minTimer = 0xffff;
+
+			for (int i = 0; i < Stepper.GetEventCount(); i++)
+			{
+				int steps = Stepper.GetEventSteps(i);
+				bool isFirst = i == 0 || Stepper.GetEventN(i) <= Stepper.GetEventN(i - 1);		// n restarts with each movement
+
+				if (isFirst)
+					movements++;
+
+				// interrupt rate (timer events with "steps" of the main axis) must not exceed the limit
+
+				Assert::IsTrue(Stepper.GetEventTimer(i) >= TIMER1VALUE(MAXINTERRUPTSPEED));
+
+#ifdef USE_DYNAMICSTEPMULTIPLIER
+				// multiplier from the current speed => a movement from stop starts single stepped
+
+				if (isFirst)
+					Assert::AreEqual(1, steps);
+#else
+				// multiplier from the max speed of the movement => same steps for each event, the last event has the rest
+
+				bool isLast = i + 1 == Stepper.GetEventCount() || Stepper.GetEventN(i + 1) <= Stepper.GetEventN(i);
+				if (!isFirst && !isLast)
+					Assert::AreEqual(Stepper.GetEventSteps(i - 1), steps);
+#endif
+				if (steps > maxSteps)
+					maxSteps = steps;
+				if (Stepper.GetEventTimer(i) < minTimer)
+					minTimer = Stepper.GetEventTimer(i);
+			}
+
+			char msg[128];
+			sprintf_s(msg, "cycle time=%lli, timer events=%i, max steps of an event=%i, min timer=%i", Stepper.GetTotalTime(), Stepper.GetEventCount(), maxSteps, minTimer);
+			Logger::WriteMessage(msg);
+
+			Assert::AreEqual(3, movements);
+			Assert::IsTrue(maxSteps > 1);
+		}
+
+		template<uint8_t numaxis>
+		unsigned long BresenhamLoop(mdist_t add[], const mdist_t distance[], mdist_t steps, unsigned long dirCount)
+		{
+			// all axes, axis by axis (as CalcNextSteps before SBresenham)
+
+			unsigned long stepcount = 0;
+			unsigned long mask = 15;
+
+			for (uint8_t i = 0;; i++)
+			{
+				mdist_t oldadd = add[i];
+				add[i] += distance[i];
+				if (add[i] >= steps || add[i] < oldadd)
+				{
+					add[i] -= steps;
+					stepcount += mask&dirCount;
+				}
+				if (i == numaxis - 1)
+					break;
+				mask *= 16;
+			}
+			return stepcount;
+		}
+
+		template<uint8_t numaxis>
+		void BresenhamBenchmark(const char* name, const mdist_t distance[6])
+		{
+			const mdist_t steps = 100000;
+			const unsigned long dirCount = 0x199919;
+			const unsigned long loops = 20;
+
+			mdist_t addLoop[6];
+			CMsvcStepper::SBresenham<unsigned long, numaxis> bresenham;
+
+			for (uint8_t i = 0; i < 6; i++)
+				addLoop[i] = steps / 2;
+			bresenham.Init(distance, steps, dirCount, steps / 2, true);
+
+			for (mdist_t n = 0; n < steps; n++)
+			{
+				unsigned long stepcount = BresenhamLoop<numaxis>(addLoop, distance, steps, dirCount);
+				Assert::AreEqual(stepcount, bresenham.Step(steps));
+			}
+
+			unsigned long sum = 0;
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (unsigned long l = 0; l < loops; l++)
+				for (mdist_t n = 0; n < steps; n++)
+					sum += BresenhamLoop<numaxis>(addLoop, distance, steps, dirCount);
+			auto loop = std::chrono::high_resolution_clock::now() - start;
+
+			start = std::chrono::high_resolution_clock::now();
+			for (unsigned long l = 0; l < loops; l++)
+				for (mdist_t n = 0; n < steps; n++)
+					sum += bresenham.Step(steps);
+			auto step = std::chrono::high_resolution_clock::now() - start;
+
+			char msg[128];
+			sprintf_s(msg, "%u axis %s: loop %lli ns, SBresenham %lli ns (%lu)", (unsigned int) numaxis, name,
+				(long long)std::chrono::duration_cast<std::chrono::nanoseconds>(loop).count(),
+				(long long)std::chrono::duration_cast<std::chrono::nanoseconds>(step).count(), sum);
+			Logger::WriteMessage(msg);
+		}
+
+		TEST_METHOD(StepperBresenhamTest)
+		{
+			const mdist_t distanceAll[6] = { 100000, 73313, 50000, 12345, 99999, 3 };
+			const mdist_t distanceXY[6] = { 100000, 73313, 0, 0, 0, 0 };
+
+			BresenhamBenchmark<3>("all", distanceAll);
+			BresenhamBenchmark<4>("all", distanceAll);
+			BresenhamBenchmark<5>("all", distanceAll);
+			BresenhamBenchmark<6>("all", distanceAll);
+
+			BresenhamBenchmark<3>("xy", distanceXY);
+			BresenhamBenchmark<6>("xy", distanceXY);
+		}
+
 		void TestFile()
 		{
 			Stepper.InitTest();
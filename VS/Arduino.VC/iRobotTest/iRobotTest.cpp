@@ -24,7 +24,59 @@
 #include "TestTools.h"
 
 #include "..\..\..\sketch\libraries\CNCLib\src\Matrix4x4.h"
+#include "..\..\..\sketch\libraries\CNCLib\src\FastTrig.h"
+#include "..\..\..\sketch\iRobot\iRobot\MyMotionControl.h"
 #include "DenavitHartenberg.h"
+#include <time.h>
+
+CSerial Serial;
+HardwareSerial& StepperSerial = Serial;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+// inverse kinematics of the iRobot sketch (uses CFastTrig)
+
+class CMyMotionControlTest : public CMyMotionControl
+{
+public:
+
+	using CMyMotionControl::ToAngle;
+	using CMyMotionControl::FromAngle;
+};
+
+static double ToAngleTime(float& sum)
+{
+	clock_t start = clock();
+
+	for (mm1000_t x = -300000; x <= 300000; x += 2000)
+	{
+		for (mm1000_t y = -300000; y <= 300000; y += 2000)
+		{
+			mm1000_t pos[NUM_AXIS] = { x, y, 100000 };
+			float angle[NUM_AXIS];
+			if (CMyMotionControlTest::ToAngle(pos, angle))
+				sum += angle[0] + angle[1] + angle[2];
+		}
+	}
+
+	return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+template <bool fast>
+static double TrigTime(float& sum)
+{
+	clock_t start = clock();
+
+	for (int i = 0; i < 1000; i++)
+	{
+		for (float x = -1.0f; x <= 1.0f; x += 0.01f)
+		{
+			sum += fast ? CFastTrig::Atan(x * 10.0f) + CFastTrig::Acos(x) : atanf(x * 10.0f) + acosf(x);
+		}
+	}
+
+	return double(clock() - start) / CLOCKS_PER_SEC;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -249,4 +301,73 @@ int _tmain(int /* argc */, _TCHAR* /* argv */ [])
 				printf("\n");
 		}
 	}
+
+	//////////////////////////////////////////
+	// fast trigonometric functions (CFastTrig) of the inverse kinematics
+
+	{
+		float maxdiffangle = 0;
+
+		for (float x = -1.0f; x <= 1.0f; x += 0.0001f)
+		{
+			maxdiffangle = max(maxdiffangle, fabs(atanf(x * 10.0f) - CFastTrig::Atan(x * 10.0f)));
+			maxdiffangle = max(maxdiffangle, fabs(acosf(x) - CFastTrig::Acos(x)));
+		}
+
+		// CMyMotionControl::ToAngle => position of the Denavit-Hartenberg transformation and of FromAngle must be the same
+
+		CDenavitHartenberg dh;
+
+		float maxdiffpos = 0;
+
+		for (mm1000_t x = -300000; x <= 300000; x += 5000)
+		{
+			for (mm1000_t y = -300000; y <= 300000; y += 5000)
+			{
+				for (mm1000_t z = 0; z <= 300000; z += 10000)
+				{
+					mm1000_t pos[NUM_AXIS] = { x, y, z };
+					float angle[NUM_AXIS];
+
+					// ToAngle is not defined above the base (x/y distance <= 30mm, segment 3)
+
+					if (float(x) * x + float(y) * y <= 30000.0f * 30000.0f || !CMyMotionControlTest::ToAngle(pos, angle))
+						continue;
+
+					float posxyz[3];
+					dh.ToPosition(angle, posxyz);
+
+					for (uint8_t n = 0; n < 3; n++)
+						maxdiffpos = max(maxdiffpos, fabs(posxyz[n] - pos[n] / 1000.0f));
+
+					mm1000_t dest[NUM_AXIS];
+					CMyMotionControlTest::FromAngle(angle, dest);
+
+					for (uint8_t n = 0; n < 3; n++)
+					{
+						if (abs(dest[n] - pos[n]) > 20)
+						{
+							printf("Error FastTrig #31: %.2f:%.2f:%.2f => %.3f:%.3f:%.3f\n", x / 1000.0f, y / 1000.0f, z / 1000.0f, dest[0] / 1000.0f, dest[1] / 1000.0f, dest[2] / 1000.0f);
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		// servo resolution is 1/2us => 0.001 rad
+
+		if (maxdiffangle > 0.0001f)
+			printf("Error FastTrig #32: angle diff %f\n", maxdiffangle);
+
+		if (maxdiffpos > 0.02f)
+			printf("Error FastTrig #33: position diff %f\n", maxdiffpos);
+
+		float sum = 0;
+		double timemath = TrigTime<false>(sum);
+		double timefast = TrigTime<true>(sum);
+		double timetoangle = ToAngleTime(sum);
+
+		printf("FastTrig: max angle diff %f rad, max position diff %f mm, math.h %.3fs, CFastTrig %.3fs, CMyMotionControl::ToAngle %.3fs (%.0f)\n", maxdiffangle, maxdiffpos, timemath, timefast, timetoangle, sum);
+	}
 }